@@ -53,4 +53,4 @@ LIBDEFS    = $(AR_OPTS) qc
 DLLDEFS    = $(ARCHITECTURE) -brtl -L$(LIB_DIR) -G
 
 OS_LIBS    =
-OS_LIBSPP  =
+OS_LIBSPP  = -lpthread
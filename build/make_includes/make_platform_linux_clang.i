@@ -47,12 +47,12 @@ ifndef WARN
   WARN    = -Wall -Werror
 endif
 
-CDEFS     = $(ARCHITECTURE) -fPIC $(WARN)
-CPPDEFS   = $(ARCHITECTURE) -fPIC $(WARN)
-EXEDEFS   = $(ARCHITECTURE) -L$(LIB_DIR)
-EXEPPDEFS = $(ARCHITECTURE) -L$(LIB_DIR)
+CDEFS     = -pthread $(ARCHITECTURE) -fPIC $(WARN)
+CPPDEFS   = -pthread $(ARCHITECTURE) -fPIC $(WARN)
+EXEDEFS   = -pthread $(ARCHITECTURE) -L$(LIB_DIR)
+EXEPPDEFS = -pthread $(ARCHITECTURE) -L$(LIB_DIR)
 LIBDEFS   = qc
-DLLDEFS   = $(ARCHITECTURE) -L$(LIB_DIR) -shared
+DLLDEFS   = -pthread $(ARCHITECTURE) -L$(LIB_DIR) -shared
 
 OS_LIBS   =
 OS_LIBSPP = -lstdc++
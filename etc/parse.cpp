@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "libogc.h"
 using namespace OGC;
@@ -31,6 +32,9 @@ using namespace OGC;
 static const char *  pgm;
 static const char *  inp_file = "-";
 static bool          verbose  = false;
+static int           mode     = OGC_TOKEN_MODE_COPY;
+static int           bench    = 0;
+static int           numbers  = 0;
 static FILE *        fp       = NULL;
 
 /*------------------------------------------------------------------------
@@ -46,13 +50,17 @@ static void usage(int level)
       printf("  -?, -help     Display usage\n");
       printf("  -V, -version  Display version\n");
       printf("  -v            Verbose\n");
+      printf("  -z            Tokenize without copying the string\n");
+      printf("  -b count      Benchmark tokenizing (count passes)\n");
+      printf("  -d count      Test number conversion (count numbers)\n");
 
       printf("Arguments:\n");
       printf("  filename      File of WKT strings to read (default is stdin)\n");
    }
    else
    {
-      fprintf(stderr, "Usage: %s [-v] [filename]\n", pgm);
+      fprintf(stderr, "Usage: %s [-v] [-z] [-b count] [-d count] [filename]\n",
+         pgm);
    }
 }
 
@@ -98,6 +106,29 @@ static int process_options (int argc, const char **argv)
       }
 
       else if ( strcmp(arg, "v") == 0 )  verbose = true;
+      else if ( strcmp(arg, "z") == 0 )  mode    = OGC_TOKEN_MODE_SPAN;
+
+      else if ( strcmp(arg, "b") == 0 )
+      {
+         if ( ++optcnt >= argc )
+         {
+            fprintf(stderr, "%s: missing argument for -%s\n", pgm, arg);
+            usage(0);
+            exit(EXIT_FAILURE);
+         }
+         bench = atoi(argv[optcnt]);
+      }
+
+      else if ( strcmp(arg, "d") == 0 )
+      {
+         if ( ++optcnt >= argc )
+         {
+            fprintf(stderr, "%s: missing argument for -%s\n", pgm, arg);
+            usage(0);
+            exit(EXIT_FAILURE);
+         }
+         numbers = atoi(argv[optcnt]);
+      }
 
       else
       {
@@ -129,6 +160,341 @@ static int process_options (int argc, const char **argv)
    return optcnt;
 }
 
+/*------------------------------------------------------------------------
+ * time tokenizing all strings
+ */
+static void time_tokenize(
+   const char * what,
+   char **      strs,
+   int          num,
+   size_t       bytes)
+{
+   ogc_token t(mode);
+   clock_t   beg = clock();
+   double    secs;
+   int       bad = 0;
+
+   for (int n = 0; n < bench; n++)
+   {
+      for (int i = 0; i < num; i++)
+      {
+         if ( ! t.tokenize(strs[i], OGC_NULL) )
+            bad++;
+      }
+   }
+
+   secs = (double)(clock() - beg) / CLOCKS_PER_SEC;
+   if ( secs <= 0.0 )
+      secs = 1.0 / CLOCKS_PER_SEC;
+
+   printf("%-20s %10.1f MB/sec  (%d invalid)\n", what,
+      ((double)bytes * bench) / secs / (1024.0 * 1024.0), bad / bench);
+}
+
+/*------------------------------------------------------------------------
+ * benchmark tokenizing
+ */
+static void benchmark()
+{
+   char ** strs  = NULL;
+   int     num   = 0;
+   int     max   = 0;
+   size_t  bytes = 0;
+   char    name[32];
+
+   for (;;)
+   {
+      OGC_BUFF buffer;
+
+      if ( fgets(buffer, sizeof(buffer), fp) == NULL )
+         break;
+
+      if ( num == max )
+      {
+         max  = (max == 0) ? 256 : (max * 2);
+         strs = (char **)realloc(strs, max * sizeof(*strs));
+         if ( strs == NULL )
+         {
+            fprintf(stderr, "%s: out of memory\n", pgm);
+            exit(EXIT_FAILURE);
+         }
+      }
+
+      strs[num] = (char *)malloc(strlen(buffer) + 1);
+      if ( strs[num] == NULL )
+      {
+         fprintf(stderr, "%s: out of memory\n", pgm);
+         exit(EXIT_FAILURE);
+      }
+      strcpy(strs[num], buffer);
+      bytes += strlen(buffer);
+      num++;
+   }
+
+   printf("%d strings, %lu bytes, %d passes, %s mode\n", num,
+      (unsigned long)bytes, bench,
+      (mode == OGC_TOKEN_MODE_SPAN) ? "span" : "copy");
+
+   if ( num > 0 )
+   {
+      ogc_token::set_simd(false);
+      time_tokenize("scalar", strs, num, bytes);
+
+      if ( mode == OGC_TOKEN_MODE_SPAN )
+      {
+         ogc_token::set_simd(true);
+         sprintf(name, "simd (%s)", ogc_token::simd_name());
+         time_tokenize(name, strs, num, bytes);
+      }
+   }
+
+   for (int i = 0; i < num; i++)
+      free(strs[i]);
+   free(strs);
+}
+
+/*------------------------------------------------------------------------
+ * random numbers (xorshift64*)
+ */
+static unsigned long long rand_state = 88172645463325252ULL;
+
+static unsigned long long rand64()
+{
+   rand_state ^= rand_state >> 12;
+   rand_state ^= rand_state << 25;
+   rand_state ^= rand_state >> 27;
+   return rand_state * 2685821657736338717ULL;
+}
+
+/*------------------------------------------------------------------------
+ * make a random number string
+ *
+ * These are a mix of random doubles (shortest and with fewer digits),
+ * numbers like those in WKT strings, and random digit strings that are
+ * longer than 19 digits or have large exponents.
+ */
+static void make_number(char * buf, unsigned long long r)
+{
+   double d;
+   int    k;
+
+   switch ( r % 5 )
+   {
+      case 0:
+      case 1:
+         /* random bits */
+         do
+         {
+            unsigned long long bits = rand64();
+            memcpy(&d, &bits, sizeof(d));
+         } while ( d != d || d - d != 0.0 );
+         if ( r % 5 == 0 )
+            sprintf(buf, "%.17g", d);
+         else
+            sprintf(buf, "%.*g", (int)((r >> 8) % 17) + 1, d);
+         break;
+
+      case 2:
+         /* like a WKT value */
+         d = (double)(rand64() >> 11) / 9007199254740992.0;
+         d = (d - 0.5) * 360.0;
+         sprintf(buf, "%.*f", (int)((r >> 8) % 17), d);
+         break;
+
+      default:
+         /* random digits */
+         {
+            char * b = buf;
+            int    n = (int)((r >> 8) % 30) + 1;
+            int    p = (int)((r >> 16) % (n + 1));
+
+            if ( (r >> 24) & 1 )
+               *b++ = '-';
+            for (k = 0; k < n; k++)
+            {
+               if ( k == p )
+                  *b++ = '.';
+               *b++ = (char)('0' + (rand64() % 10));
+            }
+            if ( (r >> 25) & 1 )
+               sprintf(b, "e%d", (int)((r >> 32) % 700) - 350);
+            else
+               *b = 0;
+         }
+         break;
+   }
+}
+
+/*------------------------------------------------------------------------
+ * count the significant digits in a number string
+ */
+static int sig_digits(const char * s)
+{
+   int n = 0;
+   int z = 0;
+
+   for (; *s && *s != 'e'; s++)
+   {
+      if ( *s >= '1' && *s <= '9' )
+      {
+         n += z + 1;
+         z  = 0;
+      }
+      else if ( *s == '0' && n > 0 )
+      {
+         z++;
+      }
+   }
+   return n;
+}
+
+/*------------------------------------------------------------------------
+ * check that dtoa() gives the shortest string that converts back
+ */
+static bool check_dtoa(double d)
+{
+   OGC_NBUF buf;
+   char     tmp[64];
+   double   a;
+   double   b;
+   int      n;
+
+   if ( d != d || d - d != 0.0 || d == 0.0 )
+      return true;
+
+   ogc_string::dtoa(d, buf);
+   a = ogc_string::atod(buf);
+   b = strtod(buf, NULL);
+   if ( memcmp(&a, &d, sizeof(d)) != 0 || memcmp(&b, &d, sizeof(d)) != 0 )
+      return false;
+
+   /* one digit less must not convert back */
+   n = sig_digits(buf);
+   if ( n > 1 )
+   {
+      sprintf(tmp, "%.*e", n - 2, d);
+      if ( strtod(tmp, NULL) == d )
+         return false;
+   }
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * test number conversion against strtod()
+ *
+ * The numbers are made in batches, and each batch is checked and then
+ * timed with both.  The doubles are then converted back to strings, and
+ * checked and timed against sprintf().
+ */
+static int test_numbers()
+{
+   const int  batch  = 100000;
+   char     (*strs)[64];
+   double *   vals;
+   size_t     bytes  = 0;
+   clock_t    t_atod = 0;
+   clock_t    t_libc = 0;
+   clock_t    t_dtoa = 0;
+   clock_t    t_prnt = 0;
+   double     sum    = 0.0;
+   int        bad    = 0;
+   int        bad_d  = 0;
+
+   strs = (char (*)[64])malloc(batch * sizeof(*strs));
+   vals = (double *)malloc(batch * sizeof(*vals));
+   if ( strs == NULL || vals == NULL )
+   {
+      fprintf(stderr, "%s: out of memory\n", pgm);
+      exit(EXIT_FAILURE);
+   }
+
+   for (int done = 0; done < numbers; done += batch)
+   {
+      int     num = (numbers - done < batch) ? (numbers - done) : batch;
+      clock_t beg;
+
+      for (int i = 0; i < num; i++)
+      {
+         make_number(strs[i], rand64());
+         bytes += strlen(strs[i]);
+      }
+
+      for (int i = 0; i < num; i++)
+      {
+         double a = ogc_string::atod(strs[i]);
+         double b = strtod(strs[i], NULL);
+
+         if ( memcmp(&a, &b, sizeof(a)) != 0 )
+         {
+            if ( bad++ < 20 || verbose )
+               printf("%s: %.17g should be %.17g\n", strs[i], a, b);
+         }
+
+         vals[i] = b;
+         if ( !check_dtoa(b) )
+         {
+            OGC_NBUF buf;
+
+            if ( bad_d++ < 20 || verbose )
+               printf("%.17g: %s is wrong\n", b, ogc_string::dtoa(b, buf));
+         }
+      }
+
+      beg = clock();
+      for (int i = 0; i < num; i++)
+         sum += ogc_string::atod(strs[i]);
+      t_atod += clock() - beg;
+
+      beg = clock();
+      for (int i = 0; i < num; i++)
+         sum += strtod(strs[i], NULL);
+      t_libc += clock() - beg;
+
+      beg = clock();
+      for (int i = 0; i < num; i++)
+         sum += ogc_string::dtoa(vals[i], strs[i])[0];
+      t_dtoa += clock() - beg;
+
+      beg = clock();
+      for (int i = 0; i < num; i++)
+      {
+         sprintf(strs[i], "%.17g", vals[i]);
+         sum += strs[i][0];
+      }
+      t_prnt += clock() - beg;
+   }
+
+   free(strs);
+   free(vals);
+
+   printf("%d numbers, %lu bytes, %d wrong, %d wrong back\n", numbers,
+      (unsigned long)bytes, bad, bad_d);
+   if ( t_atod > 0 && t_libc > 0 )
+   {
+      double s_atod = (double)t_atod / CLOCKS_PER_SEC;
+      double s_libc = (double)t_libc / CLOCKS_PER_SEC;
+
+      printf("%-20s %10.1f MB/sec %10.1f M/sec\n", "atod",
+         (double)bytes / s_atod / (1024.0 * 1024.0), numbers / s_atod / 1e6);
+      printf("%-20s %10.1f MB/sec %10.1f M/sec\n", "strtod",
+         (double)bytes / s_libc / (1024.0 * 1024.0), numbers / s_libc / 1e6);
+   }
+   if ( t_dtoa > 0 && t_prnt > 0 )
+   {
+      double s_dtoa = (double)t_dtoa / CLOCKS_PER_SEC;
+      double s_prnt = (double)t_prnt / CLOCKS_PER_SEC;
+
+      printf("%-20s %10s %10.1f M/sec\n", "dtoa", "",
+         numbers / s_dtoa / 1e6);
+      printf("%-20s %10s %10.1f M/sec\n", "sprintf(%.17g)", "",
+         numbers / s_prnt / 1e6);
+   }
+   if ( sum == 1.0 )
+      printf("\n");   /* so the loops are not optimized away */
+
+   return (bad == 0 && bad_d == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 /*------------------------------------------------------------------------
  * main()
  */
@@ -136,10 +502,23 @@ int main(int argc, const char **argv)
 {
    process_options(argc, argv);
 
+   if ( numbers > 0 )
+   {
+      fclose(fp);
+      return test_numbers();
+   }
+
+   if ( bench > 0 )
+   {
+      benchmark();
+      fclose(fp);
+      return EXIT_SUCCESS;
+   }
+
    for (;;)
    {
       OGC_BUFF buffer;
-      ogc_token t;
+      ogc_token t(mode);
       ogc_error e;
 
       if ( fgets(buffer, sizeof(buffer), fp) == NULL )
@@ -155,11 +534,13 @@ int main(int argc, const char **argv)
          {
             printf("%2d: %2d: ", i, t._arr[i].lvl);
             if ( verbose )
-               printf("%2d: ", t._arr[i].idx);
+               printf("%2d: %4d: %3d: %3d: %2d: %2d: ", t._arr[i].idx,
+                  t._arr[i].pos, t._arr[i].len, t._arr[i].end,
+                  t._arr[i].same, t._arr[i].type);
 
             for (int j = 0; j < t._arr[i].lvl; j++)
                printf("  ");
-            printf("%s\n", t._arr[i].str);
+            printf("%s\n", t.str(i));
          }
          printf("\n");
       }
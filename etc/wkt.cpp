@@ -21,6 +21,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/time.h>
+#  include <unistd.h>
+#endif
 
 #include "libogc.h"
 using namespace OGC;
@@ -33,8 +41,12 @@ static const char *  inp_file   = "-";
 static int           wkt_opts   = OGC_WKT_OPT_NONE;
 static bool          multi_line = false;
 static bool          name_only  = false;
+static bool          lazy       = false;
+static bool          validate   = false;
 static bool          strict     = false;
-static FILE *        fp         = NULL;
+static int           bench      = 0;
+static int           chunk      = 0;
+static int           threads    = -1;
 
 /*------------------------------------------------------------------------
  * display usage
@@ -50,6 +62,8 @@ static void usage(int level)
       printf("  -V, -version  Display version\n");
       printf("  -m            Process multi-line input\n");
       printf("  -n            Show name only\n");
+      printf("  -l            Parse lazily (build only what is shown)\n");
+      printf("  -v            Validate only (show only errors)\n");
       printf("  -o            Display in old syntax\n");
 
       printf("  -i            Don't show any ID attributes\n");
@@ -70,13 +84,18 @@ static void usage(int level)
          printf("  -s            Set   strict parsing\n");
       }
 
+      printf("  -b count      Benchmark parsing (count passes)\n");
+      printf("  -c size       Read input in chunks of size bytes\n");
+      printf("  -j threads    Parse in threads (0 = one per cpu)\n");
+
       printf("Arguments:\n");
       printf("  filename      File of WKT strings to read (default is stdin)\n");
    }
    else
    {
       fprintf(stderr,
-         "Usage: %s [-m] [-n] [-o] [-i|-t] [-p] [-x|-X] [-r|-s] [filename]\n",
+         "Usage: %s [-m] [-n] [-l] [-v] [-o] [-i|-t] [-p] [-x|-X] [-r|-s] "
+         "[-b count] [-c size] [-j threads] [filename]\n",
          pgm);
    }
 }
@@ -126,6 +145,8 @@ static int process_options (int argc, const char **argv)
 
       else if ( strcmp(arg, "m")   == 0 ) multi_line  = true;
       else if ( strcmp(arg, "n")   == 0 ) name_only   = true;
+      else if ( strcmp(arg, "l")   == 0 ) lazy        = true;
+      else if ( strcmp(arg, "v")   == 0 ) validate    = true;
       else if ( strcmp(arg, "o")   == 0 ) wkt_opts   |= OGC_WKT_OPT_OLD_SYNTAX;
       else if ( strcmp(arg, "i")   == 0 ) wkt_opts   |= OGC_WKT_OPT_NO_IDS;
       else if ( strcmp(arg, "t")   == 0 ) wkt_opts   |= OGC_WKT_OPT_TOP_ID_ONLY;
@@ -136,6 +157,41 @@ static int process_options (int argc, const char **argv)
       else if ( strcmp(arg, "r")   == 0 ) ogc_object::set_strict_parsing(false);
       else if ( strcmp(arg, "s")   == 0 ) ogc_object::set_strict_parsing(true);
 
+      else if ( strcmp(arg, "b")   == 0 )
+      {
+         if ( ++optcnt >= argc )
+         {
+            fprintf(stderr, "%s: missing argument for -%s\n", pgm, arg);
+            usage(0);
+            exit(EXIT_FAILURE);
+         }
+         bench = atoi(argv[optcnt]);
+      }
+
+      else if ( strcmp(arg, "c")   == 0 )
+      {
+         if ( ++optcnt >= argc )
+         {
+            fprintf(stderr, "%s: missing argument for -%s\n", pgm, arg);
+            usage(0);
+            exit(EXIT_FAILURE);
+         }
+         chunk = atoi(argv[optcnt]);
+      }
+
+      else if ( strcmp(arg, "j")   == 0 )
+      {
+         if ( ++optcnt >= argc )
+         {
+            fprintf(stderr, "%s: missing argument for -%s\n", pgm, arg);
+            usage(0);
+            exit(EXIT_FAILURE);
+         }
+         threads = atoi(argv[optcnt]);
+         if ( threads < 0 )
+            threads = 0;
+      }
+
       else
       {
          fprintf(stderr, "%s: Invalid option -- %s\n", pgm, argv[optcnt]);
@@ -149,20 +205,6 @@ static int process_options (int argc, const char **argv)
       inp_file = argv[optcnt++];
    }
 
-   if ( strcmp(inp_file, "-") == 0 )
-   {
-      fp = stdin;
-   }
-   else
-   {
-      fp = fopen(inp_file, "r");
-      if ( fp == OGC_NULL )
-      {
-         fprintf(stderr, "%s: cannot open file %s\n", pgm, inp_file);
-         exit(EXIT_FAILURE);
-      }
-   }
-
    return optcnt;
 }
 
@@ -181,7 +223,7 @@ static void _CDECL error_rtn(
 }
 
 /*------------------------------------------------------------------------
- * read in a WKT buffer to process
+ * open the input file
  *
  * The multi-line option is designed to read in WKT strings continued
  * in multiple lines and also WKT strings that have a trailing comma
@@ -190,93 +232,640 @@ static void _CDECL error_rtn(
  * This is so we can cut-and-paste example WKT strings from Roger's
  * WKT-CRS doc.
  */
-static int get_inp_buffer(
-   OGC_BUFF inp_buffer)
+static void open_reader(
+   ogc_wkt_reader & rdr)
 {
-   if ( multi_line )
+   ogc_error err;
+
+   if ( !rdr.open(inp_file, &err) )
    {
-      char * b     = inp_buffer;
-      int    count = 0;
-      int    c;
+      fprintf(stderr, "%s: %s\n", pgm, err.err_msg());
+      exit(EXIT_FAILURE);
+   }
+}
+
+/*------------------------------------------------------------------------
+ * get a null-terminated copy of a WKT string read
+ *
+ * This is only needed for the routines that don't take a length.
+ */
+static const char * get_str(
+   const char * str,
+   size_t       len)
+{
+   static char * buf    = NULL;
+   static size_t buflen = 0;
 
-      for (;;)
+   if ( len >= buflen )
+   {
+      buflen = len + 1;
+      buf    = (char *)realloc(buf, buflen);
+      if ( buf == NULL )
       {
-         c = fgetc(fp);
-         if ( c == EOF )
-            return EOF;
+         fprintf(stderr, "%s: out of memory\n", pgm);
+         exit(EXIT_FAILURE);
+      }
+   }
 
-         *b++ = static_cast<char>(c);
+   memcpy(buf, str, len);
+   buf[len] = 0;
 
-         if ( c == '[' )
-         {
-            count++;
-         }
-         else
-         if ( c == ']' )
+   return buf;
+}
+
+/*------------------------------------------------------------------------
+ * get null-terminated copies of all WKT strings read
+ *
+ * The copies are all in one buffer, which is returned (and the
+ * strings in *pstrs), so both have to be freed.
+ */
+static char * get_all_strs(
+   ogc_wkt_reader & rdr,
+   const char ***   pstrs,
+   int *            pnum)
+{
+   const char ** strs = NULL;
+   char *        buf;
+   char *        p;
+   const char *  str;
+   size_t        len;
+   int           num  = 0;
+   int           max  = 0;
+
+   /* the copies take no more room than the file */
+   buf = (char *)malloc(rdr.size() + 1);
+   if ( buf == NULL )
+   {
+      fprintf(stderr, "%s: out of memory\n", pgm);
+      exit(EXIT_FAILURE);
+   }
+
+   for (p = buf; rdr.next(&str, &len); p += len + 1)
+   {
+      if ( num == max )
+      {
+         max  = (max == 0) ? 256 : (max * 2);
+         strs = (const char **)realloc(strs, max * sizeof(*strs));
+         if ( strs == NULL )
          {
-            count--;
-            if ( count == 0 )
-            {
-               /* skip over rest of line */
-               for (;;)
-               {
-                  c = fgetc(fp);
-                  if ( c == EOF || c == '\n' )
-                     break;
-               }
-               break;
-            }
+            fprintf(stderr, "%s: out of memory\n", pgm);
+            exit(EXIT_FAILURE);
          }
       }
-      *b = 0;
+
+      memcpy(p, str, len);
+      p[len] = 0;
+      strs[num++] = p;
    }
-   else
+
+   *pstrs = strs;
+   *pnum  = num;
+   return buf;
+}
+
+/*------------------------------------------------------------------------
+ * get the elapsed (wall-clock) time in seconds
+ *
+ * clock() can't be used to time threads, as it adds up their times.
+ */
+static double wall_secs()
+{
+#ifdef _WIN32
+   return (double)GetTickCount() / 1000.0;
+#else
+   struct timeval tv;
+
+   gettimeofday(&tv, NULL);
+   return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+#endif
+}
+
+/*------------------------------------------------------------------------
+ * get the number of processors
+ */
+static int cpu_count()
+{
+   int n;
+
+#ifdef _WIN32
+   SYSTEM_INFO si;
+
+   GetSystemInfo(&si);
+   n = (int)si.dwNumberOfProcessors;
+#else
+   n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+   return (n > 0) ? n : 1;
+}
+
+/*------------------------------------------------------------------------
+ * display an object
+ */
+static void show_object(
+   const ogc_object * obj)
+{
+   if ( obj != OGC_NULL )
    {
-      if ( fgets(inp_buffer, OGC_BUFF_MAX, fp) == NULL )
-         return EOF;
+      if ( name_only )
+      {
+         printf("%s\n", obj->name());
+      }
+      else
+      {
+         ogc_wkt_writer w(stdout);
+
+         obj->to_wkt(w, wkt_opts);
+         w.end();
+      }
    }
+}
+
+/*------------------------------------------------------------------------
+ * process all objects taken from a token stream
+ */
+static void process_stream(
+   ogc_token_stream & s)
+{
+   while ( s.next() )
+   {
+      const ogc_token * t = s.token();
+
+      if ( t != OGC_NULL )
+      {
+         ogc_object * obj = ogc_object::from_tokens(t, 0, OGC_NULL);
 
-   return 0;
+         show_object(obj);
+         delete obj;
+      }
+   }
 }
 
 /*------------------------------------------------------------------------
- * main()
+ * read the input in chunks
+ *
+ * The chunks are fed to a token stream, and each object is processed
+ * as soon as it is complete, no matter where the chunks split it.
  */
-int main(int argc, const char **argv)
+static void read_chunks()
 {
-   process_options(argc, argv);
-   ogc_error::set_err_rtn( error_rtn );
+   ogc_token_stream s;
+   FILE * fp  = stdin;
+   char * buf = (char *)malloc(chunk);
+
+   if ( buf == NULL )
+   {
+      fprintf(stderr, "%s: out of memory\n", pgm);
+      exit(EXIT_FAILURE);
+   }
+
+   if ( strcmp(inp_file, "-") != 0 )
+   {
+      fp = fopen(inp_file, "rb");
+      if ( fp == NULL )
+      {
+         fprintf(stderr, "%s: cannot open file %s\n", pgm, inp_file);
+         exit(EXIT_FAILURE);
+      }
+   }
 
    for (;;)
    {
-      ogc_object * obj;
-      OGC_BUFF     inp_buffer;
-      OGC_BUFF     out_buffer;
+      size_t n = fread(buf, 1, chunk, fp);
 
-      if ( get_inp_buffer(inp_buffer) == EOF )
+      if ( n == 0 )
          break;
 
-      /* ignore blank lines */
-      ogc_string::trim_buf(inp_buffer);
-      if ( *inp_buffer == 0 )
-         continue;
+      if ( !s.feed(buf, n) )
+         break;
+      process_stream(s);
+   }
+
+   s.finish();
+   process_stream(s);
+
+   if ( fp != stdin )
+      fclose(fp);
+   free(buf);
+}
+
+/*------------------------------------------------------------------------
+ * show the memory held by the objects, with all of them kept at once
+ *
+ * This is counted by the global allocator, so it is just what the
+ * objects hold (not counting the small header on each allocation).
+ * With names interned, the names the objects share are in the intern
+ * table, which is shown separately.  With sub-objects shared, the
+ * shared ones are counted once.
+ */
+static void footprint(
+   ogc_token &    t,
+   const char **  strs,
+   const size_t * lens,
+   int            num,
+   bool           intern,
+   bool           share)
+{
+   ogc_allocator * a    = ogc_allocator::global();
+   ogc_object **   objs = (ogc_object **)calloc(num + 1, sizeof(*objs));
+   int             made = 0;
+   size_t          bytes;
+   size_t          allocs;
+   clock_t         beg;
+   double          secs;
+   size_t          shared = 0;
+   size_t          uses   = 0;
+   size_t          table  = 0;
+   bool            was;
+   bool            was_intern;
+   bool            was_share;
+
+   if ( objs == NULL )
+   {
+      fprintf(stderr, "%s: out of memory\n", pgm);
+      exit(EXIT_FAILURE);
+   }
 
-      obj = ogc_object::from_wkt(inp_buffer);
-      if ( obj != OGC_NULL )
+   was_intern = ogc_intern::set_enabled(intern);
+   was_share  = ogc_share::set_enabled(share);
+   was   = a->set_counting(true);
+   a->reset_counts();
+   bytes = a->bytes();
+   beg   = clock();
+
+   for (int i = 0; i < num; i++)
+   {
+      if ( t.tokenize(strs[i], lens[i], OGC_OBJ_KWD_OBJECT) )
       {
-         if ( name_only )
+         objs[i] = ogc_object::from_tokens(&t, 0, OGC_NULL);
+         if ( objs[i] != OGC_NULL )
+            made++;
+      }
+   }
+
+   secs   = (double)(clock() - beg) / CLOCKS_PER_SEC;
+   bytes  = a->bytes() - bytes;
+   allocs = a->num_allocs() - a->num_frees();
+   shared = ogc_share::count();
+   uses   = ogc_share::refs();
+   table  = ogc_share::bytes();
+
+   for (int i = 0; i < num; i++)
+      delete objs[i];
+   a->set_counting(was);
+   ogc_intern::set_enabled(was_intern);
+   ogc_share::set_enabled(was_share);
+   free(objs);
+
+   if ( secs <= 0.0 )
+      secs = 1.0 / CLOCKS_PER_SEC;
+
+   if ( made > 0 )
+   {
+      printf("%10.0f bytes/object  %10.1f allocs/object  "
+             "%10.0f objects/sec  (%d objects%s)\n",
+         (double)bytes / made, (double)allocs / made, made / secs, made,
+         intern ? ", names interned" : share ? ", sub-objects shared" : "");
+
+      if ( intern )
+      {
+         printf("%10lu bytes in the intern table  (%lu strings)\n",
+            (unsigned long)ogc_intern::bytes(),
+            (unsigned long)ogc_intern::count());
+      }
+
+      if ( share )
+      {
+         printf("%10lu bytes in the share table   (%lu objects, %lu uses)\n",
+            (unsigned long)table, (unsigned long)shared,
+            (unsigned long)uses);
+      }
+   }
+}
+
+/*------------------------------------------------------------------------
+ * benchmark parsing
+ *
+ * The strings are views into the file read, so they are not copied,
+ * and are tokenized with a token object that is re-used.
+ */
+static void benchmark()
+{
+   ogc_wkt_reader rdr(multi_line ? OGC_READER_MODE_MULTI :
+                                   OGC_READER_MODE_LINES);
+   ogc_token      t(OGC_TOKEN_MODE_SPAN);
+   const char **  strs  = NULL;
+   size_t *       lens  = NULL;
+   const char *   str;
+   size_t         len;
+   int            num   = 0;
+   int            max   = 0;
+   size_t         bytes = 0;
+   clock_t        beg;
+   double         secs;
+   int            bad   = 0;
+
+   beg = clock();
+   open_reader(rdr);
+
+   while ( rdr.next(&str, &len) )
+   {
+      if ( num == max )
+      {
+         max  = (max == 0) ? 256 : (max * 2);
+         strs = (const char **)realloc(strs, max * sizeof(*strs));
+         lens = (size_t *)     realloc(lens, max * sizeof(*lens));
+         if ( strs == NULL || lens == NULL )
          {
-            printf("%s\n", obj->name());
+            fprintf(stderr, "%s: out of memory\n", pgm);
+            exit(EXIT_FAILURE);
          }
-         else
+      }
+
+      strs[num] = str;
+      lens[num] = len;
+      bytes += len;
+      num++;
+   }
+
+   secs = (double)(clock() - beg) / CLOCKS_PER_SEC;
+   if ( secs <= 0.0 )
+      secs = 1.0 / CLOCKS_PER_SEC;
+
+   printf("%d strings, %lu bytes, %d passes\n", num,
+      (unsigned long)bytes, bench);
+   printf("%10.1f MB/sec read\n",
+      (double)rdr.size() / secs / (1024.0 * 1024.0));
+
+   beg = clock();
+   for (int n = 0; n < bench; n++)
+   {
+      for (int i = 0; i < num; i++)
+      {
+         if ( validate )
          {
-            obj->to_wkt(out_buffer, wkt_opts);
-            printf("%s\n", out_buffer);
+            if ( !ogc_object::validate_wkt(get_str(strs[i], lens[i])) )
+               bad++;
+            continue;
          }
+
+         if ( lazy )
+         {
+            ogc_lazy_object * lz =
+               ogc_lazy_object::from_wkt(get_str(strs[i], lens[i]));
+
+            if ( lz == OGC_NULL || (!name_only && lz->object() == OGC_NULL) )
+               bad++;
+            delete lz;
+            continue;
+         }
+
+         if ( !t.tokenize(strs[i], lens[i], OGC_OBJ_KWD_OBJECT) )
+         {
+            bad++;
+            continue;
+         }
+
+         ogc_object * obj = ogc_object::from_tokens(&t, 0, OGC_NULL);
+
+         if ( obj == OGC_NULL )
+            bad++;
          delete obj;
       }
    }
 
-   fclose(fp);
+   secs = (double)(clock() - beg) / CLOCKS_PER_SEC;
+   if ( secs <= 0.0 )
+      secs = 1.0 / CLOCKS_PER_SEC;
+
+   printf("%10.1f MB/sec  %10.0f strings/sec  (%d invalid)\n",
+      ((double)bytes * bench) / secs / (1024.0 * 1024.0),
+      ((double)num   * bench) / secs,
+      (bench > 0) ? (bad / bench) : 0);
+
+   if ( !validate && !lazy )
+   {
+      footprint(t, strs, lens, num, false, false);
+      footprint(t, strs, lens, num, true,  false);
+      footprint(t, strs, lens, num, false, true);
+   }
+
+   free(strs);
+   free(lens);
+}
+
+/*------------------------------------------------------------------------
+ * benchmark parsing in threads
+ *
+ * The strings are parsed with 1, 2, 4, ... threads (up to the number
+ * asked for), to show how the parsing scales, both as a batch of
+ * strings already read, and end-to-end from the file (where finding
+ * the strings is also split between the threads).
+ */
+static void benchmark_batch()
+{
+   ogc_wkt_reader rdr(multi_line ? OGC_READER_MODE_MULTI :
+                                   OGC_READER_MODE_LINES);
+   const char **  strs;
+   ogc_object **  objs;
+   char *         buf;
+   int            num;
+   size_t         bytes = 0;
+   int            max   = (threads > 0) ? threads : cpu_count();
+   double         base  = 0.0;
+   double         fbase = 0.0;
+
+   open_reader(rdr);
+   buf = get_all_strs(rdr, &strs, &num);
+
+   objs = (ogc_object **)malloc((num + 1) * sizeof(*objs));
+   if ( objs == NULL )
+   {
+      fprintf(stderr, "%s: out of memory\n", pgm);
+      exit(EXIT_FAILURE);
+   }
+
+   for (int i = 0; i < num; i++)
+      bytes += strlen(strs[i]);
+
+   printf("%d strings, %lu bytes, %d passes\n", num,
+      (unsigned long)bytes, bench);
+
+   for (int nt = 1; ; nt = (nt * 2 > max) ? max : (nt * 2))
+   {
+      double beg = wall_secs();
+      double secs;
+      double rate;
+      double frate;
+      size_t good = 0;
+
+      for (int n = 0; n < bench; n++)
+      {
+         good = ogc_object::from_wkt_batch(strs, num, objs, OGC_NULL, nt);
+         for (int i = 0; i < num; i++)
+            delete objs[i];
+      }
+
+      secs = wall_secs() - beg;
+      if ( secs <= 0.0 )
+         secs = 0.001;
+      rate = ((double)num * bench) / secs;
+
+      beg = wall_secs();
+      for (int n = 0; n < bench; n++)
+      {
+         rdr.rewind();
+         rdr.parse_all(OGC_NULL, NULL, nt);
+      }
+
+      secs = wall_secs() - beg;
+      if ( secs <= 0.0 )
+         secs = 0.001;
+      frate = ((double)rdr.size() * bench) / secs / (1024.0 * 1024.0);
+
+      if ( nt == 1 )
+      {
+         base  = rate;
+         fbase = frate;
+      }
+
+      printf("%3d threads  batch %10.0f strings/sec %5.2fx  "
+             "file %8.1f MB/sec %5.2fx  (%d invalid)\n",
+         nt,
+         rate,
+         (base  > 0.0) ? (rate  / base)  : 0.0,
+         frate,
+         (fbase > 0.0) ? (frate / fbase) : 0.0,
+         num - (int)good);
+
+      if ( nt >= max )
+         break;
+   }
+
+   free(objs);
+   free(strs);
+   free(buf);
+}
+
+/*------------------------------------------------------------------------
+ * show a WKT string parsed in a thread
+ */
+static void _CDECL show_parsed(
+   void *            data,
+   const char *      str,
+   size_t            len,
+   ogc_object *      obj,
+   const ogc_error * err)
+{
+   (void)(data);
+   (void)(str);
+   (void)(len);
+
+   if ( err != OGC_NULL )
+      printf("%s\n", err->err_msg());
+
+   show_object(obj);
+   delete obj;
+}
+
+/*------------------------------------------------------------------------
+ * process all WKT strings in the input file at once, in threads
+ *
+ * The file is split between the threads, and the objects are shown in
+ * the order of the strings, so the output is the same as when
+ * processing them one at a time.
+ */
+static void process_batch()
+{
+   ogc_wkt_reader rdr(multi_line ? OGC_READER_MODE_MULTI :
+                                   OGC_READER_MODE_LINES);
+
+   open_reader(rdr);
+   rdr.parse_all(show_parsed, NULL, threads);
+}
+
+/*------------------------------------------------------------------------
+ * process all WKT strings in the input file
+ *
+ * Each string is a view into the file read, and is tokenized where it
+ * is, with a token object that is re-used.
+ */
+static void process_file()
+{
+   ogc_wkt_reader rdr(multi_line ? OGC_READER_MODE_MULTI :
+                                   OGC_READER_MODE_LINES);
+   ogc_token      t(OGC_TOKEN_MODE_SPAN);
+   const char *   str;
+   size_t         len;
+
+   open_reader(rdr);
+
+   ogc_error::set_err_rtn( error_rtn );
+
+   while ( rdr.next(&str, &len) )
+   {
+      ogc_object * obj;
+
+      if ( validate )
+      {
+         ogc_object::validate_wkt(get_str(str, len));
+         continue;
+      }
+
+      if ( lazy )
+      {
+         ogc_lazy_object * lz =
+            ogc_lazy_object::from_wkt(get_str(str, len));
+
+         if ( lz != OGC_NULL )
+         {
+            if ( name_only )
+               printf("%s\n", lz->name());
+            else
+               show_object(lz->object());
+            delete lz;
+         }
+         continue;
+      }
+
+      if ( !t.tokenize(str, len, OGC_OBJ_KWD_OBJECT) )
+         continue;
+
+      obj = ogc_object::from_tokens(&t, 0, OGC_NULL);
+      show_object(obj);
+      delete obj;
+   }
+}
+
+/*------------------------------------------------------------------------
+ * main()
+ */
+int main(int argc, const char **argv)
+{
+   process_options(argc, argv);
+
+   if ( bench > 0 )
+   {
+      if ( threads >= 0 && !validate && !lazy )
+         benchmark_batch();
+      else
+         benchmark();
+      return EXIT_SUCCESS;
+   }
+
+   if ( chunk > 0 )
+   {
+      ogc_error::set_err_rtn( error_rtn );
+      read_chunks();
+      return EXIT_SUCCESS;
+   }
+
+   if ( threads >= 0 && !validate && !lazy )
+   {
+      process_batch();
+      return EXIT_SUCCESS;
+   }
+
+   process_file();
    return EXIT_SUCCESS;
 }
@@ -22,7 +22,9 @@
 #define LIBOGC_H_INCLUDED
 
 #include <stddef.h>
+#include <stdio.h>
 #include <time.h>
+#include <new>
 
 /* ------------------------------------------------------------------------- */
 
@@ -44,6 +46,14 @@
 #  define   _CDECL
 #endif
 
+/* Deal with non-throwing declarations (for allocation operators). */
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#  define   OGC_NOTHROW  noexcept
+#else
+#  define   OGC_NOTHROW  throw()
+#endif
+
 /* ------------------------------------------------------------------------- */
 
 namespace OGC {
@@ -604,6 +614,7 @@ enum ogc_err_code
 
       OGC_ERR_NONE                       = 0,
       OGC_ERR_NO_MEMORY,
+      OGC_ERR_CANNOT_OPEN_FILE,
 
    /* These errors come from the from_wkt() & from_tokens() methods */
 
@@ -725,9 +736,48 @@ enum ogc_err_code
 #define OGC_ERR_MSG_MAX  256
 typedef char             OGC_ERR_BUF [OGC_ERR_MSG_MAX];
 
+#define OGC_ERR_KWD_MAX   32     /* longest keyword kept in an error    */
+#define OGC_ERR_ARG_MAX   48     /* longest string arg kept in a record */
+
+/* error argument types */
+
+#define OGC_ERR_ARG_NONE  0
+#define OGC_ERR_ARG_STR   1
+#define OGC_ERR_ARG_INT   2
+#define OGC_ERR_ARG_DBL   3
+
+#define OGC_ERR_POS_NONE  (static_cast<size_t>(-1))
+
+/*------------------------------------------------------------------------
+ * An ogc_err_rec is a compact record of an error, as kept by a parse
+ * context (see ogc_parse_ctx::set_keep_errs()).  Its message is only
+ * made when asked for by ogc_error::err_msg(rec, buf).
+ */
+struct ogc_err_rec
+{
+   ogc_err_code code;
+   int          arg_type;                /* OGC_ERR_ARG_*             */
+   int          iarg;
+   double       darg;
+   size_t       pos;                     /* or OGC_ERR_POS_NONE       */
+   char         kwd  [OGC_ERR_KWD_MAX];  /* truncated if longer       */
+   char         sarg [OGC_ERR_ARG_MAX];  /* truncated if longer       */
+};
 
+class ogc_parse_ctx;
+
+/*------------------------------------------------------------------------
+ * An ogc_error only records the pieces of an error when it is set (the
+ * code, the keyword, and the argument).  The message is made from them
+ * the first time it is asked for by err_msg(), or when a call-back
+ * routine is to be called with it, so an error that nobody looks at
+ * costs next to nothing.  An error set with a null error object and no
+ * global routine is not even recorded.
+ */
 class OGC_EXPORT ogc_error
 {
+   friend class ogc_parse_ctx;
+
 public:
    typedef void (_CDECL OGC_ERR_RTN) (
       void *       usr_data,
@@ -738,11 +788,30 @@ private:
    static OGC_ERR_RTN * _usr_rtn;
    static void *        _usr_data;
 
-   ogc_err_code _err_code;
-   OGC_ERR_BUF  _err_msg;
-
+   ogc_err_code          _err_code;
+   int                   _arg_type;
+   int                   _iarg;
+   double                _darg;
+   char                  _kwd [OGC_ERR_KWD_MAX];
+   mutable bool          _fmt;      /* true if _err_msg is the message  */
+   mutable OGC_ERR_BUF   _err_msg;  /* the message (or the string arg)  */
+   OGC_ERR_RTN *         _rtn;
+   void *                _data;
+   bool                  _quiet;    /* true to never call global rtn    */
+   const ogc_parse_ctx * _ctx;      /* context parsing for (if any)     */
+
+   void record(ogc_err_code err_code, const char * obj_kwd, int arg_type);
    void send();
 
+   static void format(
+      char *       buf,
+      ogc_err_code err_code,
+      const char * obj_kwd,
+      int          arg_type,
+      const char * sarg,
+      int          iarg,
+      double       darg);
+
 public:
     ogc_error();
    ~ogc_error() {}
@@ -772,7 +841,7 @@ public:
       double       arg);
 
    ogc_err_code err_code () const { return _err_code; }
-   const char * err_msg  () const { return _err_msg;  }
+   const char * err_msg  () const;
 
    /* Set an error call-back routine.
       If this is set, the routine will be called with each error,
@@ -780,6 +849,18 @@ public:
    */
    static void set_err_rtn(OGC_ERR_RTN * rtn, void * data = OGC_NULL);
 
+   /* Set a call-back routine for this error object only.
+      If this is set, it is called instead of the global routine
+      for each error set in this object.
+   */
+   void          set_rtn(OGC_ERR_RTN * rtn, void * data = OGC_NULL);
+   OGC_ERR_RTN * rtn()  const { return _rtn;  }
+   void *        data() const { return _data; }
+
+   /* Copy the error (but not the call-back routine) of another error
+      object, without calling any routine. */
+   void copy(const ogc_error & e);
+
    /* static methods */
 
    static void clear(
@@ -819,47 +900,762 @@ public:
       const ogc_error *  err);
 
    static const char * err_str(ogc_err_code err_code);
+
+   /* Make the message of an error record (see ogc_err_rec). */
+   static const char * err_msg(
+      const ogc_err_rec * rec,
+      OGC_ERR_BUF         buf);
+};
+
+/* ------------------------------------------------------------------------- */
+/* memory allocation                                                         */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * An ogc_allocator is where the library gets all of its memory: objects,
+ * vectors, tokens, and all buffers.
+ *
+ * The default allocator uses the heap (malloc(), realloc(), and free()),
+ * but an allocator may be made with routines of its own, which are
+ * called with the data pointer it was made with.  The alloc routine
+ * must return memory aligned for any type (as malloc() does), or null
+ * if out of memory.  The realloc routine may be null, in which case
+ * memory is moved by the alloc and free routines.
+ *
+ * The global allocator is used unless a parse context has one (see
+ * ogc_parse_ctx::set_allocator()), in which case it is used for all
+ * memory allocated by a parse using the context.
+ *
+ * Each piece of memory remembers the allocator it came from and goes
+ * back to it when freed, no matter what allocator is in use then.  So
+ * an allocator must not be deleted while any of its memory is still in
+ * use (such as the objects made by a parse).
+ *
+ * An allocator may also count the allocations and frees made, the bytes
+ * in use, and the total bytes ever allocated (not counting the small
+ * header on each piece of memory).  Counting is off by default, as the
+ * counts are updated atomically (so an allocator may be used by many
+ * threads at once, if its routines may), which costs a little.
+ */
+class OGC_EXPORT ogc_allocator
+{
+   friend class ogc_alloc_scope;
+
+public:
+   typedef void * (_CDECL OGC_ALLOC_RTN) (
+      void *       data,
+      size_t       size);
+
+   typedef void * (_CDECL OGC_REALLOC_RTN) (
+      void *       data,
+      void *       p,
+      size_t       size);
+
+   typedef void   (_CDECL OGC_FREE_RTN) (
+      void *       data,
+      void *       p);
+
+private:
+   OGC_ALLOC_RTN *   _alloc_rtn;
+   OGC_REALLOC_RTN * _realloc_rtn;
+   OGC_FREE_RTN *    _free_rtn;
+   void *            _data;
+
+   volatile size_t   _num_allocs;    /* number of allocations       */
+   volatile size_t   _num_frees;     /* number of frees             */
+   volatile size_t   _bytes;         /* bytes in use                */
+   volatile size_t   _bytes_total;   /* bytes ever allocated        */
+   bool              _counting;
+
+   static ogc_allocator * use(ogc_allocator * a);
+
+   ogc_allocator(const ogc_allocator &);
+   ogc_allocator & operator = (const ogc_allocator &);
+
+public:
+    ogc_allocator();
+    ogc_allocator(
+      OGC_ALLOC_RTN *   alloc_rtn,
+      OGC_REALLOC_RTN * realloc_rtn,
+      OGC_FREE_RTN *    free_rtn,
+      void *            data = OGC_NULL);
+   ~ogc_allocator();
+
+   /* Set the global allocator (null for the heap), returning the old
+      one.  This should be done before any memory is allocated, and not
+      while other threads may be allocating. */
+   static ogc_allocator * set_global(ogc_allocator * a);
+   static ogc_allocator * global();
+
+   /* Get the allocator in use in this thread: the one of the parse
+      context being used (if it has one), or else the global one. */
+   static ogc_allocator * current();
+
+   /* Allocate memory (null if out of memory). */
+   void *        alloc(size_t size);
+
+   /* Resize or free memory from any allocator (realloc of null is
+      alloc from the current allocator). */
+   static void * realloc(void * p, size_t size);
+   static void   free   (void * p);
+
+   size_t num_allocs()  const { return _num_allocs;  }
+   size_t num_frees()   const { return _num_frees;   }
+   size_t bytes()       const { return _bytes;       }
+   size_t bytes_total() const { return _bytes_total; }
+
+   /* Turn counting on or off (returning the old setting), or reset the
+      counts (the bytes in use are kept).  Memory allocated while not
+      counting is not counted when freed either. */
+   bool   set_counting(bool on_off);
+   bool   counting()    const { return _counting;    }
+   void   reset_counts();
+};
+
+/* ------------------------------------------------------------------------- */
+/* parse context                                                             */
+/* ------------------------------------------------------------------------- */
+
+#define OGC_CTX_ERRS_MAX  32   /* number of error records kept */
+
+class ogc_token;
+class ogc_scratch;
+
+/*------------------------------------------------------------------------
+ * An ogc_parse_ctx holds the settings for parsing, so each thread (or
+ * each caller) can parse with its own settings without using (or
+ * changing) the global ones:
+ *
+ *   strict       the strict parsing option
+ *                (see ogc_object::set_strict_parsing(), default is on)
+ *
+ *   max_len      the longest WKT string accepted, in chars
+ *                (0, the default, only applies the OGC_BUFF_MAX limit)
+ *
+ *   err_rtn      an error call-back routine, which is called instead of
+ *                the global one for the errors of a parse using the
+ *                context (unless the caller's ogc_error has its own)
+ *
+ *   quiet        if on, the global routine is never called for the
+ *                errors of a parse using the context (they are only
+ *                returned), default is off
+ *
+ *   keep_errs    if on, each error of a parse using the context is also
+ *                kept as a record (see ogc_err_rec) in a ring of the
+ *                last OGC_CTX_ERRS_MAX errors, default is off
+ *
+ *   allocator    the allocator for all memory allocated by a parse using
+ *                the context (see ogc_allocator), default is null (the
+ *                global allocator)
+ *
+ * The kept errors are only cleared by clear_errs(), so the errors of
+ * any number of parses may be collected.  A record only holds the
+ * pieces of an error, and its message is only made if asked for.
+ *
+ * Each kept error also has its byte offset in the WKT string: the
+ * position of a syntax error, or else the offset of the keyword of the
+ * object being built when it was found.  As a bad sub-object doesn't
+ * stop its parent from going on to the rest of its sub-objects, a
+ * single parse with a context keeping errors finds all the errors of a
+ * string (unless the tokenizing fails, which stops at the first).
+ *
+ * A context also keeps the tokens and the scratch memory used by
+ * ogc_object::validate_wkt(), so validating with a context is
+ * thread-safe and doesn't allocate (after the first few strings).
+ *
+ * A context is given to ogc_token::set_ctx(), and then applies to
+ * tokenizing and to all from_tokens() calls on those tokens.  The
+ * methods that take a WKT string have overloads that take a context.
+ *
+ * A null context means the global settings, which are the defaults.
+ *
+ * A context may be used by only one thread at a time.
+ */
+class OGC_EXPORT ogc_parse_ctx
+{
+   friend class ogc_error;
+
+private:
+   bool                     _strict;
+   size_t                   _max_len;
+   ogc_error::OGC_ERR_RTN * _err_rtn;
+   void *                   _err_data;
+   ogc_token *              _token;      /* tokens for validating         */
+   ogc_scratch *            _scratch;    /* scratch memory for validating */
+   bool                     _quiet;
+   bool                     _keep_errs;
+   mutable size_t           _num_errs;   /* errors kept since cleared     */
+   mutable size_t           _err_pos;    /* position for errors kept      */
+   mutable ogc_err_rec      _errs [OGC_CTX_ERRS_MAX];
+   ogc_allocator *          _alloc;
+
+   void keep_err(const ogc_error & e) const;
+
+   ogc_parse_ctx(const ogc_parse_ctx &);
+   ogc_parse_ctx & operator = (const ogc_parse_ctx &);
+
+public:
+    ogc_parse_ctx();
+   ~ogc_parse_ctx();
+
+   bool   set_strict(bool on_off);
+   bool   strict()  const { return _strict;  }
+
+   void   set_max_len(size_t len) { _max_len = len; }
+   size_t max_len() const { return _max_len; }
+
+   void   set_err_rtn(ogc_error::OGC_ERR_RTN * rtn, void * data = OGC_NULL);
+   ogc_error::OGC_ERR_RTN * err_rtn()  const { return _err_rtn;  }
+   void *                   err_data() const { return _err_data; }
+
+   bool   set_quiet(bool on_off);
+   bool   quiet()   const { return _quiet; }
+
+   bool   set_keep_errs(bool on_off);
+   bool   keep_errs() const { return _keep_errs; }
+
+   ogc_allocator * set_allocator(ogc_allocator * a);
+   ogc_allocator * allocator() const { return _alloc; }
+
+   /* The number of errors kept since the last clear_errs() (of which
+      only the last OGC_CTX_ERRS_MAX are still held), the number held,
+      and the n-th one held (oldest first, or null if out of range). */
+   size_t              err_count() const { return _num_errs; }
+   size_t              errs_held() const;
+   const ogc_err_rec * err_rec(size_t n) const;
+   void                clear_errs() { _num_errs = 0; }
+
+   /* internal methods */
+
+   ogc_token *   token();
+   ogc_scratch * scratch();
+
+   /* Set the position given to the errors kept (returning the old one).
+      This is set to the offset of each object as it is built (see
+      ogc_err_pos), and of each syntax error. */
+   size_t set_err_pos(size_t pos) const;
+
+   /* Get the error object to use for a parse: the caller's, unless the
+      context has a routine or settings that should be used for it, in
+      which case the local one is set up (and is copied back by
+      end_err()). */
+   static ogc_error * begin_err(
+      const ogc_parse_ctx * ctx,
+      ogc_error *           err,
+      ogc_error *           local);
+
+   static void end_err(
+      ogc_error *           err,
+      const ogc_error *     used);
+};
+
+/* ------------------------------------------------------------------------- */
+/* object arenas                                                             */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * An ogc_arena holds whole object trees in a few large blocks of memory.
+ *
+ * Objects parsed with ogc_object::from_wkt(..., arena) take all their
+ * memory (for every sub-object and vector) from the arena, just by
+ * bumping a pointer.  Deleting the arena (or calling reset()) discards
+ * all of them at once, without destroying them, so any objects in it
+ * must not be used after that.
+ *
+ * Objects in an arena may still be changed, and even deleted (which
+ * frees nothing), so a tree may be used just like any other.  Any new
+ * sub-objects (and any clones) are taken from the heap as usual.
+ *
+ * An arena may only be used by one thread at a time.
+ */
+class OGC_EXPORT ogc_arena
+{
+private:
+   ogc_scratch * _mem;
+
+   ogc_arena(const ogc_arena &);
+   ogc_arena & operator = (const ogc_arena &);
+
+public:
+    ogc_arena();
+   ~ogc_arena();
+
+   /* Discard all objects in the arena, but keep its memory. */
+   void   reset();
+
+   /* Get the total size of the memory held. */
+   size_t size() const;
+
+   ogc_scratch * mem() const { return _mem; }
 };
 
 /* ------------------------------------------------------------------------- */
 /* string tokenizing                                                         */
 /* ------------------------------------------------------------------------- */
 
-#define OGC_TOKENS_MAX   512
+#define OGC_TOKENS_INIT  64   /* initial number of token entries      */
+
+/* tokenizer modes */
+
+#define OGC_TOKEN_MODE_COPY  0  /* copy the WKT string into our buffer    */
+#define OGC_TOKEN_MODE_SPAN  1  /* reference the caller's WKT string     */
 
 struct ogc_token_entry
 {
-   char * str;       /* token string                    */
+   char * str;       /* token string (see ogc_token::str()) */
    int    lvl;       /* token level                     */
    int    idx;       /* token index for this sub-object */
+   int    pos;       /* offset of token in WKT string   */
+   int    len;       /* length of token in WKT string   */
+   int    off;       /* offset of token in caller's string */
+   int    end;       /* index past the end of its object    */
+   int    same;      /* number of leading non-object tokens */
+
+   ogc_obj_type type;   /* object type if token is a keyword   */
+   bool         old;    /* true if it is an old (WKT1) keyword */
 };
 
+/*------------------------------------------------------------------------
+ * In OGC_TOKEN_MODE_COPY (the default), the WKT string is copied into
+ * our internal buffer and all token strings are set when tokenizing.
+ *
+ * In OGC_TOKEN_MODE_SPAN, the tokens only reference the caller's WKT
+ * string by (pos, len), which must stay valid while the token object is
+ * in use.  A token string is only created (with quotes removed, quoted
+ * whitespace collapsed, and unquoted whitespace stripped) when it is
+ * asked for by str().
+ *
+ * In either mode, the off of a token is its offset in the caller's
+ * string (at its opening quote if it is quoted), which is where errors
+ * about it are placed (see ogc_err_rec).
+ *
+ * The token entries start in a small internal array, and are moved to
+ * an allocated array (which is grown as needed) for larger strings.
+ * All memory is kept when the object is reset() or re-used, so one token
+ * object may be used for any number of strings without re-allocating.
+ *
+ * A string is checked and split into tokens in a single pass.  It may
+ * also be given by its length, so a string within a larger buffer (that
+ * isn't null-terminated there) can be tokenized without copying it.
+ *
+ * For each token, the index past the end of its object (which is the
+ * next index for a token that isn't an object) and the number of
+ * non-object tokens that start its object are also set, so an object
+ * may be processed (or skipped) without scanning for these.
+ *
+ * Each keyword token (the first token of an object) is also classified
+ * once into its object type, so the object builders can dispatch on the
+ * type without comparing keyword strings.  Any other token has a type of
+ * OGC_OBJ_TYPE_UNKNOWN.
+ *
+ * In span mode, the string is first scanned with vector instructions
+ * (if available) for the positions of all structural chars, and the
+ * tokens are then found using only those positions.  This can be turned
+ * off with set_simd(false), which gives the same results.
+ *
+ * The tokens may be given a parse context (see ogc_parse_ctx), which
+ * is then used by all from_tokens() calls on them.
+ */
 class OGC_EXPORT ogc_token
 {
 private:
-   char * _buffer;
+   static bool       _simd;
+
+   char *            _buffer;
+   size_t            _buflen;
+   size_t            _bufpos;
+   int               _mode;
+   const char *      _wkt;
+   const char *      _wkt_end;
+   int               _extra;
+   int               _max;
+   ogc_token_entry   _fixed [OGC_TOKENS_INIT];
+   int *             _sidx;
+   int               _snum;
+   int               _smax;
+   char *            _copy;
+   size_t            _copymax;
+   const ogc_parse_ctx * _ctx;
+
+   bool grow();
+
+   void end_list(
+      int count);
+
+   bool scan(
+      const char * str,
+      const char * start,
+      const char * obj_kwd,
+      ogc_error *  err);
 
-   bool pass1(
+   bool scan_simd(
       const char * str,
       const char * start,
+      int          len,
+      const char * obj_kwd,
+      ogc_error *  err);
+
+   bool tokenize_str(
+      const char * start,
+      size_t       len,
+      bool         terminated,
+      const char * obj_kwd,
+      ogc_error *  err);
+
+   bool scan_str(
+      const char * start,
+      size_t       len,
+      bool         terminated,
       const char * obj_kwd,
       ogc_error *  err);
 
-   static int parse_substring(
-      char ** pb,
-      char ** pe);
+   bool alloc_buffer(
+      size_t len);
+
+   char * make_str(
+      int  n);
 
 public:
-   ogc_token_entry  _arr [OGC_TOKENS_MAX];
-   int              _num;
+   ogc_token_entry * _arr;
+   int               _num;
 
-    ogc_token();
+    ogc_token(int mode = OGC_TOKEN_MODE_COPY);
    ~ogc_token();
 
    bool tokenize(
       const char * str,
       const char * obj_kwd,
       ogc_error *  err = OGC_NULL);
+
+   bool tokenize(
+      const char * str,
+      size_t       len,
+      const char * obj_kwd,
+      ogc_error *  err = OGC_NULL);
+
+   void reset();
+
+   const char * str (int n) const;
+   double       num (int n) const;
+   ogc_obj_type type(int n) const;
+   int          mode()      const { return _mode; }
+
+   /* parse context (OGC_NULL for the global settings) */
+   void                  set_ctx(const ogc_parse_ctx * ctx) { _ctx = ctx; }
+   const ogc_parse_ctx * ctx()    const { return _ctx; }
+   bool                  strict() const;
+
+   /* Vectorized scanning option (default is on). */
+   static bool set_simd(bool on_off);
+   static bool get_simd();
+
+   /* name of the instruction set used ("sse2", "avx2", "neon", or
+      "portable") */
+   static const char * simd_name();
+};
+
+/*------------------------------------------------------------------------
+ * An ogc_token_stream tokenizes a stream of WKT strings that arrives in
+ * chunks of any size (from a socket or a decompressor, for example).
+ *
+ * Each chunk is given to feed(), and the quote and bracket state is kept
+ * across chunks, so a chunk may end anywhere (even inside a token or a
+ * quoted string).  After each feed(), next() is called until it returns
+ * false, and each time it returns true a complete top-level object has
+ * been taken from the stream and tokenized.  An object is complete as
+ * soon as its closing "]" (or ")") arrives.  Objects may be separated by
+ * whitespace.
+ *
+ * When the input ends, finish() is called and next() is called again, to
+ * get any object that was never closed (which is only valid if strict
+ * parsing is off).
+ *
+ * Only the text of the objects not yet taken is kept, so memory use is
+ * bounded by the largest object (plus a chunk), not by the whole stream.
+ * An object that is too long is skipped as it arrives, and is returned
+ * by next() with an error.
+ *
+ * If next() returns true, the error (if any) is set, and token() returns
+ * the tokens of the object (or OGC_NULL if it could not be tokenized),
+ * which may be given to ogc_object::from_tokens().  The tokens and the
+ * wkt() string are only valid until the next call to feed(), next(),
+ * finish(), or reset().
+ */
+class OGC_EXPORT ogc_token_stream
+{
+private:
+   ogc_token    _token;
+   char *       _buffer;     /* text of the objects not yet taken      */
+   size_t       _buflen;     /* allocated length of the buffer         */
+   size_t       _len;        /* length of the text in the buffer       */
+   size_t       _beg;        /* start of the current object            */
+   size_t       _pos;        /* next char to scan                      */
+   size_t       _end;        /* end of the object last taken           */
+   char         _saved;      /* char replaced by its terminating null  */
+   bool         _taken;      /* an object is taken (& null-terminated) */
+   bool         _ok;         /* the object taken was tokenized         */
+   bool         _finished;   /* finish() has been called               */
+
+   bool         _started;    /* current object has started             */
+   bool         _in_quotes;  /* current object is within quotes        */
+   bool         _skip;       /* current object is too long             */
+   int          _depth;      /* bracket depth of current object        */
+   size_t       _count;      /* non-whitespace chars in current object */
+   size_t       _skip_pos;   /* offset in object where it got too long */
+
+   bool reserve(
+      size_t len);
+
+   void release();
+
+   bool take(
+      size_t       end,
+      ogc_error *  err);
+
+public:
+    ogc_token_stream(int mode = OGC_TOKEN_MODE_SPAN);
+   ~ogc_token_stream();
+
+   bool feed(
+      const char * buf,
+      size_t       len,
+      ogc_error *  err = OGC_NULL);
+
+   void finish();
+
+   bool next(
+      ogc_error *  err = OGC_NULL);
+
+   void reset();
+
+   void set_ctx(const ogc_parse_ctx * ctx) { _token.set_ctx(ctx); }
+
+   const ogc_token * token() const;
+   const char *      wkt()   const;
+};
+
+/* ------------------------------------------------------------------------- */
+/* WKT file reading                                                          */
+/* ------------------------------------------------------------------------- */
+
+/* reader modes */
+
+#define OGC_READER_MODE_LINES  0  /* one WKT string per line             */
+#define OGC_READER_MODE_MULTI  1  /* WKT strings may span multiple lines */
+
+/*------------------------------------------------------------------------
+ * An ogc_wkt_reader reads a file of many WKT strings.
+ *
+ * The file is memory-mapped (or read into memory if it can't be mapped,
+ * such as a pipe, or standard input if the filename is "-"), and next()
+ * returns each WKT string as a view (a pointer and a length) into that
+ * memory, without copying it.  A view may be given directly to
+ * ogc_token::tokenize(str, len, ...).  All views are valid until the
+ * file is closed.
+ *
+ * In OGC_READER_MODE_LINES, each non-blank line is a WKT string.
+ *
+ * In OGC_READER_MODE_MULTI, a WKT string continues over as many lines
+ * as needed for its brackets (outside of quotes) to balance, and the rest
+ * of the line it ends on is skipped.  This allows reading WKT strings
+ * that are split over lines, such as examples cut and pasted from a
+ * document.
+ *
+ * Leading and trailing whitespace is not included in a view.
+ *
+ * parse_all() parses all the (remaining) strings of the file using
+ * multiple threads.  The file is done in rounds of about a megabyte per
+ * thread, and each round is split into one range per thread.  Each
+ * thread guesses where the first string in its range starts (the first
+ * line, or in OGC_READER_MODE_MULTI the first unindented line), and
+ * parses the strings from there.  A wrong guess (such as a line inside
+ * a string that straddles two ranges) is fixed up by scanning on from
+ * where the previous range really ended until it meets a string
+ * boundary found by the thread, so the strings are the same as those
+ * next() would return.
+ *
+ * After each round, rtn is called for each of its strings in order (in
+ * the calling thread), and is given its object to keep (or NULL if it
+ * could not be parsed) and its last error (or NULL if none).  If rtn is
+ * NULL, the objects are just counted and destroyed.  The current global
+ * strict setting is used, and no error routines are called.  If
+ * nthreads is 0, one thread per processor is used.  The number of
+ * objects created is returned.
+ */
+class ogc_object;
+
+class OGC_EXPORT ogc_wkt_reader
+{
+private:
+   const char * _data;       /* file contents                */
+   size_t       _size;       /* file length                  */
+   size_t       _pos;        /* start of the next line       */
+   int          _mode;       /* OGC_READER_MODE_*            */
+   char *       _mem;        /* contents if read into memory */
+   void *       _map;        /* contents if mapped           */
+#ifdef _WIN32
+   void *       _hfile;
+   void *       _hmap;
+#endif
+
+   bool read_file(
+      const char * filename,
+      ogc_error *  err);
+
+   bool scan(
+      size_t *      ppos,
+      const char ** pstr,
+      size_t *      plen) const;
+
+   static void parse_part(
+      void * data,
+      int    n);
+
+public:
+   typedef void (_CDECL OGC_READER_RTN) (
+      void *            data,
+      const char *      str,
+      size_t            len,
+      ogc_object *      obj,
+      const ogc_error * err);
+
+    ogc_wkt_reader(int mode = OGC_READER_MODE_LINES);
+   ~ogc_wkt_reader();
+
+   bool open(
+      const char * filename,
+      ogc_error *  err = OGC_NULL);
+
+   void close();
+
+   bool next(
+      const char ** pstr,
+      size_t *      plen);
+
+   void rewind() { _pos = 0; }
+
+   size_t parse_all(
+      OGC_READER_RTN * rtn,
+      void *           data,
+      int              nthreads = 0);
+
+   int          mode() const { return _mode;  }
+   size_t       size() const { return _size;  }
+   size_t       pos()  const { return _pos;   }
+   const char * data() const { return _data;  }
+};
+
+/* ------------------------------------------------------------------------- */
+/* WKT writing                                                               */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * An ogc_wkt_writer is what objects write their WKT to.
+ *
+ * Each object writes itself in place, as one item of the list it is in:
+ * open() writes its keyword and open bracket, then its values and
+ * sub-objects are written, and close() writes the close bracket.  A ','
+ * is written before each item that doesn't follow an open bracket, so
+ * an object (or sub-object) that writes nothing leaves no trace.
+ *
+ * A writer sends its output to one of these:
+ *
+ *   1. A caller's buffer.  Writing stops if the buffer is full.
+ *   2. A buffer of its own, which grows as needed.
+ *   3. A file, or a call-back routine.  The output is gathered in a
+ *      small buffer, which is sent on whenever it is full, when flush()
+ *      is called, and when the writer is deleted.
+ *
+ * ok() is false if anything didn't fit, memory ran out, or the output
+ * couldn't be sent on.  The buffer is always null-terminated, but only
+ * holds all of the output for the first two.
+ *
+ * If a top-level object is opened with OGC_WKT_OPT_EXPAND, it is written
+ * on multiple lines (as ogc_utils::expand_wkt() would do) until it is
+ * closed.
+ *
+ * To write several objects to one writer, call end() after each one.
+ */
+class OGC_EXPORT ogc_wkt_writer
+{
+public:
+   /* A routine to send output to, which returns false on error. */
+   typedef bool (_CDECL OGC_WRITER_RTN) (
+      void *       data,
+      const char * str,
+      size_t       len);
+
+private:
+   char *           _buf;    /* buffer being written to               */
+   size_t           _len;    /* length of the output in the buffer    */
+   size_t           _size;   /* size of the buffer                    */
+   size_t           _base;   /* length of the output already sent on  */
+   size_t           _min;    /* size to allocate first                */
+   OGC_WRITER_RTN * _rtn;    /* routine to send output to (if any)    */
+   void *           _data;   /* data for the routine                  */
+   bool             _own;    /* true if the buffer is ours (grows)    */
+   bool             _ok;     /* false if anything didn't fit          */
+   bool             _sep;    /* true if a ',' goes before next item   */
+   bool             _expand; /* true if expanding to multiple lines   */
+   char             _indent; /* indent char   (if expanding)          */
+   char             _opn;    /* open  bracket (if expanding)          */
+   char             _cls;    /* close bracket (if expanding)          */
+   int              _tab;    /* indent level  (if expanding)          */
+   int              _level;  /* number of objects open                */
+
+   ogc_wkt_writer(const ogc_wkt_writer &);
+   ogc_wkt_writer & operator = (const ogc_wkt_writer &);
+
+   void init();
+   bool send();
+   bool grow(size_t n);
+   void item(bool cr);
+   void line(bool cr);
+   void text(const char * str, bool quoted);
+   bool has_opn(const char * str) const;
+
+   static bool _CDECL file_rtn(
+      void *       data,
+      const char * str,
+      size_t       len);
+
+public:
+    ogc_wkt_writer();
+    ogc_wkt_writer(char buffer[], size_t buflen);
+    ogc_wkt_writer(FILE * fp,
+                   size_t bufsize = OGC_BUFF_MAX);
+    ogc_wkt_writer(OGC_WRITER_RTN * rtn,
+                   void *           data,
+                   size_t           bufsize = OGC_BUFF_MAX);
+   ~ogc_wkt_writer();
+
+   /* Discard the output not yet sent on. */
+   void reset();
+
+   /* Send the output in the buffer on to the file or routine. */
+   bool flush();
+
+   /* End an object: write str as is, with no ',' before the next one. */
+   void end(const char * str = "\n");
+
+   /* Write a keyword and its open bracket, or a close bracket
+      (as "[]" or, with OGC_WKT_OPT_PARENS, "()"). */
+   void open (const char * kwd, int options);
+   void close(int options);
+
+   /* Write an item: a string as is (such as an enumeration value),
+      a quoted string (with any quotes in it doubled), or a number. */
+   void put    (const char * str);
+   void put_str(const char * str);
+   void put_num(double d);
+   void put_int(int n);
+
+   /* Write text as is (no ',' is added). */
+   void write(const char * str, size_t len);
+
+   const char * str() const { return (_buf == OGC_NULL) ? "" : _buf; }
+   size_t       len() const { return _base + _len; }
+   bool         ok()  const { return _ok; }
 };
 
 /* ------------------------------------------------------------------------- */
@@ -868,16 +1664,39 @@ public:
 
 class OGC_EXPORT ogc_object
 {
+   friend class ogc_share_table;
+
 private:
    static bool  _strict_parsing;
 
 protected:
-   ogc_obj_type _obj_type;
-   bool         _visible;
+   ogc_obj_type   _obj_type;
+   bool           _visible;
+   bool           _shared;     /* shared by other objects (see ogc_share)  */
+   unsigned short _refs;       /* number of objects that have it if shared */
 
-   ogc_object() {}
+   ogc_object() : _shared(false), _refs(0) {}
 
 public:
+   /* All objects are created with new (std::nothrow), which takes them
+      from scratch memory while validating (see validate_wkt()), or
+      from an arena while parsing into one (see ogc_arena).  An object
+      with names or other strings is created with new (extra,
+      std::nothrow), and its strings are kept in the extra bytes right
+      after it, so they take only the room they need, and are freed
+      with it. */
+   static void * operator new   (size_t size,
+                                 const std::nothrow_t &) OGC_NOTHROW;
+   static void * operator new   (size_t size,
+                                 size_t extra,
+                                 const std::nothrow_t &) OGC_NOTHROW;
+   static void   operator delete(void * p);
+   static void   operator delete(void * p,
+                                 const std::nothrow_t &) OGC_NOTHROW;
+   static void   operator delete(void * p,
+                                 size_t extra,
+                                 const std::nothrow_t &) OGC_NOTHROW;
+
    static const char * obj_kwd();
    static bool is_kwd(const char * kwd);
 
@@ -889,11 +1708,17 @@ public:
     *   2. Token parsing stops at the matching ] char to the opening [ char.
     *      (ie. any chars after the closing ] are ignored.)
     *   3. Extra atomic (ie. non sub-object) tokens in an object are ignored.
+    *
+    * This is the global setting, which is used when parsing without a
+    * parse context (see ogc_parse_ctx).
     */
    static bool set_strict_parsing(bool on_off);
    static bool get_strict_parsing();
 
    virtual ~ogc_object();
+
+   /* A shared sub-object (see ogc_share) is only deleted when the last
+      object that has it is destroyed. */
    static ogc_object * destroy(ogc_object * obj);
 
    static ogc_object * from_tokens(
@@ -906,6 +1731,65 @@ public:
       const char * wkt,
       ogc_error *  err = OGC_NULL);
 
+   static ogc_object * from_wkt(
+      ogc_parse_ctx * ctx,
+      const char *    wkt,
+      ogc_error *     err = OGC_NULL);
+
+   /* Create an object (and all its sub-objects) in an arena.
+    *
+    * The object is only deleted along with the arena (see ogc_arena).
+    * If arena is NULL, this is just like the calls above.
+    */
+   static ogc_object * from_wkt(
+      const char * wkt,
+      ogc_error *  err,
+      ogc_arena *  arena);
+
+   static ogc_object * from_wkt(
+      ogc_parse_ctx * ctx,
+      const char *    wkt,
+      ogc_error *     err,
+      ogc_arena *     arena);
+
+   /* Create objects from many WKT strings, using multiple threads.
+    *
+    * out[i] is set to the object from wkts[i] (or NULL if it can't be
+    * parsed), and errs[i] (if errs is not NULL) to its last error, so the
+    * results don't depend on which thread parsed which string.  The
+    * current global strict setting is used, and no error routines
+    * are called (unless an errs[i] has its own).
+    *
+    * If nthreads is 0, one thread per processor is used.
+    * Returns the number of objects created.
+    */
+   static size_t from_wkt_batch(
+      const char * const * wkts,
+      size_t               n,
+      ogc_object **        out,
+      ogc_error *          errs     = OGC_NULL,
+      int                  nthreads = 0);
+
+   /* Validate a WKT string.
+    *
+    * This does all the checks (and gives the same errors) that
+    * from_wkt() does, but nothing is allocated (after the first few
+    * strings), as the tokens are re-used and all objects are taken from
+    * scratch memory and then discarded without being destroyed.
+    *
+    * Without a context, this is not thread-safe.  With a context, the
+    * tokens and scratch memory of the context are used, so each thread
+    * may validate with its own context.
+    */
+   static bool validate_wkt(
+      const char * wkt,
+      ogc_error *  err = OGC_NULL);
+
+   static bool validate_wkt(
+      ogc_parse_ctx * ctx,
+      const char *    wkt,
+      ogc_error *     err = OGC_NULL);
+
    static bool to_wkt(
       const ogc_object * obj,
       char     buffer[],
@@ -917,6 +1801,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_object * obj,
+      ogc_wkt_writer &   w,
+      int                options = OGC_WKT_OPT_NONE);
+
+   virtual bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_object * clone(const ogc_object * obj);
           ogc_object * clone() const;
 
@@ -931,8 +1824,17 @@ public:
    ogc_obj_type         obj_type()   const { return _obj_type; }
    virtual const char * name()       const { return "";        }
    bool                 is_visible() const { return _visible;  }
-
-   void                 set_visible(bool val) { _visible = val; }
+   bool                 is_shared()  const { return _shared;   }
+
+   /* This does nothing (and returns false) for a shared object (see
+      ogc_share). */
+   bool                 set_visible(bool val)
+   {
+      if ( _shared )
+         return false;
+      _visible = val;
+      return true;
+   }
 };
 
 /* ------------------------------------------------------------------------- */
@@ -949,7 +1851,16 @@ private:
 
    ogc_vector() {}
 
+   static ogc_object ** alloc_array(int n);
+   static void          free_array (ogc_object ** array);
+
 public:
+   static void * operator new   (size_t size,
+                                 const std::nothrow_t &) OGC_NOTHROW;
+   static void   operator delete(void * p);
+   static void   operator delete(void * p,
+                                 const std::nothrow_t &) OGC_NOTHROW;
+
    static ogc_vector * create(
       int capacity,
       int increment);
@@ -991,7 +1902,7 @@ public:
 class OGC_EXPORT ogc_citation : public ogc_object
 {
 private:
-   OGC_TEXT _text;
+   const char * _text;
 
    ogc_citation() {}
 
@@ -1027,6 +1938,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_citation * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_citation * clone(const ogc_citation * obj);
           ogc_citation * clone() const;
 
@@ -1048,7 +1968,7 @@ public:
 class OGC_EXPORT ogc_uri : public ogc_object
 {
 private:
-   OGC_TEXT _text;
+   const char * _text;
 
    ogc_uri() {}
 
@@ -1084,6 +2004,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_uri *  obj,
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_uri * clone(const ogc_uri * obj);
           ogc_uri * clone() const;
 
@@ -1105,9 +2034,9 @@ public:
 class OGC_EXPORT ogc_id : public ogc_object
 {
 private:
-   OGC_NAME        _name;
-   OGC_TEXT        _identifier;
-   OGC_TEXT        _version;
+   const char *    _name;
+   const char *    _identifier;
+   const char *    _version;
    ogc_citation *  _citation;
    ogc_uri *       _uri;
 
@@ -1150,6 +2079,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_id *   obj,
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_id * clone(const ogc_id * obj);
           ogc_id * clone() const;
 
@@ -1175,7 +2113,7 @@ public:
 class OGC_EXPORT ogc_remark : public ogc_object
 {
 private:
-   OGC_UTF8_TEXT _text;
+   const char *  _text;
 
    ogc_remark() {}
 
@@ -1211,6 +2149,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_remark * obj,
+      ogc_wkt_writer &   w,
+      int                options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_remark * clone(const ogc_remark * obj);
           ogc_remark * clone() const;
 
@@ -1232,7 +2179,7 @@ public:
 class OGC_EXPORT ogc_unit : public ogc_object
 {
 protected:
-   OGC_NAME      _name;
+   const char *  _name;
    ogc_unit_type _unit_type;
    double        _factor;           /* number of SI units per unit */
                                     /* SI units are:               */
@@ -1279,6 +2226,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_unit * obj,
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_unit * clone(const ogc_unit * obj);
           ogc_unit * clone() const;
 
@@ -1343,6 +2299,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_angunit * obj,
+      ogc_wkt_writer &    w,
+      int                 options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_angunit * clone(const ogc_angunit * obj);
           ogc_angunit * clone() const;
 
@@ -1399,6 +2364,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_lenunit * obj,
+      ogc_wkt_writer &    w,
+      int                 options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_lenunit * clone(const ogc_lenunit * obj);
           ogc_lenunit * clone() const;
 
@@ -1455,6 +2429,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_scaleunit * obj,
+      ogc_wkt_writer &      w,
+      int                   options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_scaleunit * clone(const ogc_scaleunit * obj);
           ogc_scaleunit * clone() const;
 
@@ -1511,6 +2494,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_timeunit * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_timeunit * clone(const ogc_timeunit * obj);
           ogc_timeunit * clone() const;
 
@@ -1567,6 +2559,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_paramunit * obj,
+      ogc_wkt_writer &      w,
+      int                   options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_paramunit * clone(const ogc_paramunit * obj);
           ogc_paramunit * clone() const;
 
@@ -1586,7 +2587,7 @@ public:
 class OGC_EXPORT ogc_scope : public ogc_object
 {
 private:
-   OGC_TEXT _text;
+   const char * _text;
 
    ogc_scope() {}
 
@@ -1622,6 +2623,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_scope * obj,
+      ogc_wkt_writer &  w,
+      int               options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_scope * clone(const ogc_scope * obj);
           ogc_scope * clone() const;
 
@@ -1673,6 +2683,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_extent * obj,
+      ogc_wkt_writer &   w,
+      int                options = OGC_WKT_OPT_NONE);
+
+   virtual bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_extent * clone(const ogc_extent * obj);
           ogc_extent * clone() const;
 
@@ -1692,7 +2711,7 @@ public:
 class OGC_EXPORT ogc_area_extent : public ogc_extent
 {
 private:
-   OGC_TEXT _text;
+   const char * _text;
 
    ogc_area_extent() {}
 
@@ -1728,6 +2747,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_area_extent * obj,
+      ogc_wkt_writer &        w,
+      int                     options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_area_extent * clone(const ogc_area_extent * obj);
           ogc_area_extent * clone() const;
 
@@ -1791,6 +2819,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_bbox_extent * obj,
+      ogc_wkt_writer &        w,
+      int                     options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_bbox_extent * clone(const ogc_bbox_extent * obj);
           ogc_bbox_extent * clone() const;
 
@@ -1855,6 +2892,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_vert_extent * obj,
+      ogc_wkt_writer &        w,
+      int                     options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_vert_extent * clone(const ogc_vert_extent * obj);
           ogc_vert_extent * clone() const;
 
@@ -1916,6 +2962,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_time_extent * obj,
+      ogc_wkt_writer &        w,
+      int                     options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_time_extent * clone(const ogc_time_extent * obj);
           ogc_time_extent * clone() const;
 
@@ -1938,7 +2993,7 @@ public:
 class OGC_EXPORT ogc_parameter : public ogc_object
 {
 private:
-   OGC_NAME     _name;
+   const char * _name;
    double       _value;
    ogc_unit *   _unit;
    ogc_vector * _ids;
@@ -1980,6 +3035,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_parameter * obj,
+      ogc_wkt_writer &      w,
+      int                   options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_parameter * clone(const ogc_parameter * obj);
           ogc_parameter * clone() const;
 
@@ -2007,8 +3071,8 @@ public:
 class OGC_EXPORT ogc_param_file : public ogc_object
 {
 private:
-   OGC_NAME     _name;
-   OGC_PATH     _filename;
+   const char * _name;
+   const char * _filename;
    ogc_vector * _ids;
 
    ogc_param_file() {}
@@ -2047,6 +3111,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_param_file * obj,
+      ogc_wkt_writer &       w,
+      int                    options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_param_file * clone(const ogc_param_file * obj);
           ogc_param_file * clone() const;
 
@@ -2073,7 +3146,7 @@ public:
 class OGC_EXPORT ogc_ellipsoid : public ogc_object
 {
 private:
-   OGC_NAME      _name;
+   const char *  _name;
    double        _semi_major_axis;
    double        _flattening;
    ogc_lenunit * _lenunit;
@@ -2118,6 +3191,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_ellipsoid * obj,
+      ogc_wkt_writer &      w,
+      int                   options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_ellipsoid * clone(const ogc_ellipsoid * obj);
           ogc_ellipsoid * clone() const;
 
@@ -2152,7 +3234,7 @@ public:
 class OGC_EXPORT ogc_anchor : public ogc_object
 {
 private:
-   OGC_TEXT _text;
+   const char * _text;
 
    ogc_anchor() {}
 
@@ -2188,6 +3270,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_anchor * obj,
+      ogc_wkt_writer &   w,
+      int                options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_anchor * clone(const ogc_anchor * obj);
           ogc_anchor * clone() const;
 
@@ -2245,6 +3336,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_time_origin * obj,
+      ogc_wkt_writer &        w,
+      int                     options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_time_origin * clone(const ogc_time_origin * obj);
           ogc_time_origin * clone() const;
 
@@ -2266,7 +3366,7 @@ public:
 class OGC_EXPORT ogc_datum : public ogc_object
 {
 protected:
-   OGC_NAME       _name;
+   const char *   _name;
    ogc_datum_type _datum_type;
    ogc_anchor *   _anchor;
    ogc_vector *   _ids;
@@ -2301,6 +3401,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_datum * obj,
+      ogc_wkt_writer &  w,
+      int               options = OGC_WKT_OPT_NONE);
+
+   virtual bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_datum * clone(const ogc_datum * obj);
           ogc_datum * clone() const;
 
@@ -2368,6 +3477,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_geod_datum * obj,
+      ogc_wkt_writer &       w,
+      int                    options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_geod_datum * clone(const ogc_geod_datum * obj);
           ogc_geod_datum * clone() const;
 
@@ -2427,6 +3545,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_engr_datum * obj,
+      ogc_wkt_writer &       w,
+      int                    options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_engr_datum * clone(const ogc_engr_datum * obj);
           ogc_engr_datum * clone() const;
 
@@ -2486,6 +3613,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_image_datum * obj,
+      ogc_wkt_writer &        w,
+      int                     options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_image_datum * clone(const ogc_image_datum * obj);
           ogc_image_datum * clone() const;
 
@@ -2544,6 +3680,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_param_datum * obj,
+      ogc_wkt_writer &        w,
+      int                     options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_param_datum * clone(const ogc_param_datum * obj);
           ogc_param_datum * clone() const;
 
@@ -2600,6 +3745,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_time_datum * obj,
+      ogc_wkt_writer &       w,
+      int                    options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_time_datum * clone(const ogc_time_datum * obj);
           ogc_time_datum * clone() const;
 
@@ -2657,6 +3811,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_vert_datum * obj,
+      ogc_wkt_writer &       w,
+      int                    options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_vert_datum * clone(const ogc_vert_datum * obj);
           ogc_vert_datum * clone() const;
 
@@ -2676,7 +3839,7 @@ public:
 class OGC_EXPORT ogc_primem : public ogc_object
 {
 private:
-   OGC_NAME      _name;
+   const char *  _name;
    double        _longitude;
    ogc_angunit * _angunit;
    ogc_vector *  _ids;
@@ -2719,6 +3882,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_primem * obj,
+      ogc_wkt_writer &   w,
+      int                options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_primem * clone(const ogc_primem * obj);
           ogc_primem * clone() const;
 
@@ -2792,6 +3964,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_bearing * obj,
+      ogc_wkt_writer &    w,
+      int                 options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_bearing * clone(const ogc_bearing * obj);
           ogc_bearing * clone() const;
 
@@ -2852,6 +4033,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_meridian * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_meridian * clone(const ogc_meridian * obj);
           ogc_meridian * clone() const;
 
@@ -2910,6 +4100,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_order * obj,
+      ogc_wkt_writer &  w,
+      int               options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_order * clone(const ogc_order * obj);
           ogc_order * clone() const;
 
@@ -2931,8 +4130,8 @@ public:
 class OGC_EXPORT ogc_axis : public ogc_object
 {
 private:
-   OGC_NAME           _name;
-   OGC_NAME           _abbr;
+   const char *       _name;
+   const char *       _abbr;
    ogc_axis_direction _direction;
    ogc_bearing *      _bearing;
    ogc_meridian *     _meridian;
@@ -2981,6 +4180,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_axis * obj,
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_axis * clone(const ogc_axis * obj);
           ogc_axis * clone() const;
 
@@ -3060,6 +4268,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_cs *   obj,
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_cs * clone(const ogc_cs * obj);
           ogc_cs * clone() const;
 
@@ -3086,7 +4303,7 @@ public:
 class OGC_EXPORT ogc_method : public ogc_object
 {
 private:
-   OGC_NAME     _name;
+   const char * _name;
    ogc_vector * _ids;
 
    ogc_method() {}
@@ -3125,6 +4342,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_method * obj,
+      ogc_wkt_writer &   w,
+      int                options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_method * clone(const ogc_method * obj);
           ogc_method * clone() const;
 
@@ -3154,6 +4380,15 @@ public:
       char     buffer[],
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
+
+   static bool to_wkt_projection(
+      const ogc_method * obj,
+      ogc_wkt_writer &   w,
+      int                options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt_projection(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
 };
 
 /* ------------------------------------------------------------------------- */
@@ -3163,7 +4398,7 @@ public:
 class OGC_EXPORT ogc_conversion : public ogc_object
 {
 private:
-   OGC_NAME     _name;
+   const char * _name;
    ogc_method * _method;
    ogc_vector * _parameters;
    ogc_vector * _ids;
@@ -3205,6 +4440,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_conversion * obj,
+      ogc_wkt_writer &       w,
+      int                    options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_conversion * clone(const ogc_conversion * obj);
           ogc_conversion * clone() const;
 
@@ -3235,7 +4479,7 @@ public:
 class OGC_EXPORT ogc_deriving_conv : public ogc_object
 {
 private:
-   OGC_NAME     _name;
+   const char * _name;
    ogc_method * _method;
    ogc_vector * _parameters;
    ogc_vector * _param_files;
@@ -3279,6 +4523,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_deriving_conv * obj,
+      ogc_wkt_writer &          w,
+      int                       options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_deriving_conv * clone(const ogc_deriving_conv * obj);
           ogc_deriving_conv * clone() const;
 
@@ -3313,7 +4566,7 @@ public:
 class OGC_EXPORT ogc_crs : public ogc_object
 {
 protected:
-   OGC_NAME     _name;
+   const char * _name;
    ogc_crs_type _crs_type;
    ogc_cs *     _cs;
    ogc_axis *   _axis_1;
@@ -3355,6 +4608,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_crs *  obj,
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE);
+
+   virtual bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_crs * clone(const ogc_crs * obj);
           ogc_crs * clone() const;
 
@@ -3469,6 +4731,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_geod_crs * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_geod_crs * clone(const ogc_geod_crs * obj);
           ogc_geod_crs * clone() const;
 
@@ -3531,6 +4802,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_base_geod_crs * obj,
+      ogc_wkt_writer &          w,
+      int                       options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_base_geod_crs * clone(const ogc_base_geod_crs * obj);
           ogc_base_geod_crs * clone() const;
 
@@ -3607,6 +4887,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_proj_crs * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_proj_crs * clone(const ogc_proj_crs * obj);
           ogc_proj_crs * clone() const;
 
@@ -3667,6 +4956,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_base_proj_crs * obj,
+      ogc_wkt_writer &          w,
+      int                       options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_base_proj_crs * clone(const ogc_base_proj_crs * obj);
           ogc_base_proj_crs * clone() const;
 
@@ -3755,6 +5053,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_vert_crs * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_vert_crs * clone(const ogc_vert_crs * obj);
           ogc_vert_crs * clone() const;
 
@@ -3815,6 +5122,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_base_vert_crs * obj,
+      ogc_wkt_writer &          w,
+      int                       options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_base_vert_crs * clone(const ogc_base_vert_crs * obj);
           ogc_base_vert_crs * clone() const;
 
@@ -3905,6 +5221,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_engr_crs * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_engr_crs * clone(const ogc_engr_crs * obj);
           ogc_engr_crs * clone() const;
 
@@ -3965,6 +5290,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_base_engr_crs * obj,
+      ogc_wkt_writer &          w,
+      int                       options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_base_engr_crs * clone(const ogc_base_engr_crs * obj);
           ogc_base_engr_crs * clone() const;
 
@@ -4029,6 +5363,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_image_crs * obj,
+      ogc_wkt_writer &      w,
+      int                   options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_image_crs * clone(const ogc_image_crs * obj);
           ogc_image_crs * clone() const;
 
@@ -4111,6 +5454,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_time_crs * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_time_crs * clone(const ogc_time_crs * obj);
           ogc_time_crs * clone() const;
 
@@ -4171,6 +5523,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_base_time_crs * obj,
+      ogc_wkt_writer &          w,
+      int                       options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_base_time_crs * clone(const ogc_base_time_crs * obj);
           ogc_base_time_crs * clone() const;
 
@@ -4251,6 +5612,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_param_crs * obj,
+      ogc_wkt_writer &      w,
+      int                   options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_param_crs * clone(const ogc_param_crs * obj);
           ogc_param_crs * clone() const;
 
@@ -4311,6 +5681,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_base_param_crs * obj,
+      ogc_wkt_writer &           w,
+      int                        options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_base_param_crs * clone(const ogc_base_param_crs * obj);
           ogc_base_param_crs * clone() const;
 
@@ -4380,6 +5759,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_compound_crs * obj,
+      ogc_wkt_writer &         w,
+      int                      options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_compound_crs * clone(const ogc_compound_crs * obj);
           ogc_compound_crs * clone() const;
 
@@ -4439,6 +5827,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_op_accuracy * obj,
+      ogc_wkt_writer &        w,
+      int                     options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_op_accuracy * clone(const ogc_op_accuracy * obj);
           ogc_op_accuracy * clone() const;
 
@@ -4460,7 +5857,7 @@ public:
 class OGC_EXPORT ogc_coord_op : public ogc_object
 {
 private:
-   OGC_NAME          _name;
+   const char *      _name;
    ogc_crs *         _source_crs;
    ogc_crs *         _target_crs;
    ogc_crs *         _interp_crs;
@@ -4518,6 +5915,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_coord_op * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_coord_op * clone(const ogc_coord_op * obj);
           ogc_coord_op * clone() const;
 
@@ -4562,7 +5968,7 @@ public:
 class OGC_EXPORT ogc_abrtrans : public ogc_object
 {
 private:
-   OGC_NAME     _name;
+   const char * _name;
    ogc_method * _method;
    ogc_vector * _parameters;
    ogc_vector * _param_files;
@@ -4612,6 +6018,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_abrtrans * obj,
+      ogc_wkt_writer &     w,
+      int                  options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_abrtrans * clone(const ogc_abrtrans * obj);
           ogc_abrtrans * clone() const;
 
@@ -4696,6 +6111,15 @@ public:
       int      options = OGC_WKT_OPT_NONE,
       size_t   buflen  = OGC_BUFF_MAX) const;
 
+   static bool to_wkt(
+      const ogc_bound_crs * obj,
+      ogc_wkt_writer &      w,
+      int                   options = OGC_WKT_OPT_NONE);
+
+   bool to_wkt(
+      ogc_wkt_writer & w,
+      int              options = OGC_WKT_OPT_NONE) const;
+
    static ogc_bound_crs * clone(const ogc_bound_crs * obj);
           ogc_bound_crs * clone() const;
 
@@ -4717,6 +6141,91 @@ public:
    ogc_id *         id(int n)         const;
 };
 
+/* ------------------------------------------------------------------------- */
+/* Lazily-built object                                                       */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * An ogc_lazy_object is parsed from a WKT string without building any
+ * objects.  The string is tokenized (and so fully checked for syntax),
+ * and the tokens are kept, so the object type, name (which is empty for
+ * an object that has none), and IDs can be looked up directly from them.
+ *
+ * Each child (top-level sub-object, such as the datum, CS, or ID of a
+ * CRS) is only built the first time it is asked for, and the whole object
+ * is only built by object().  A child that is never asked for is never
+ * allocated.  Any error in a child (other than a syntax error) is only
+ * reported when it is built, and a child that can't be built is tried
+ * again (and the error reported again) each time it is asked for.
+ *
+ * All objects built are owned by the lazy object, and are deleted with
+ * it.
+ *
+ * If it is parsed with a parse context, the context is also used when
+ * building, so it must last as long as the lazy object.
+ */
+class OGC_EXPORT ogc_lazy_object
+{
+private:
+   ogc_token     _token;
+   OGC_NAME      _name;
+   ogc_object *  _obj;     /* whole object (once built)     */
+   ogc_object ** _kids;    /* children (once any is built)  */
+   int           _nkids;   /* number of children            */
+
+   ogc_lazy_object();
+
+   int kid_index(int n) const;
+
+   static ogc_lazy_object * parse(
+      ogc_parse_ctx * ctx,
+      const char *    wkt,
+      ogc_error *     err);
+
+public:
+   static void * operator new   (size_t size,
+                                 const std::nothrow_t &) OGC_NOTHROW;
+   static void   operator delete(void * p);
+   static void   operator delete(void * p,
+                                 const std::nothrow_t &) OGC_NOTHROW;
+
+   ~ogc_lazy_object();
+   static ogc_lazy_object * destroy(ogc_lazy_object * obj);
+
+   static ogc_lazy_object * from_wkt(
+      const char * wkt,
+      ogc_error *  err = OGC_NULL);
+
+   static ogc_lazy_object * from_wkt(
+      ogc_parse_ctx * ctx,
+      const char *    wkt,
+      ogc_error *     err = OGC_NULL);
+
+   ogc_obj_type obj_type()          const;
+   const char * name()              const { return _name;  }
+
+   int          child_count()       const { return _nkids; }
+   ogc_obj_type child_type(int n)   const;
+
+   ogc_object * child(
+      int          n,
+      ogc_error *  err = OGC_NULL);
+
+   /* nth child of the given type */
+   ogc_object * find(
+      ogc_obj_type type,
+      int          n   = 0,
+      ogc_error *  err = OGC_NULL);
+
+   int          id_count()          const;
+   ogc_id *     id(
+      int          n,
+      ogc_error *  err = OGC_NULL);
+
+   ogc_object * object(
+      ogc_error *  err = OGC_NULL);
+};
+
 /* ------------------------------------------------------------------------- */
 /* string functions                                                          */
 /* ------------------------------------------------------------------------- */
@@ -4735,7 +6244,12 @@ public:
    static bool   is_numeric    (const char * str);
 
    static int    atoi          (const char * str);
+   /* Locale-independent and correctly rounded (see ogc_atod.cpp).
+      The 2nd form reads at most len chars, and gives the number of
+      chars used in plen (0 if the string doesn't start with a number). */
    static double atod          (const char * str);
+   static double atod          (const char * str, size_t len,
+                                size_t * plen = OGC_NULL);
 
    static char * itoa          (int    n, OGC_NBUF buf);
    static char * dtoa          (double d, OGC_NBUF buf);
@@ -4753,7 +6267,7 @@ public:
    static int    strcmp_ci     (const char * s1, const char * s2);
 
    static bool   is_equal      (const char * s1, const char * s2)
-                               { return (strcmp_ci(s1, s2) == 0); }
+                               { return (s1 == s2 || strcmp_ci(s1, s2) == 0); }
 
    static int    strupr        (char * buf, const char * str);
    static int    strlwr        (char * buf, const char * str);
@@ -4773,6 +6287,105 @@ public:
    static int    unescape_len  (const char * str);
 };
 
+/* ------------------------------------------------------------------------- */
+/* string interning                                                          */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * The intern table keeps one copy of each string added to it, so when it
+ * is turned on, objects share the copy of their names (of objects, of
+ * ID authorities, of units, of axis abbreviations, ...) rather than each
+ * keeping its own.  As the same few hundred names appear again and again
+ * in a set of CRSs (every "WGS 84", "EPSG", "degree", "metre", ...),
+ * this can save much of the memory of a big set of objects.
+ *
+ * Since an interned name is kept just once, two names that were both
+ * interned are the same string if they have the same address, which
+ * ogc_string::is_equal() checks before comparing them.
+ *
+ * The table is shared by all threads, and looking up a string takes no
+ * lock.  Strings are never removed from it (they are owned by the table,
+ * not by any allocator, and are kept until the program ends), so it
+ * should only be turned on for a program that keeps many objects whose
+ * names come from a limited set.  It is off by default.
+ */
+class OGC_EXPORT ogc_intern
+{
+private:
+    ogc_intern() {}
+   ~ogc_intern() {}
+
+public:
+   /* Turn interning of names by objects on or off, returning the
+      setting before. */
+   static bool set_enabled(bool on_off);
+
+   static bool enabled();
+
+   /* Get the table's copy of a string, adding it if it isn't there.
+      NULL is returned if the string is longer than a name can be or if
+      there is no memory for it. */
+   static const char * add(const char * str);
+
+   /* Get the table's copy of a string (NULL if it isn't there). */
+   static const char * find(const char * str);
+
+   /* statistics */
+   static size_t count();   /* number of strings in the table */
+   static size_t bytes();   /* total memory held by the table */
+};
+
+/* ------------------------------------------------------------------------- */
+/* sharing of sub-objects                                                    */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * When sharing is turned on, the ellipsoids, prime meridians, units,
+ * coordinate systems and methods that objects are built with when
+ * parsing or cloning are shared: a sub-object identical to one already
+ * in use (with the same WKT) is destroyed, and the one in use is used in
+ * its place, and a clone has the same shared sub-objects as the object
+ * it is a clone of.  A shared object counts the objects that have it,
+ * and is only deleted when the last of them is destroyed, so the memory
+ * of a big set of CRSs goes with the number of distinct components, not
+ * with the number of CRSs.
+ *
+ * Sharing is off by default, and a program that turns it on takes on
+ * that a shared object is read-only: as other objects may have it, it
+ * must not be changed in any way, not even its IDs (through ids() or
+ * id()).  A sub-object that is_shared() can be cloned to get one that
+ * may be changed.  set_visible() does nothing to a shared object.  A
+ * sub-object passed to create() is never shared, and the objects
+ * returned by from_wkt() and clone() are never shared themselves, so
+ * they may be changed and deleted as usual.  Objects in scratch memory
+ * or in an arena are never shared.
+ *
+ * The table of shared objects is used by all threads (with a lock).
+ * It only holds the shared objects that are in use, and its entries and
+ * all memory of a shared object come from the allocator in use when it
+ * was created.  Objects are only shared with objects made with the same
+ * allocator (as with a parse context that has its own allocator), so an
+ * allocator may be deleted once all objects made with it are, as usual.
+ */
+class OGC_EXPORT ogc_share
+{
+private:
+    ogc_share() {}
+   ~ogc_share() {}
+
+public:
+   /* Turn sharing of sub-objects on or off, returning the setting
+      before.  Objects already created are not changed. */
+   static bool set_enabled(bool on_off);
+
+   static bool enabled();
+
+   /* statistics */
+   static size_t count();   /* number of shared objects in use        */
+   static size_t refs();    /* number of objects that have them       */
+   static size_t bytes();   /* memory held by the table (not objects) */
+};
+
 /* ------------------------------------------------------------------------- */
 /* date/time methods                                                         */
 /* ------------------------------------------------------------------------- */
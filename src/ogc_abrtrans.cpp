@@ -74,14 +74,18 @@ ogc_abrtrans * ogc_abrtrans :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_abrtrans();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_abrtrans();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type    = OGC_OBJ_TYPE_ABRTRANS;
       p->_visible     = true;
       p->_method      = method;
@@ -132,10 +136,8 @@ ogc_abrtrans * ogc_abrtrans :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_abrtrans *   obj         = OGC_NULL;
    ogc_method *     method      = OGC_NULL;
@@ -166,35 +168,24 @@ ogc_abrtrans * ogc_abrtrans :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_ABRTRANS )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: ABRTRANS[ "name" ...
@@ -205,7 +196,7 @@ ogc_abrtrans * ogc_abrtrans :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -217,7 +208,7 @@ ogc_abrtrans * ogc_abrtrans :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name = arr[start++].str;
+   name = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -225,247 +216,238 @@ ogc_abrtrans * ogc_abrtrans :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_method::is_kwd(arr[i].str) )
-      {
-         if ( method != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_METHOD, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            method = ogc_method::from_tokens(t, i, &next, err);
-            if ( method == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_parameter::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         param = ogc_parameter::from_tokens(t, i, &next, err);
-         if ( param == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( parameters == OGC_NULL )
+         case OGC_OBJ_TYPE_METHOD:
+            if ( method != OGC_NULL )
             {
-               parameters = ogc_vector::create(1, 1);
-               if ( parameters == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete param;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_METHOD, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               method = ogc_method::from_tokens(t, i, &next, err);
+               if ( method == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( parameters != OGC_NULL )
+         case OGC_OBJ_TYPE_PARAMETER:
+            param = ogc_parameter::from_tokens(t, i, &next, err);
+            if ( param == OGC_NULL )
             {
-               void * p = parameters->find(
-                             param,
-                             false,
-                             ogc_utils::compare_parameter);
-               if ( p != OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAMETER,
-                     obj_kwd(), param->name());
-                  delete param;
-                  bad = true;
-               }
-               else
+               bad = true;
+            }
+            else
+            {
+               if ( parameters == OGC_NULL )
                {
-                  if ( parameters->add( param ) < 0 )
+                  parameters = ogc_vector::create(1, 1);
+                  if ( parameters == OGC_NULL )
                   {
                      ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
                      delete param;
                      bad = true;
                   }
                }
-            }
-         }
-         continue;
-      }
 
-      if ( ogc_param_file::is_kwd(arr[i].str) )
-      {
-         param_file = ogc_param_file::from_tokens(t, i, &next, err);
-         if ( param_file == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( param_files == OGC_NULL )
-            {
-               param_files = ogc_vector::create(1, 1);
-               if ( param_files == OGC_NULL )
+               if ( parameters != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete param_file;
-                  bad = true;
+                  void * p = parameters->find(
+                                param,
+                                false,
+                                ogc_utils::compare_parameter);
+                  if ( p != OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAMETER,
+                        obj_kwd(), param->name());
+                     delete param;
+                     bad = true;
+                  }
+                  else
+                  {
+                     if ( parameters->add( param ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete param;
+                        bad = true;
+                     }
+                  }
                }
             }
+            break;
 
-            if ( param_files != OGC_NULL )
+         case OGC_OBJ_TYPE_PARAM_FILE:
+            param_file = ogc_param_file::from_tokens(t, i, &next, err);
+            if ( param_file == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = param_files->find(
-                             param_file,
-                             false,
-                             ogc_utils::compare_param_file);
-               if ( p != OGC_NULL )
+               if ( param_files == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAM_FILE,
-                     obj_kwd(), param_file->name());
-                  delete param_file;
-                  bad = true;
+                  param_files = ogc_vector::create(1, 1);
+                  if ( param_files == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete param_file;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( param_files != OGC_NULL )
                {
-                  if ( param_files->add( param_file ) < 0 )
+                  void * p = param_files->find(
+                                param_file,
+                                false,
+                                ogc_utils::compare_param_file);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAM_FILE,
+                        obj_kwd(), param_file->name());
                      delete param_file;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( param_files->add( param_file ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete param_file;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      if ( ogc_scope::is_kwd(arr[i].str) )
-      {
-         if ( scope != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SCOPE, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            scope = ogc_scope::from_tokens(t, i, &next, err);
-            if ( scope == OGC_NULL )
+         case OGC_OBJ_TYPE_SCOPE:
+            if ( scope != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SCOPE, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
-
-      if ( ogc_extent::is_kwd(arr[i].str) )
-      {
-         extent = ogc_extent::from_tokens(t, i, &next, err);
-         if ( extent == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( extents == OGC_NULL )
+            }
+            else
             {
-               extents = ogc_vector::create(1, 1);
-               if ( extents == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete extent;
+               scope = ogc_scope::from_tokens(t, i, &next, err);
+               if ( scope == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( extents != OGC_NULL )
+         case OGC_OBJ_TYPE_AREA_EXTENT:
+         case OGC_OBJ_TYPE_BBOX_EXTENT:
+         case OGC_OBJ_TYPE_TIME_EXTENT:
+         case OGC_OBJ_TYPE_VERT_EXTENT:
+            extent = ogc_extent::from_tokens(t, i, &next, err);
+            if ( extent == OGC_NULL )
             {
-               void * p = extents->find(
-                             extent,
-                             false,
-                             ogc_utils::compare_extent);
-               if ( p != OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_EXTENT,
-                     obj_kwd(),
-                     ogc_utils::obj_type_to_kwd(extent->obj_type()));
-                  delete extent;
-                  bad = true;
-               }
-               else
+               bad = true;
+            }
+            else
+            {
+               if ( extents == OGC_NULL )
                {
-                  if ( extents->add( extent ) < 0 )
+                  extents = ogc_vector::create(1, 1);
+                  if ( extents == OGC_NULL )
                   {
                      ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
                      delete extent;
                      bad = true;
                   }
                }
-            }
-         }
-         continue;
-      }
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
-            {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
+               if ( extents != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
-                  bad = true;
+                  void * p = extents->find(
+                                extent,
+                                false,
+                                ogc_utils::compare_extent);
+                  if ( p != OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_EXTENT,
+                        obj_kwd(),
+                        ogc_utils::obj_type_to_kwd(extent->obj_type()));
+                     delete extent;
+                     bad = true;
+                  }
+                  else
+                  {
+                     if ( extents->add( extent ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete extent;
+                        bad = true;
+                     }
+                  }
                }
             }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      if ( ogc_remark::is_kwd(arr[i].str) )
-      {
-         if ( remark != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            remark = ogc_remark::from_tokens(t, i, &next, err);
-            if ( remark == OGC_NULL )
+         case OGC_OBJ_TYPE_REMARK:
+            if ( remark != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               remark = ogc_remark::from_tokens(t, i, &next, err);
+               if ( remark == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -475,6 +457,8 @@ ogc_abrtrans * ogc_abrtrans :: from_tokens(
     */
    if ( !bad )
    {
+      method = ogc_share_obj(method);
+
       obj = create(name, method, parameters, param_files,
                    scope, extents, ids, remark, err);
    }
@@ -501,7 +485,7 @@ ogc_abrtrans * ogc_abrtrans :: from_wkt(
    ogc_error *  err)
 {
    ogc_abrtrans * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -535,58 +519,52 @@ bool ogc_abrtrans :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_method;
-   OGC_TBUF      buf_parameter;
-   OGC_TBUF      buf_scope;
-   OGC_TBUF      buf_extent;
-   OGC_TBUF      buf_id;
-   OGC_TBUF      buf_remark;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_abrtrans :: to_wkt(
+   const ogc_abrtrans * obj,
+   ogc_wkt_writer &     w,
+   int                  options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_abrtrans :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       return true;
 
-   rc &= ogc_method :: to_wkt(_method, buf_method,         opts, OGC_TBUF_MAX);
-   rc &= ogc_scope  :: to_wkt(_scope,  buf_scope,          opts, OGC_TBUF_MAX);
-   rc &= ogc_remark :: to_wkt(_remark, buf_remark,         opts, OGC_TBUF_MAX);
-
-   ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\"",
-      kwd, opn, buf_name);
-
-   OGC_CPY_TO_BUF( buf_hdr    );
-   OGC_ADD_TO_BUF( buf_method );
+   w.open(kwd, options);
+   w.put_str(_name);
+   rc &= ogc_method :: to_wkt(_method, w, opts);
 
    if ( _parameters != OGC_NULL )
    {
       for (int i = 0; i < parameter_count(); i++)
       {
-         rc &= ogc_parameter :: to_wkt(parameter(i),
-                                       buf_parameter, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_parameter );
+         rc &= ogc_parameter :: to_wkt(parameter(i), w, opts);
       }
    }
 
@@ -594,21 +572,17 @@ bool ogc_abrtrans :: to_wkt(
    {
       for (int i = 0; i < param_file_count(); i++)
       {
-         rc &= ogc_param_file :: to_wkt(param_file(i),
-                                        buf_parameter, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_parameter );
+         rc &= ogc_param_file :: to_wkt(param_file(i), w, opts);
       }
    }
 
-   OGC_ADD_TO_BUF( buf_scope );
+   rc &= ogc_scope :: to_wkt(_scope, w, opts);
 
    if ( _extents != OGC_NULL )
    {
       for (int i = 0; i < extent_count(); i++)
       {
-         rc &= ogc_extent :: to_wkt(extent(i),
-                                    buf_extent, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_extent );
+         rc &= ogc_extent :: to_wkt(extent(i), w, opts);
       }
    }
 
@@ -616,19 +590,12 @@ bool ogc_abrtrans :: to_wkt(
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
       }
    }
 
-   OGC_ADD_TO_BUF( buf_remark );
-   OGC_CPY_TO_BUF( cls        );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   rc &= ogc_remark :: to_wkt(_remark, w, opts);
+   w.close(options);
 
    return rc;
 }
@@ -645,7 +612,7 @@ ogc_abrtrans * ogc_abrtrans :: clone(const ogc_abrtrans * obj)
 
 ogc_abrtrans * ogc_abrtrans :: clone() const
 {
-   ogc_method * method      = ogc_method :: clone( _method      );
+   ogc_method * method      = ogc_share_clone( _method );
    ogc_vector * parameters  = ogc_vector :: clone( _parameters  );
    ogc_vector * param_files = ogc_vector :: clone( _param_files );
    ogc_scope *  scope       = ogc_scope  :: clone( _scope       );
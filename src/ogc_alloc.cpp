@@ -0,0 +1,267 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* memory allocation                                                         */
+/*                                                                           */
+/* Each piece of memory starts with a header giving the allocator it came    */
+/* from and its size, so it can be resized or freed without knowing which    */
+/* allocator was in use when it was allocated, and the counts can be kept    */
+/* right.  Scratch memory has the same header with a null allocator, so     */
+/* freeing it does nothing (see ogc_scratch.cpp).                            */
+/*                                                                           */
+/* The default allocator has null routines, which means the heap, so it     */
+/* works even before it is constructed (when other static objects are).     */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+/* the heap allocator, and the global allocator */
+static ogc_allocator   ogc_alloc_heap;
+static ogc_allocator * ogc_alloc_global = &ogc_alloc_heap;
+
+/* allocator of the parse context in use in this thread (if any) */
+static OGC_THREAD_LOCAL ogc_allocator * ogc_alloc_current = OGC_NULL;
+
+/*------------------------------------------------------------------------
+ * ALLOCATOR constructor (using the heap)
+ */
+ogc_allocator :: ogc_allocator()
+{
+   _alloc_rtn   = OGC_NULL;
+   _realloc_rtn = OGC_NULL;
+   _free_rtn    = OGC_NULL;
+   _data        = OGC_NULL;
+   _num_allocs  = 0;
+   _num_frees   = 0;
+   _bytes       = 0;
+   _bytes_total = 0;
+   _counting    = false;
+}
+
+/*------------------------------------------------------------------------
+ * ALLOCATOR constructor (using the given routines)
+ */
+ogc_allocator :: ogc_allocator(
+   OGC_ALLOC_RTN *   alloc_rtn,
+   OGC_REALLOC_RTN * realloc_rtn,
+   OGC_FREE_RTN *    free_rtn,
+   void *            data)
+{
+   /* both alloc and free are needed, or else the heap is used */
+   if ( alloc_rtn == OGC_NULL || free_rtn == OGC_NULL )
+   {
+      alloc_rtn   = OGC_NULL;
+      realloc_rtn = OGC_NULL;
+      free_rtn    = OGC_NULL;
+   }
+
+   _alloc_rtn   = alloc_rtn;
+   _realloc_rtn = realloc_rtn;
+   _free_rtn    = free_rtn;
+   _data        = data;
+   _num_allocs  = 0;
+   _num_frees   = 0;
+   _bytes       = 0;
+   _bytes_total = 0;
+   _counting    = false;
+}
+
+/*------------------------------------------------------------------------
+ * ALLOCATOR destructor
+ */
+ogc_allocator :: ~ogc_allocator()
+{
+   if ( ogc_alloc_global == this )
+      ogc_alloc_global = &ogc_alloc_heap;
+}
+
+/*------------------------------------------------------------------------
+ * set the global allocator
+ */
+ogc_allocator * ogc_allocator :: set_global(ogc_allocator * a)
+{
+   ogc_allocator * rc = ogc_alloc_global;
+   ogc_alloc_global = (a == OGC_NULL) ? &ogc_alloc_heap : a;
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * get the global allocator
+ */
+ogc_allocator * ogc_allocator :: global()
+{
+   return ogc_alloc_global;
+}
+
+/*------------------------------------------------------------------------
+ * get the allocator in use in this thread
+ */
+ogc_allocator * ogc_allocator :: current()
+{
+   ogc_allocator * a = ogc_alloc_current;
+   return (a != OGC_NULL) ? a : ogc_alloc_global;
+}
+
+/*------------------------------------------------------------------------
+ * internal use an allocator in this thread (null for the global one),
+ * returning the one in use before
+ */
+ogc_allocator * ogc_allocator :: use(ogc_allocator * a)
+{
+   ogc_allocator * rc = ogc_alloc_current;
+   ogc_alloc_current = a;
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * allocate memory
+ */
+void * ogc_allocator :: alloc(size_t size)
+{
+   size_t          n = OGC_ALLOC_HDR + size;
+   ogc_alloc_hdr * h;
+
+   if ( _alloc_rtn == OGC_NULL )
+      h = static_cast<ogc_alloc_hdr *>( ::malloc(n) );
+   else
+      h = static_cast<ogc_alloc_hdr *>( _alloc_rtn(_data, n) );
+
+   if ( h == OGC_NULL )
+      return OGC_NULL;
+
+   h->alloc   = this;
+   h->size    = size;
+   h->counted = _counting;
+
+   if ( _counting )
+   {
+      ogc_thread::atomic_add(&_num_allocs,  1);
+      ogc_thread::atomic_add(&_bytes,       size);
+      ogc_thread::atomic_add(&_bytes_total, size);
+   }
+
+   return reinterpret_cast<char *>(h) + OGC_ALLOC_HDR;
+}
+
+/*------------------------------------------------------------------------
+ * resize memory
+ *
+ * Memory that can't be resized where it is (scratch memory, or memory
+ * from an allocator with no realloc routine) is moved to new memory.
+ */
+void * ogc_allocator :: realloc(
+   void * p,
+   size_t size)
+{
+   ogc_alloc_hdr * h;
+   ogc_allocator * a;
+   size_t          old;
+   void *          q;
+
+   if ( p == OGC_NULL )
+      return current()->alloc(size);
+
+   h   = reinterpret_cast<ogc_alloc_hdr *>(static_cast<char *>(p) -
+                                           OGC_ALLOC_HDR);
+   a   = h->alloc;
+   old = h->size;
+
+   if ( a == OGC_NULL || (a->_alloc_rtn != OGC_NULL &&
+                          a->_realloc_rtn == OGC_NULL) )
+   {
+      q = ((a == OGC_NULL) ? current() : a)->alloc(size);
+      if ( q == OGC_NULL )
+         return OGC_NULL;
+
+      memcpy(q, p, (old < size) ? old : size);
+      free(p);
+      return q;
+   }
+
+   if ( a->_realloc_rtn == OGC_NULL )
+      h = static_cast<ogc_alloc_hdr *>( ::realloc(h, OGC_ALLOC_HDR + size) );
+   else
+      h = static_cast<ogc_alloc_hdr *>( a->_realloc_rtn(a->_data, h,
+                                                     OGC_ALLOC_HDR + size) );
+
+   if ( h == OGC_NULL )
+      return OGC_NULL;
+
+   h->size = size;
+
+   if ( h->counted )
+   {
+      ogc_thread::atomic_add(&a->_bytes, size - old);
+      if ( size > old )
+         ogc_thread::atomic_add(&a->_bytes_total, size - old);
+   }
+
+   return reinterpret_cast<char *>(h) + OGC_ALLOC_HDR;
+}
+
+/*------------------------------------------------------------------------
+ * free memory (to the allocator it came from)
+ */
+void ogc_allocator :: free(void * p)
+{
+   ogc_alloc_hdr * h;
+   ogc_allocator * a;
+
+   if ( p == OGC_NULL )
+      return;
+
+   h = reinterpret_cast<ogc_alloc_hdr *>(static_cast<char *>(p) -
+                                         OGC_ALLOC_HDR);
+   a = h->alloc;
+   if ( a == OGC_NULL )
+      return;
+
+   if ( h->counted )
+   {
+      ogc_thread::atomic_add(&a->_num_frees, 1);
+      ogc_thread::atomic_add(&a->_bytes,     0 - h->size);
+   }
+
+   if ( a->_free_rtn == OGC_NULL )
+      ::free(h);
+   else
+      a->_free_rtn(a->_data, h);
+}
+
+/*------------------------------------------------------------------------
+ * turn counting on or off
+ */
+bool ogc_allocator :: set_counting(bool on_off)
+{
+   bool rc = _counting;
+   _counting = on_off;
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * reset the counts
+ */
+void ogc_allocator :: reset_counts()
+{
+   _num_allocs  = 0;
+   _num_frees   = 0;
+   _bytes_total = 0;
+}
+
+} /* namespace OGC */
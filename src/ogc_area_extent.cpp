@@ -61,14 +61,18 @@ ogc_area_extent * ogc_area_extent :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_area_extent();
+      ogc_str_pool strs;
+
+      strs.need(text);
+      p = new (strs.size(), std::nothrow) ogc_area_extent();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_text, text, OGC_TEXT_MAX);
+      strs.begin(p);
+      p->_text = strs.add(text);
       p->_obj_type = OGC_OBJ_TYPE_AREA_EXTENT;
       p->_visible  = true;
    }
@@ -105,10 +109,8 @@ ogc_area_extent * ogc_area_extent :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_area_extent * obj = OGC_NULL;
    const char * text;
@@ -128,35 +130,24 @@ ogc_area_extent * ogc_area_extent :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_AREA_EXTENT )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: AREA[ "text" ...
@@ -167,7 +158,7 @@ ogc_area_extent * ogc_area_extent :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -179,7 +170,7 @@ ogc_area_extent * ogc_area_extent :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   text = arr[start++].str;
+   text = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -187,14 +178,7 @@ ogc_area_extent * ogc_area_extent :: from_tokens(
 #if 0 /* who cares? */
    int  next = 0;
    for (int i = start; i < end; i = next)
-   {
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
-            break;
-      }
-   }
+   {   }
 #endif
 
    /*---------------------------------------------------------
@@ -220,7 +204,7 @@ ogc_area_extent * ogc_area_extent :: from_wkt(
    ogc_error *  err)
 {
    ogc_area_extent * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -254,23 +238,32 @@ bool ogc_area_extent :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_TEXT buf_text;
-   OGC_TBUF      buf_hdr;
-   size_t        len   = 0;
-   bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
-   const char *  kwd   = obj_kwd();
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
+   return (rc && w.ok());
+}
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_area_extent :: to_wkt(
+   const ogc_area_extent * obj,
+   ogc_wkt_writer &        w,
+   int                     options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_area_extent :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
+   bool          rc    = true;
+   const char *  kwd   = obj_kwd();
 
    if ( !is_visible() )
       return true;
@@ -278,18 +271,9 @@ bool ogc_area_extent :: to_wkt(
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       return true;
 
-   ogc_string::escape_str(buf_text, _text, OGC_UTF8_TEXT_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\"",
-      kwd, opn, buf_text);
-
-   OGC_CPY_TO_BUF( buf_hdr );
-   OGC_CPY_TO_BUF( cls     );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.open(kwd, options);
+   w.put_str(_text);
+   w.close(options);
 
    return rc;
 }
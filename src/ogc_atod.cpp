@@ -0,0 +1,1378 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* number conversion                                                         */
+/*                                                                           */
+/* String to double:                                                         */
+/*                                                                           */
+/* A number is read as its first 19 significant digits (w) and a decimal     */
+/* exponent (q), always with '.' as the decimal point (whatever the locale). */
+/* It is then converted, correctly rounded, by the first of these that can:  */
+/*                                                                           */
+/*  1. If w fits in 53 bits and 10^|q| is exact (|q| <= 22), w is just       */
+/*     multiplied or divided by 10^|q|, which gives a single rounding.       */
+/*                                                                           */
+/*  2. Otherwise w is multiplied by a 128-bit approximation of 10^q, and     */
+/*     the result is used if its bits show that the rounding can't be off    */
+/*     (the Eisel-Lemire algorithm).  If digits were dropped, w+1 must then  */
+/*     give the same result, as the number is between the two.               */
+/*                                                                           */
+/*  3. Otherwise (which is very rare, such as for subnormal numbers or for   */
+/*     a number very close to half-way between two doubles), or if the       */
+/*     string isn't a plain decimal number (as for "inf" or hex numbers),    */
+/*     it is converted by strtod() as before.                                */
+/*                                                                           */
+/* Double to string:                                                         */
+/*                                                                           */
+/* The shortest decimal that converts back to the same double is found with  */
+/* the same table of powers of ten (the Schubfach algorithm), and its digits */
+/* are then written out directly, again always with a '.'.                   */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+#include <float.h>
+#include <math.h>
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace OGC {
+
+#define OGC_ATOD_DIGITS    19       /* most digits that fit in w     */
+#define OGC_ATOD_EXP_MAX   100000   /* larger exponents are clamped  */
+
+/*------------------------------------------------------------------------
+ * 128-bit approximations (rounded down) of the powers of ten from
+ * 10^OGC_POW10_MIN to 10^OGC_POW10_MAX, normalized so the top bit is
+ * set, as { high 64 bits, low 64 bits }
+ */
+#define OGC_POW10_MIN     (-348)
+#define OGC_POW10_MAX       347
+
+#define OGC_U64(hi, lo)   ((static_cast<ogc_uint64>(hi) << 32) | (lo))
+
+static const ogc_uint64 ogc_pow10_tbl[][2] =
+{
+   { OGC_U64(0xfa8fd5a0, 0x081c0288), OGC_U64(0x1732c869, 0xcd60e453) },
+   { OGC_U64(0x9c99e584, 0x05118195), OGC_U64(0x0e7fbd42, 0x205c8eb4) },
+   { OGC_U64(0xc3c05ee5, 0x0655e1fa), OGC_U64(0x521fac92, 0xa873b261) },
+   { OGC_U64(0xf4b0769e, 0x47eb5a78), OGC_U64(0xe6a797b7, 0x52909ef9) },
+   { OGC_U64(0x98ee4a22, 0xecf3188b), OGC_U64(0x9028bed2, 0x939a635c) },
+   { OGC_U64(0xbf29dcab, 0xa82fdeae), OGC_U64(0x7432ee87, 0x3880fc33) },
+   { OGC_U64(0xeef453d6, 0x923bd65a), OGC_U64(0x113faa29, 0x06a13b3f) },
+   { OGC_U64(0x9558b466, 0x1b6565f8), OGC_U64(0x4ac7ca59, 0xa424c507) },
+   { OGC_U64(0xbaaee17f, 0xa23ebf76), OGC_U64(0x5d79bcf0, 0x0d2df649) },
+   { OGC_U64(0xe95a99df, 0x8ace6f53), OGC_U64(0xf4d82c2c, 0x107973dc) },
+   { OGC_U64(0x91d8a02b, 0xb6c10594), OGC_U64(0x79071b9b, 0x8a4be869) },
+   { OGC_U64(0xb64ec836, 0xa47146f9), OGC_U64(0x9748e282, 0x6cdee284) },
+   { OGC_U64(0xe3e27a44, 0x4d8d98b7), OGC_U64(0xfd1b1b23, 0x08169b25) },
+   { OGC_U64(0x8e6d8c6a, 0xb0787f72), OGC_U64(0xfe30f0f5, 0xe50e20f7) },
+   { OGC_U64(0xb208ef85, 0x5c969f4f), OGC_U64(0xbdbd2d33, 0x5e51a935) },
+   { OGC_U64(0xde8b2b66, 0xb3bc4723), OGC_U64(0xad2c7880, 0x35e61382) },
+   { OGC_U64(0x8b16fb20, 0x3055ac76), OGC_U64(0x4c3bcb50, 0x21afcc31) },
+   { OGC_U64(0xaddcb9e8, 0x3c6b1793), OGC_U64(0xdf4abe24, 0x2a1bbf3d) },
+   { OGC_U64(0xd953e862, 0x4b85dd78), OGC_U64(0xd71d6dad, 0x34a2af0d) },
+   { OGC_U64(0x87d4713d, 0x6f33aa6b), OGC_U64(0x8672648c, 0x40e5ad68) },
+   { OGC_U64(0xa9c98d8c, 0xcb009506), OGC_U64(0x680efdaf, 0x511f18c2) },
+   { OGC_U64(0xd43bf0ef, 0xfdc0ba48), OGC_U64(0x0212bd1b, 0x2566def2) },
+   { OGC_U64(0x84a57695, 0xfe98746d), OGC_U64(0x014bb630, 0xf7604b57) },
+   { OGC_U64(0xa5ced43b, 0x7e3e9188), OGC_U64(0x419ea3bd, 0x35385e2d) },
+   { OGC_U64(0xcf42894a, 0x5dce35ea), OGC_U64(0x52064cac, 0x828675b9) },
+   { OGC_U64(0x818995ce, 0x7aa0e1b2), OGC_U64(0x7343efeb, 0xd1940993) },
+   { OGC_U64(0xa1ebfb42, 0x19491a1f), OGC_U64(0x1014ebe6, 0xc5f90bf8) },
+   { OGC_U64(0xca66fa12, 0x9f9b60a6), OGC_U64(0xd41a26e0, 0x77774ef6) },
+   { OGC_U64(0xfd00b897, 0x478238d0), OGC_U64(0x8920b098, 0x955522b4) },
+   { OGC_U64(0x9e20735e, 0x8cb16382), OGC_U64(0x55b46e5f, 0x5d5535b0) },
+   { OGC_U64(0xc5a89036, 0x2fddbc62), OGC_U64(0xeb2189f7, 0x34aa831d) },
+   { OGC_U64(0xf712b443, 0xbbd52b7b), OGC_U64(0xa5e9ec75, 0x01d523e4) },
+   { OGC_U64(0x9a6bb0aa, 0x55653b2d), OGC_U64(0x47b233c9, 0x2125366e) },
+   { OGC_U64(0xc1069cd4, 0xeabe89f8), OGC_U64(0x999ec0bb, 0x696e840a) },
+   { OGC_U64(0xf148440a, 0x256e2c76), OGC_U64(0xc00670ea, 0x43ca250d) },
+   { OGC_U64(0x96cd2a86, 0x5764dbca), OGC_U64(0x38040692, 0x6a5e5728) },
+   { OGC_U64(0xbc807527, 0xed3e12bc), OGC_U64(0xc6050837, 0x04f5ecf2) },
+   { OGC_U64(0xeba09271, 0xe88d976b), OGC_U64(0xf7864a44, 0xc633682e) },
+   { OGC_U64(0x93445b87, 0x31587ea3), OGC_U64(0x7ab3ee6a, 0xfbe0211d) },
+   { OGC_U64(0xb8157268, 0xfdae9e4c), OGC_U64(0x5960ea05, 0xbad82964) },
+   { OGC_U64(0xe61acf03, 0x3d1a45df), OGC_U64(0x6fb92487, 0x298e33bd) },
+   { OGC_U64(0x8fd0c162, 0x06306bab), OGC_U64(0xa5d3b6d4, 0x79f8e056) },
+   { OGC_U64(0xb3c4f1ba, 0x87bc8696), OGC_U64(0x8f48a489, 0x9877186c) },
+   { OGC_U64(0xe0b62e29, 0x29aba83c), OGC_U64(0x331acdab, 0xfe94de87) },
+   { OGC_U64(0x8c71dcd9, 0xba0b4925), OGC_U64(0x9ff0c08b, 0x7f1d0b14) },
+   { OGC_U64(0xaf8e5410, 0x288e1b6f), OGC_U64(0x07ecf0ae, 0x5ee44dd9) },
+   { OGC_U64(0xdb71e914, 0x32b1a24a), OGC_U64(0xc9e82cd9, 0xf69d6150) },
+   { OGC_U64(0x892731ac, 0x9faf056e), OGC_U64(0xbe311c08, 0x3a225cd2) },
+   { OGC_U64(0xab70fe17, 0xc79ac6ca), OGC_U64(0x6dbd630a, 0x48aaf406) },
+   { OGC_U64(0xd64d3d9d, 0xb981787d), OGC_U64(0x092cbbcc, 0xdad5b108) },
+   { OGC_U64(0x85f04682, 0x93f0eb4e), OGC_U64(0x25bbf560, 0x08c58ea5) },
+   { OGC_U64(0xa76c5823, 0x38ed2621), OGC_U64(0xaf2af2b8, 0x0af6f24e) },
+   { OGC_U64(0xd1476e2c, 0x07286faa), OGC_U64(0x1af5af66, 0x0db4aee1) },
+   { OGC_U64(0x82cca4db, 0x847945ca), OGC_U64(0x50d98d9f, 0xc890ed4d) },
+   { OGC_U64(0xa37fce12, 0x6597973c), OGC_U64(0xe50ff107, 0xbab528a0) },
+   { OGC_U64(0xcc5fc196, 0xfefd7d0c), OGC_U64(0x1e53ed49, 0xa96272c8) },
+   { OGC_U64(0xff77b1fc, 0xbebcdc4f), OGC_U64(0x25e8e89c, 0x13bb0f7a) },
+   { OGC_U64(0x9faacf3d, 0xf73609b1), OGC_U64(0x77b19161, 0x8c54e9ac) },
+   { OGC_U64(0xc795830d, 0x75038c1d), OGC_U64(0xd59df5b9, 0xef6a2417) },
+   { OGC_U64(0xf97ae3d0, 0xd2446f25), OGC_U64(0x4b057328, 0x6b44ad1d) },
+   { OGC_U64(0x9becce62, 0x836ac577), OGC_U64(0x4ee367f9, 0x430aec32) },
+   { OGC_U64(0xc2e801fb, 0x244576d5), OGC_U64(0x229c41f7, 0x93cda73f) },
+   { OGC_U64(0xf3a20279, 0xed56d48a), OGC_U64(0x6b435275, 0x78c1110f) },
+   { OGC_U64(0x9845418c, 0x345644d6), OGC_U64(0x830a1389, 0x6b78aaa9) },
+   { OGC_U64(0xbe5691ef, 0x416bd60c), OGC_U64(0x23cc986b, 0xc656d553) },
+   { OGC_U64(0xedec366b, 0x11c6cb8f), OGC_U64(0x2cbfbe86, 0xb7ec8aa8) },
+   { OGC_U64(0x94b3a202, 0xeb1c3f39), OGC_U64(0x7bf7d714, 0x32f3d6a9) },
+   { OGC_U64(0xb9e08a83, 0xa5e34f07), OGC_U64(0xdaf5ccd9, 0x3fb0cc53) },
+   { OGC_U64(0xe858ad24, 0x8f5c22c9), OGC_U64(0xd1b3400f, 0x8f9cff68) },
+   { OGC_U64(0x91376c36, 0xd99995be), OGC_U64(0x23100809, 0xb9c21fa1) },
+   { OGC_U64(0xb5854744, 0x8ffffb2d), OGC_U64(0xabd40a0c, 0x2832a78a) },
+   { OGC_U64(0xe2e69915, 0xb3fff9f9), OGC_U64(0x16c90c8f, 0x323f516c) },
+   { OGC_U64(0x8dd01fad, 0x907ffc3b), OGC_U64(0xae3da7d9, 0x7f6792e3) },
+   { OGC_U64(0xb1442798, 0xf49ffb4a), OGC_U64(0x99cd11cf, 0xdf41779c) },
+   { OGC_U64(0xdd95317f, 0x31c7fa1d), OGC_U64(0x40405643, 0xd711d583) },
+   { OGC_U64(0x8a7d3eef, 0x7f1cfc52), OGC_U64(0x482835ea, 0x666b2572) },
+   { OGC_U64(0xad1c8eab, 0x5ee43b66), OGC_U64(0xda324365, 0x0005eecf) },
+   { OGC_U64(0xd863b256, 0x369d4a40), OGC_U64(0x90bed43e, 0x40076a82) },
+   { OGC_U64(0x873e4f75, 0xe2224e68), OGC_U64(0x5a7744a6, 0xe804a291) },
+   { OGC_U64(0xa90de353, 0x5aaae202), OGC_U64(0x711515d0, 0xa205cb36) },
+   { OGC_U64(0xd3515c28, 0x31559a83), OGC_U64(0x0d5a5b44, 0xca873e03) },
+   { OGC_U64(0x8412d999, 0x1ed58091), OGC_U64(0xe858790a, 0xfe9486c2) },
+   { OGC_U64(0xa5178fff, 0x668ae0b6), OGC_U64(0x626e974d, 0xbe39a872) },
+   { OGC_U64(0xce5d73ff, 0x402d98e3), OGC_U64(0xfb0a3d21, 0x2dc8128f) },
+   { OGC_U64(0x80fa687f, 0x881c7f8e), OGC_U64(0x7ce66634, 0xbc9d0b99) },
+   { OGC_U64(0xa139029f, 0x6a239f72), OGC_U64(0x1c1fffc1, 0xebc44e80) },
+   { OGC_U64(0xc9874347, 0x44ac874e), OGC_U64(0xa327ffb2, 0x66b56220) },
+   { OGC_U64(0xfbe91419, 0x15d7a922), OGC_U64(0x4bf1ff9f, 0x0062baa8) },
+   { OGC_U64(0x9d71ac8f, 0xada6c9b5), OGC_U64(0x6f773fc3, 0x603db4a9) },
+   { OGC_U64(0xc4ce17b3, 0x99107c22), OGC_U64(0xcb550fb4, 0x384d21d3) },
+   { OGC_U64(0xf6019da0, 0x7f549b2b), OGC_U64(0x7e2a53a1, 0x46606a48) },
+   { OGC_U64(0x99c10284, 0x4f94e0fb), OGC_U64(0x2eda7444, 0xcbfc426d) },
+   { OGC_U64(0xc0314325, 0x637a1939), OGC_U64(0xfa911155, 0xfefb5308) },
+   { OGC_U64(0xf03d93ee, 0xbc589f88), OGC_U64(0x793555ab, 0x7eba27ca) },
+   { OGC_U64(0x96267c75, 0x35b763b5), OGC_U64(0x4bc1558b, 0x2f3458de) },
+   { OGC_U64(0xbbb01b92, 0x83253ca2), OGC_U64(0x9eb1aaed, 0xfb016f16) },
+   { OGC_U64(0xea9c2277, 0x23ee8bcb), OGC_U64(0x465e15a9, 0x79c1cadc) },
+   { OGC_U64(0x92a1958a, 0x7675175f), OGC_U64(0x0bfacd89, 0xec191ec9) },
+   { OGC_U64(0xb749faed, 0x14125d36), OGC_U64(0xcef980ec, 0x671f667b) },
+   { OGC_U64(0xe51c79a8, 0x5916f484), OGC_U64(0x82b7e127, 0x80e7401a) },
+   { OGC_U64(0x8f31cc09, 0x37ae58d2), OGC_U64(0xd1b2ecb8, 0xb0908810) },
+   { OGC_U64(0xb2fe3f0b, 0x8599ef07), OGC_U64(0x861fa7e6, 0xdcb4aa15) },
+   { OGC_U64(0xdfbdcece, 0x67006ac9), OGC_U64(0x67a791e0, 0x93e1d49a) },
+   { OGC_U64(0x8bd6a141, 0x006042bd), OGC_U64(0xe0c8bb2c, 0x5c6d24e0) },
+   { OGC_U64(0xaecc4991, 0x4078536d), OGC_U64(0x58fae9f7, 0x73886e18) },
+   { OGC_U64(0xda7f5bf5, 0x90966848), OGC_U64(0xaf39a475, 0x506a899e) },
+   { OGC_U64(0x888f9979, 0x7a5e012d), OGC_U64(0x6d8406c9, 0x52429603) },
+   { OGC_U64(0xaab37fd7, 0xd8f58178), OGC_U64(0xc8e5087b, 0xa6d33b83) },
+   { OGC_U64(0xd5605fcd, 0xcf32e1d6), OGC_U64(0xfb1e4a9a, 0x90880a64) },
+   { OGC_U64(0x855c3be0, 0xa17fcd26), OGC_U64(0x5cf2eea0, 0x9a55067f) },
+   { OGC_U64(0xa6b34ad8, 0xc9dfc06f), OGC_U64(0xf42faa48, 0xc0ea481e) },
+   { OGC_U64(0xd0601d8e, 0xfc57b08b), OGC_U64(0xf13b94da, 0xf124da26) },
+   { OGC_U64(0x823c1279, 0x5db6ce57), OGC_U64(0x76c53d08, 0xd6b70858) },
+   { OGC_U64(0xa2cb1717, 0xb52481ed), OGC_U64(0x54768c4b, 0x0c64ca6e) },
+   { OGC_U64(0xcb7ddcdd, 0xa26da268), OGC_U64(0xa9942f5d, 0xcf7dfd09) },
+   { OGC_U64(0xfe5d5415, 0x0b090b02), OGC_U64(0xd3f93b35, 0x435d7c4c) },
+   { OGC_U64(0x9efa548d, 0x26e5a6e1), OGC_U64(0xc47bc501, 0x4a1a6daf) },
+   { OGC_U64(0xc6b8e9b0, 0x709f109a), OGC_U64(0x359ab641, 0x9ca1091b) },
+   { OGC_U64(0xf867241c, 0x8cc6d4c0), OGC_U64(0xc30163d2, 0x03c94b62) },
+   { OGC_U64(0x9b407691, 0xd7fc44f8), OGC_U64(0x79e0de63, 0x425dcf1d) },
+   { OGC_U64(0xc2109436, 0x4dfb5636), OGC_U64(0x985915fc, 0x12f542e4) },
+   { OGC_U64(0xf294b943, 0xe17a2bc4), OGC_U64(0x3e6f5b7b, 0x17b2939d) },
+   { OGC_U64(0x979cf3ca, 0x6cec5b5a), OGC_U64(0xa705992c, 0xeecf9c42) },
+   { OGC_U64(0xbd8430bd, 0x08277231), OGC_U64(0x50c6ff78, 0x2a838353) },
+   { OGC_U64(0xece53cec, 0x4a314ebd), OGC_U64(0xa4f8bf56, 0x35246428) },
+   { OGC_U64(0x940f4613, 0xae5ed136), OGC_U64(0x871b7795, 0xe136be99) },
+   { OGC_U64(0xb9131798, 0x99f68584), OGC_U64(0x28e2557b, 0x59846e3f) },
+   { OGC_U64(0xe757dd7e, 0xc07426e5), OGC_U64(0x331aeada, 0x2fe589cf) },
+   { OGC_U64(0x9096ea6f, 0x3848984f), OGC_U64(0x3ff0d2c8, 0x5def7621) },
+   { OGC_U64(0xb4bca50b, 0x065abe63), OGC_U64(0x0fed077a, 0x756b53a9) },
+   { OGC_U64(0xe1ebce4d, 0xc7f16dfb), OGC_U64(0xd3e84959, 0x12c62894) },
+   { OGC_U64(0x8d3360f0, 0x9cf6e4bd), OGC_U64(0x64712dd7, 0xabbbd95c) },
+   { OGC_U64(0xb080392c, 0xc4349dec), OGC_U64(0xbd8d794d, 0x96aacfb3) },
+   { OGC_U64(0xdca04777, 0xf541c567), OGC_U64(0xecf0d7a0, 0xfc5583a0) },
+   { OGC_U64(0x89e42caa, 0xf9491b60), OGC_U64(0xf41686c4, 0x9db57244) },
+   { OGC_U64(0xac5d37d5, 0xb79b6239), OGC_U64(0x311c2875, 0xc522ced5) },
+   { OGC_U64(0xd77485cb, 0x25823ac7), OGC_U64(0x7d633293, 0x366b828b) },
+   { OGC_U64(0x86a8d39e, 0xf77164bc), OGC_U64(0xae5dff9c, 0x02033197) },
+   { OGC_U64(0xa8530886, 0xb54dbdeb), OGC_U64(0xd9f57f83, 0x0283fdfc) },
+   { OGC_U64(0xd267caa8, 0x62a12d66), OGC_U64(0xd072df63, 0xc324fd7b) },
+   { OGC_U64(0x8380dea9, 0x3da4bc60), OGC_U64(0x4247cb9e, 0x59f71e6d) },
+   { OGC_U64(0xa4611653, 0x8d0deb78), OGC_U64(0x52d9be85, 0xf074e608) },
+   { OGC_U64(0xcd795be8, 0x70516656), OGC_U64(0x67902e27, 0x6c921f8b) },
+   { OGC_U64(0x806bd971, 0x4632dff6), OGC_U64(0x00ba1cd8, 0xa3db53b6) },
+   { OGC_U64(0xa086cfcd, 0x97bf97f3), OGC_U64(0x80e8a40e, 0xccd228a4) },
+   { OGC_U64(0xc8a883c0, 0xfdaf7df0), OGC_U64(0x6122cd12, 0x8006b2cd) },
+   { OGC_U64(0xfad2a4b1, 0x3d1b5d6c), OGC_U64(0x796b8057, 0x20085f81) },
+   { OGC_U64(0x9cc3a6ee, 0xc6311a63), OGC_U64(0xcbe33036, 0x74053bb0) },
+   { OGC_U64(0xc3f490aa, 0x77bd60fc), OGC_U64(0xbedbfc44, 0x11068a9c) },
+   { OGC_U64(0xf4f1b4d5, 0x15acb93b), OGC_U64(0xee92fb55, 0x15482d44) },
+   { OGC_U64(0x99171105, 0x2d8bf3c5), OGC_U64(0x751bdd15, 0x2d4d1c4a) },
+   { OGC_U64(0xbf5cd546, 0x78eef0b6), OGC_U64(0xd262d45a, 0x78a0635d) },
+   { OGC_U64(0xef340a98, 0x172aace4), OGC_U64(0x86fb8971, 0x16c87c34) },
+   { OGC_U64(0x9580869f, 0x0e7aac0e), OGC_U64(0xd45d35e6, 0xae3d4da0) },
+   { OGC_U64(0xbae0a846, 0xd2195712), OGC_U64(0x89748360, 0x59cca109) },
+   { OGC_U64(0xe998d258, 0x869facd7), OGC_U64(0x2bd1a438, 0x703fc94b) },
+   { OGC_U64(0x91ff8377, 0x5423cc06), OGC_U64(0x7b6306a3, 0x4627ddcf) },
+   { OGC_U64(0xb67f6455, 0x292cbf08), OGC_U64(0x1a3bc84c, 0x17b1d542) },
+   { OGC_U64(0xe41f3d6a, 0x7377eeca), OGC_U64(0x20caba5f, 0x1d9e4a93) },
+   { OGC_U64(0x8e938662, 0x882af53e), OGC_U64(0x547eb47b, 0x7282ee9c) },
+   { OGC_U64(0xb23867fb, 0x2a35b28d), OGC_U64(0xe99e619a, 0x4f23aa43) },
+   { OGC_U64(0xdec681f9, 0xf4c31f31), OGC_U64(0x6405fa00, 0xe2ec94d4) },
+   { OGC_U64(0x8b3c113c, 0x38f9f37e), OGC_U64(0xde83bc40, 0x8dd3dd04) },
+   { OGC_U64(0xae0b158b, 0x4738705e), OGC_U64(0x9624ab50, 0xb148d445) },
+   { OGC_U64(0xd98ddaee, 0x19068c76), OGC_U64(0x3badd624, 0xdd9b0957) },
+   { OGC_U64(0x87f8a8d4, 0xcfa417c9), OGC_U64(0xe54ca5d7, 0x0a80e5d6) },
+   { OGC_U64(0xa9f6d30a, 0x038d1dbc), OGC_U64(0x5e9fcf4c, 0xcd211f4c) },
+   { OGC_U64(0xd47487cc, 0x8470652b), OGC_U64(0x7647c320, 0x0069671f) },
+   { OGC_U64(0x84c8d4df, 0xd2c63f3b), OGC_U64(0x29ecd9f4, 0x0041e073) },
+   { OGC_U64(0xa5fb0a17, 0xc777cf09), OGC_U64(0xf4681071, 0x00525890) },
+   { OGC_U64(0xcf79cc9d, 0xb955c2cc), OGC_U64(0x7182148d, 0x4066eeb4) },
+   { OGC_U64(0x81ac1fe2, 0x93d599bf), OGC_U64(0xc6f14cd8, 0x48405530) },
+   { OGC_U64(0xa21727db, 0x38cb002f), OGC_U64(0xb8ada00e, 0x5a506a7c) },
+   { OGC_U64(0xca9cf1d2, 0x06fdc03b), OGC_U64(0xa6d90811, 0xf0e4851c) },
+   { OGC_U64(0xfd442e46, 0x88bd304a), OGC_U64(0x908f4a16, 0x6d1da663) },
+   { OGC_U64(0x9e4a9cec, 0x15763e2e), OGC_U64(0x9a598e4e, 0x043287fe) },
+   { OGC_U64(0xc5dd4427, 0x1ad3cdba), OGC_U64(0x40eff1e1, 0x853f29fd) },
+   { OGC_U64(0xf7549530, 0xe188c128), OGC_U64(0xd12bee59, 0xe68ef47c) },
+   { OGC_U64(0x9a94dd3e, 0x8cf578b9), OGC_U64(0x82bb74f8, 0x301958ce) },
+   { OGC_U64(0xc13a148e, 0x3032d6e7), OGC_U64(0xe36a5236, 0x3c1faf01) },
+   { OGC_U64(0xf18899b1, 0xbc3f8ca1), OGC_U64(0xdc44e6c3, 0xcb279ac1) },
+   { OGC_U64(0x96f5600f, 0x15a7b7e5), OGC_U64(0x29ab103a, 0x5ef8c0b9) },
+   { OGC_U64(0xbcb2b812, 0xdb11a5de), OGC_U64(0x7415d448, 0xf6b6f0e7) },
+   { OGC_U64(0xebdf6617, 0x91d60f56), OGC_U64(0x111b495b, 0x3464ad21) },
+   { OGC_U64(0x936b9fce, 0xbb25c995), OGC_U64(0xcab10dd9, 0x00beec34) },
+   { OGC_U64(0xb84687c2, 0x69ef3bfb), OGC_U64(0x3d5d514f, 0x40eea742) },
+   { OGC_U64(0xe65829b3, 0x046b0afa), OGC_U64(0x0cb4a5a3, 0x112a5112) },
+   { OGC_U64(0x8ff71a0f, 0xe2c2e6dc), OGC_U64(0x47f0e785, 0xeaba72ab) },
+   { OGC_U64(0xb3f4e093, 0xdb73a093), OGC_U64(0x59ed2167, 0x65690f56) },
+   { OGC_U64(0xe0f218b8, 0xd25088b8), OGC_U64(0x306869c1, 0x3ec3532c) },
+   { OGC_U64(0x8c974f73, 0x83725573), OGC_U64(0x1e414218, 0xc73a13fb) },
+   { OGC_U64(0xafbd2350, 0x644eeacf), OGC_U64(0xe5d1929e, 0xf90898fa) },
+   { OGC_U64(0xdbac6c24, 0x7d62a583), OGC_U64(0xdf45f746, 0xb74abf39) },
+   { OGC_U64(0x894bc396, 0xce5da772), OGC_U64(0x6b8bba8c, 0x328eb783) },
+   { OGC_U64(0xab9eb47c, 0x81f5114f), OGC_U64(0x066ea92f, 0x3f326564) },
+   { OGC_U64(0xd686619b, 0xa27255a2), OGC_U64(0xc80a537b, 0x0efefebd) },
+   { OGC_U64(0x8613fd01, 0x45877585), OGC_U64(0xbd06742c, 0xe95f5f36) },
+   { OGC_U64(0xa798fc41, 0x96e952e7), OGC_U64(0x2c481138, 0x23b73704) },
+   { OGC_U64(0xd17f3b51, 0xfca3a7a0), OGC_U64(0xf75a1586, 0x2ca504c5) },
+   { OGC_U64(0x82ef8513, 0x3de648c4), OGC_U64(0x9a984d73, 0xdbe722fb) },
+   { OGC_U64(0xa3ab6658, 0x0d5fdaf5), OGC_U64(0xc13e60d0, 0xd2e0ebba) },
+   { OGC_U64(0xcc963fee, 0x10b7d1b3), OGC_U64(0x318df905, 0x079926a8) },
+   { OGC_U64(0xffbbcfe9, 0x94e5c61f), OGC_U64(0xfdf17746, 0x497f7052) },
+   { OGC_U64(0x9fd561f1, 0xfd0f9bd3), OGC_U64(0xfeb6ea8b, 0xedefa633) },
+   { OGC_U64(0xc7caba6e, 0x7c5382c8), OGC_U64(0xfe64a52e, 0xe96b8fc0) },
+   { OGC_U64(0xf9bd690a, 0x1b68637b), OGC_U64(0x3dfdce7a, 0xa3c673b0) },
+   { OGC_U64(0x9c1661a6, 0x51213e2d), OGC_U64(0x06bea10c, 0xa65c084e) },
+   { OGC_U64(0xc31bfa0f, 0xe5698db8), OGC_U64(0x486e494f, 0xcff30a62) },
+   { OGC_U64(0xf3e2f893, 0xdec3f126), OGC_U64(0x5a89dba3, 0xc3efccfa) },
+   { OGC_U64(0x986ddb5c, 0x6b3a76b7), OGC_U64(0xf8962946, 0x5a75e01c) },
+   { OGC_U64(0xbe895233, 0x86091465), OGC_U64(0xf6bbb397, 0xf1135823) },
+   { OGC_U64(0xee2ba6c0, 0x678b597f), OGC_U64(0x746aa07d, 0xed582e2c) },
+   { OGC_U64(0x94db4838, 0x40b717ef), OGC_U64(0xa8c2a44e, 0xb4571cdc) },
+   { OGC_U64(0xba121a46, 0x50e4ddeb), OGC_U64(0x92f34d62, 0x616ce413) },
+   { OGC_U64(0xe896a0d7, 0xe51e1566), OGC_U64(0x77b020ba, 0xf9c81d17) },
+   { OGC_U64(0x915e2486, 0xef32cd60), OGC_U64(0x0ace1474, 0xdc1d122e) },
+   { OGC_U64(0xb5b5ada8, 0xaaff80b8), OGC_U64(0x0d819992, 0x132456ba) },
+   { OGC_U64(0xe3231912, 0xd5bf60e6), OGC_U64(0x10e1fff6, 0x97ed6c69) },
+   { OGC_U64(0x8df5efab, 0xc5979c8f), OGC_U64(0xca8d3ffa, 0x1ef463c1) },
+   { OGC_U64(0xb1736b96, 0xb6fd83b3), OGC_U64(0xbd308ff8, 0xa6b17cb2) },
+   { OGC_U64(0xddd0467c, 0x64bce4a0), OGC_U64(0xac7cb3f6, 0xd05ddbde) },
+   { OGC_U64(0x8aa22c0d, 0xbef60ee4), OGC_U64(0x6bcdf07a, 0x423aa96b) },
+   { OGC_U64(0xad4ab711, 0x2eb3929d), OGC_U64(0x86c16c98, 0xd2c953c6) },
+   { OGC_U64(0xd89d64d5, 0x7a607744), OGC_U64(0xe871c7bf, 0x077ba8b7) },
+   { OGC_U64(0x87625f05, 0x6c7c4a8b), OGC_U64(0x11471cd7, 0x64ad4972) },
+   { OGC_U64(0xa93af6c6, 0xc79b5d2d), OGC_U64(0xd598e40d, 0x3dd89bcf) },
+   { OGC_U64(0xd389b478, 0x79823479), OGC_U64(0x4aff1d10, 0x8d4ec2c3) },
+   { OGC_U64(0x843610cb, 0x4bf160cb), OGC_U64(0xcedf722a, 0x585139ba) },
+   { OGC_U64(0xa54394fe, 0x1eedb8fe), OGC_U64(0xc2974eb4, 0xee658828) },
+   { OGC_U64(0xce947a3d, 0xa6a9273e), OGC_U64(0x733d2262, 0x29feea32) },
+   { OGC_U64(0x811ccc66, 0x8829b887), OGC_U64(0x0806357d, 0x5a3f525f) },
+   { OGC_U64(0xa163ff80, 0x2a3426a8), OGC_U64(0xca07c2dc, 0xb0cf26f7) },
+   { OGC_U64(0xc9bcff60, 0x34c13052), OGC_U64(0xfc89b393, 0xdd02f0b5) },
+   { OGC_U64(0xfc2c3f38, 0x41f17c67), OGC_U64(0xbbac2078, 0xd443ace2) },
+   { OGC_U64(0x9d9ba783, 0x2936edc0), OGC_U64(0xd54b944b, 0x84aa4c0d) },
+   { OGC_U64(0xc5029163, 0xf384a931), OGC_U64(0x0a9e795e, 0x65d4df11) },
+   { OGC_U64(0xf64335bc, 0xf065d37d), OGC_U64(0x4d4617b5, 0xff4a16d5) },
+   { OGC_U64(0x99ea0196, 0x163fa42e), OGC_U64(0x504bced1, 0xbf8e4e45) },
+   { OGC_U64(0xc06481fb, 0x9bcf8d39), OGC_U64(0xe45ec286, 0x2f71e1d6) },
+   { OGC_U64(0xf07da27a, 0x82c37088), OGC_U64(0x5d767327, 0xbb4e5a4c) },
+   { OGC_U64(0x964e858c, 0x91ba2655), OGC_U64(0x3a6a07f8, 0xd510f86f) },
+   { OGC_U64(0xbbe226ef, 0xb628afea), OGC_U64(0x890489f7, 0x0a55368b) },
+   { OGC_U64(0xeadab0ab, 0xa3b2dbe5), OGC_U64(0x2b45ac74, 0xccea842e) },
+   { OGC_U64(0x92c8ae6b, 0x464fc96f), OGC_U64(0x3b0b8bc9, 0x0012929d) },
+   { OGC_U64(0xb77ada06, 0x17e3bbcb), OGC_U64(0x09ce6ebb, 0x40173744) },
+   { OGC_U64(0xe5599087, 0x9ddcaabd), OGC_U64(0xcc420a6a, 0x101d0515) },
+   { OGC_U64(0x8f57fa54, 0xc2a9eab6), OGC_U64(0x9fa94682, 0x4a12232d) },
+   { OGC_U64(0xb32df8e9, 0xf3546564), OGC_U64(0x47939822, 0xdc96abf9) },
+   { OGC_U64(0xdff97724, 0x70297ebd), OGC_U64(0x59787e2b, 0x93bc56f7) },
+   { OGC_U64(0x8bfbea76, 0xc619ef36), OGC_U64(0x57eb4edb, 0x3c55b65a) },
+   { OGC_U64(0xaefae514, 0x77a06b03), OGC_U64(0xede62292, 0x0b6b23f1) },
+   { OGC_U64(0xdab99e59, 0x958885c4), OGC_U64(0xe95fab36, 0x8e45eced) },
+   { OGC_U64(0x88b402f7, 0xfd75539b), OGC_U64(0x11dbcb02, 0x18ebb414) },
+   { OGC_U64(0xaae103b5, 0xfcd2a881), OGC_U64(0xd652bdc2, 0x9f26a119) },
+   { OGC_U64(0xd59944a3, 0x7c0752a2), OGC_U64(0x4be76d33, 0x46f0495f) },
+   { OGC_U64(0x857fcae6, 0x2d8493a5), OGC_U64(0x6f70a440, 0x0c562ddb) },
+   { OGC_U64(0xa6dfbd9f, 0xb8e5b88e), OGC_U64(0xcb4ccd50, 0x0f6bb952) },
+   { OGC_U64(0xd097ad07, 0xa71f26b2), OGC_U64(0x7e2000a4, 0x1346a7a7) },
+   { OGC_U64(0x825ecc24, 0xc873782f), OGC_U64(0x8ed40066, 0x8c0c28c8) },
+   { OGC_U64(0xa2f67f2d, 0xfa90563b), OGC_U64(0x72890080, 0x2f0f32fa) },
+   { OGC_U64(0xcbb41ef9, 0x79346bca), OGC_U64(0x4f2b40a0, 0x3ad2ffb9) },
+   { OGC_U64(0xfea126b7, 0xd78186bc), OGC_U64(0xe2f610c8, 0x4987bfa8) },
+   { OGC_U64(0x9f24b832, 0xe6b0f436), OGC_U64(0x0dd9ca7d, 0x2df4d7c9) },
+   { OGC_U64(0xc6ede63f, 0xa05d3143), OGC_U64(0x91503d1c, 0x79720dbb) },
+   { OGC_U64(0xf8a95fcf, 0x88747d94), OGC_U64(0x75a44c63, 0x97ce912a) },
+   { OGC_U64(0x9b69dbe1, 0xb548ce7c), OGC_U64(0xc986afbe, 0x3ee11aba) },
+   { OGC_U64(0xc24452da, 0x229b021b), OGC_U64(0xfbe85bad, 0xce996168) },
+   { OGC_U64(0xf2d56790, 0xab41c2a2), OGC_U64(0xfae27299, 0x423fb9c3) },
+   { OGC_U64(0x97c560ba, 0x6b0919a5), OGC_U64(0xdccd879f, 0xc967d41a) },
+   { OGC_U64(0xbdb6b8e9, 0x05cb600f), OGC_U64(0x5400e987, 0xbbc1c920) },
+   { OGC_U64(0xed246723, 0x473e3813), OGC_U64(0x290123e9, 0xaab23b68) },
+   { OGC_U64(0x9436c076, 0x0c86e30b), OGC_U64(0xf9a0b672, 0x0aaf6521) },
+   { OGC_U64(0xb9447093, 0x8fa89bce), OGC_U64(0xf808e40e, 0x8d5b3e69) },
+   { OGC_U64(0xe7958cb8, 0x7392c2c2), OGC_U64(0xb60b1d12, 0x30b20e04) },
+   { OGC_U64(0x90bd77f3, 0x483bb9b9), OGC_U64(0xb1c6f22b, 0x5e6f48c2) },
+   { OGC_U64(0xb4ecd5f0, 0x1a4aa828), OGC_U64(0x1e38aeb6, 0x360b1af3) },
+   { OGC_U64(0xe2280b6c, 0x20dd5232), OGC_U64(0x25c6da63, 0xc38de1b0) },
+   { OGC_U64(0x8d590723, 0x948a535f), OGC_U64(0x579c487e, 0x5a38ad0e) },
+   { OGC_U64(0xb0af48ec, 0x79ace837), OGC_U64(0x2d835a9d, 0xf0c6d851) },
+   { OGC_U64(0xdcdb1b27, 0x98182244), OGC_U64(0xf8e43145, 0x6cf88e65) },
+   { OGC_U64(0x8a08f0f8, 0xbf0f156b), OGC_U64(0x1b8e9ecb, 0x641b58ff) },
+   { OGC_U64(0xac8b2d36, 0xeed2dac5), OGC_U64(0xe272467e, 0x3d222f3f) },
+   { OGC_U64(0xd7adf884, 0xaa879177), OGC_U64(0x5b0ed81d, 0xcc6abb0f) },
+   { OGC_U64(0x86ccbb52, 0xea94baea), OGC_U64(0x98e94712, 0x9fc2b4e9) },
+   { OGC_U64(0xa87fea27, 0xa539e9a5), OGC_U64(0x3f2398d7, 0x47b36224) },
+   { OGC_U64(0xd29fe4b1, 0x8e88640e), OGC_U64(0x8eec7f0d, 0x19a03aad) },
+   { OGC_U64(0x83a3eeee, 0xf9153e89), OGC_U64(0x1953cf68, 0x300424ac) },
+   { OGC_U64(0xa48ceaaa, 0xb75a8e2b), OGC_U64(0x5fa8c342, 0x3c052dd7) },
+   { OGC_U64(0xcdb02555, 0x653131b6), OGC_U64(0x3792f412, 0xcb06794d) },
+   { OGC_U64(0x808e1755, 0x5f3ebf11), OGC_U64(0xe2bbd88b, 0xbee40bd0) },
+   { OGC_U64(0xa0b19d2a, 0xb70e6ed6), OGC_U64(0x5b6aceae, 0xae9d0ec4) },
+   { OGC_U64(0xc8de0475, 0x64d20a8b), OGC_U64(0xf245825a, 0x5a445275) },
+   { OGC_U64(0xfb158592, 0xbe068d2e), OGC_U64(0xeed6e2f0, 0xf0d56712) },
+   { OGC_U64(0x9ced737b, 0xb6c4183d), OGC_U64(0x55464dd6, 0x9685606b) },
+   { OGC_U64(0xc428d05a, 0xa4751e4c), OGC_U64(0xaa97e14c, 0x3c26b886) },
+   { OGC_U64(0xf5330471, 0x4d9265df), OGC_U64(0xd53dd99f, 0x4b3066a8) },
+   { OGC_U64(0x993fe2c6, 0xd07b7fab), OGC_U64(0xe546a803, 0x8efe4029) },
+   { OGC_U64(0xbf8fdb78, 0x849a5f96), OGC_U64(0xde985204, 0x72bdd033) },
+   { OGC_U64(0xef73d256, 0xa5c0f77c), OGC_U64(0x963e6685, 0x8f6d4440) },
+   { OGC_U64(0x95a86376, 0x27989aad), OGC_U64(0xdde70013, 0x79a44aa8) },
+   { OGC_U64(0xbb127c53, 0xb17ec159), OGC_U64(0x5560c018, 0x580d5d52) },
+   { OGC_U64(0xe9d71b68, 0x9dde71af), OGC_U64(0xaab8f01e, 0x6e10b4a6) },
+   { OGC_U64(0x92267121, 0x62ab070d), OGC_U64(0xcab39613, 0x04ca70e8) },
+   { OGC_U64(0xb6b00d69, 0xbb55c8d1), OGC_U64(0x3d607b97, 0xc5fd0d22) },
+   { OGC_U64(0xe45c10c4, 0x2a2b3b05), OGC_U64(0x8cb89a7d, 0xb77c506a) },
+   { OGC_U64(0x8eb98a7a, 0x9a5b04e3), OGC_U64(0x77f3608e, 0x92adb242) },
+   { OGC_U64(0xb267ed19, 0x40f1c61c), OGC_U64(0x55f038b2, 0x37591ed3) },
+   { OGC_U64(0xdf01e85f, 0x912e37a3), OGC_U64(0x6b6c46de, 0xc52f6688) },
+   { OGC_U64(0x8b61313b, 0xbabce2c6), OGC_U64(0x2323ac4b, 0x3b3da015) },
+   { OGC_U64(0xae397d8a, 0xa96c1b77), OGC_U64(0xabec975e, 0x0a0d081a) },
+   { OGC_U64(0xd9c7dced, 0x53c72255), OGC_U64(0x96e7bd35, 0x8c904a21) },
+   { OGC_U64(0x881cea14, 0x545c7575), OGC_U64(0x7e50d641, 0x77da2e54) },
+   { OGC_U64(0xaa242499, 0x697392d2), OGC_U64(0xdde50bd1, 0xd5d0b9e9) },
+   { OGC_U64(0xd4ad2dbf, 0xc3d07787), OGC_U64(0x955e4ec6, 0x4b44e864) },
+   { OGC_U64(0x84ec3c97, 0xda624ab4), OGC_U64(0xbd5af13b, 0xef0b113e) },
+   { OGC_U64(0xa6274bbd, 0xd0fadd61), OGC_U64(0xecb1ad8a, 0xeacdd58e) },
+   { OGC_U64(0xcfb11ead, 0x453994ba), OGC_U64(0x67de18ed, 0xa5814af2) },
+   { OGC_U64(0x81ceb32c, 0x4b43fcf4), OGC_U64(0x80eacf94, 0x8770ced7) },
+   { OGC_U64(0xa2425ff7, 0x5e14fc31), OGC_U64(0xa1258379, 0xa94d028d) },
+   { OGC_U64(0xcad2f7f5, 0x359a3b3e), OGC_U64(0x096ee458, 0x13a04330) },
+   { OGC_U64(0xfd87b5f2, 0x8300ca0d), OGC_U64(0x8bca9d6e, 0x188853fc) },
+   { OGC_U64(0x9e74d1b7, 0x91e07e48), OGC_U64(0x775ea264, 0xcf55347d) },
+   { OGC_U64(0xc6120625, 0x76589dda), OGC_U64(0x95364afe, 0x032a819d) },
+   { OGC_U64(0xf79687ae, 0xd3eec551), OGC_U64(0x3a83ddbd, 0x83f52204) },
+   { OGC_U64(0x9abe14cd, 0x44753b52), OGC_U64(0xc4926a96, 0x72793542) },
+   { OGC_U64(0xc16d9a00, 0x95928a27), OGC_U64(0x75b7053c, 0x0f178293) },
+   { OGC_U64(0xf1c90080, 0xbaf72cb1), OGC_U64(0x5324c68b, 0x12dd6338) },
+   { OGC_U64(0x971da050, 0x74da7bee), OGC_U64(0xd3f6fc16, 0xebca5e03) },
+   { OGC_U64(0xbce50864, 0x92111aea), OGC_U64(0x88f4bb1c, 0xa6bcf584) },
+   { OGC_U64(0xec1e4a7d, 0xb69561a5), OGC_U64(0x2b31e9e3, 0xd06c32e5) },
+   { OGC_U64(0x9392ee8e, 0x921d5d07), OGC_U64(0x3aff322e, 0x62439fcf) },
+   { OGC_U64(0xb877aa32, 0x36a4b449), OGC_U64(0x09befeb9, 0xfad487c2) },
+   { OGC_U64(0xe69594be, 0xc44de15b), OGC_U64(0x4c2ebe68, 0x7989a9b3) },
+   { OGC_U64(0x901d7cf7, 0x3ab0acd9), OGC_U64(0x0f9d3701, 0x4bf60a10) },
+   { OGC_U64(0xb424dc35, 0x095cd80f), OGC_U64(0x538484c1, 0x9ef38c94) },
+   { OGC_U64(0xe12e1342, 0x4bb40e13), OGC_U64(0x2865a5f2, 0x06b06fb9) },
+   { OGC_U64(0x8cbccc09, 0x6f5088cb), OGC_U64(0xf93f87b7, 0x442e45d3) },
+   { OGC_U64(0xafebff0b, 0xcb24aafe), OGC_U64(0xf78f69a5, 0x1539d748) },
+   { OGC_U64(0xdbe6fece, 0xbdedd5be), OGC_U64(0xb573440e, 0x5a884d1b) },
+   { OGC_U64(0x89705f41, 0x36b4a597), OGC_U64(0x31680a88, 0xf8953030) },
+   { OGC_U64(0xabcc7711, 0x8461cefc), OGC_U64(0xfdc20d2b, 0x36ba7c3d) },
+   { OGC_U64(0xd6bf94d5, 0xe57a42bc), OGC_U64(0x3d329076, 0x04691b4c) },
+   { OGC_U64(0x8637bd05, 0xaf6c69b5), OGC_U64(0xa63f9a49, 0xc2c1b10f) },
+   { OGC_U64(0xa7c5ac47, 0x1b478423), OGC_U64(0x0fcf80dc, 0x33721d53) },
+   { OGC_U64(0xd1b71758, 0xe219652b), OGC_U64(0xd3c36113, 0x404ea4a8) },
+   { OGC_U64(0x83126e97, 0x8d4fdf3b), OGC_U64(0x645a1cac, 0x083126e9) },
+   { OGC_U64(0xa3d70a3d, 0x70a3d70a), OGC_U64(0x3d70a3d7, 0x0a3d70a3) },
+   { OGC_U64(0xcccccccc, 0xcccccccc), OGC_U64(0xcccccccc, 0xcccccccc) },
+   { OGC_U64(0x80000000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xa0000000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xc8000000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xfa000000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x9c400000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xc3500000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xf4240000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x98968000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xbebc2000, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xee6b2800, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x9502f900, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xba43b740, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xe8d4a510, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x9184e72a, 0x00000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xb5e620f4, 0x80000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xe35fa931, 0xa0000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x8e1bc9bf, 0x04000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xb1a2bc2e, 0xc5000000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xde0b6b3a, 0x76400000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x8ac72304, 0x89e80000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xad78ebc5, 0xac620000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xd8d726b7, 0x177a8000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x87867832, 0x6eac9000), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xa968163f, 0x0a57b400), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xd3c21bce, 0xcceda100), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x84595161, 0x401484a0), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xa56fa5b9, 0x9019a5c8), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0xcecb8f27, 0xf4200f3a), OGC_U64(0x00000000, 0x00000000) },
+   { OGC_U64(0x813f3978, 0xf8940984), OGC_U64(0x40000000, 0x00000000) },
+   { OGC_U64(0xa18f07d7, 0x36b90be5), OGC_U64(0x50000000, 0x00000000) },
+   { OGC_U64(0xc9f2c9cd, 0x04674ede), OGC_U64(0xa4000000, 0x00000000) },
+   { OGC_U64(0xfc6f7c40, 0x45812296), OGC_U64(0x4d000000, 0x00000000) },
+   { OGC_U64(0x9dc5ada8, 0x2b70b59d), OGC_U64(0xf0200000, 0x00000000) },
+   { OGC_U64(0xc5371912, 0x364ce305), OGC_U64(0x6c280000, 0x00000000) },
+   { OGC_U64(0xf684df56, 0xc3e01bc6), OGC_U64(0xc7320000, 0x00000000) },
+   { OGC_U64(0x9a130b96, 0x3a6c115c), OGC_U64(0x3c7f4000, 0x00000000) },
+   { OGC_U64(0xc097ce7b, 0xc90715b3), OGC_U64(0x4b9f1000, 0x00000000) },
+   { OGC_U64(0xf0bdc21a, 0xbb48db20), OGC_U64(0x1e86d400, 0x00000000) },
+   { OGC_U64(0x96769950, 0xb50d88f4), OGC_U64(0x13144480, 0x00000000) },
+   { OGC_U64(0xbc143fa4, 0xe250eb31), OGC_U64(0x17d955a0, 0x00000000) },
+   { OGC_U64(0xeb194f8e, 0x1ae525fd), OGC_U64(0x5dcfab08, 0x00000000) },
+   { OGC_U64(0x92efd1b8, 0xd0cf37be), OGC_U64(0x5aa1cae5, 0x00000000) },
+   { OGC_U64(0xb7abc627, 0x050305ad), OGC_U64(0xf14a3d9e, 0x40000000) },
+   { OGC_U64(0xe596b7b0, 0xc643c719), OGC_U64(0x6d9ccd05, 0xd0000000) },
+   { OGC_U64(0x8f7e32ce, 0x7bea5c6f), OGC_U64(0xe4820023, 0xa2000000) },
+   { OGC_U64(0xb35dbf82, 0x1ae4f38b), OGC_U64(0xdda2802c, 0x8a800000) },
+   { OGC_U64(0xe0352f62, 0xa19e306e), OGC_U64(0xd50b2037, 0xad200000) },
+   { OGC_U64(0x8c213d9d, 0xa502de45), OGC_U64(0x4526f422, 0xcc340000) },
+   { OGC_U64(0xaf298d05, 0x0e4395d6), OGC_U64(0x9670b12b, 0x7f410000) },
+   { OGC_U64(0xdaf3f046, 0x51d47b4c), OGC_U64(0x3c0cdd76, 0x5f114000) },
+   { OGC_U64(0x88d8762b, 0xf324cd0f), OGC_U64(0xa5880a69, 0xfb6ac800) },
+   { OGC_U64(0xab0e93b6, 0xefee0053), OGC_U64(0x8eea0d04, 0x7a457a00) },
+   { OGC_U64(0xd5d238a4, 0xabe98068), OGC_U64(0x72a49045, 0x98d6d880) },
+   { OGC_U64(0x85a36366, 0xeb71f041), OGC_U64(0x47a6da2b, 0x7f864750) },
+   { OGC_U64(0xa70c3c40, 0xa64e6c51), OGC_U64(0x999090b6, 0x5f67d924) },
+   { OGC_U64(0xd0cf4b50, 0xcfe20765), OGC_U64(0xfff4b4e3, 0xf741cf6d) },
+   { OGC_U64(0x82818f12, 0x81ed449f), OGC_U64(0xbff8f10e, 0x7a8921a4) },
+   { OGC_U64(0xa321f2d7, 0x226895c7), OGC_U64(0xaff72d52, 0x192b6a0d) },
+   { OGC_U64(0xcbea6f8c, 0xeb02bb39), OGC_U64(0x9bf4f8a6, 0x9f764490) },
+   { OGC_U64(0xfee50b70, 0x25c36a08), OGC_U64(0x02f236d0, 0x4753d5b4) },
+   { OGC_U64(0x9f4f2726, 0x179a2245), OGC_U64(0x01d76242, 0x2c946590) },
+   { OGC_U64(0xc722f0ef, 0x9d80aad6), OGC_U64(0x424d3ad2, 0xb7b97ef5) },
+   { OGC_U64(0xf8ebad2b, 0x84e0d58b), OGC_U64(0xd2e08987, 0x65a7deb2) },
+   { OGC_U64(0x9b934c3b, 0x330c8577), OGC_U64(0x63cc55f4, 0x9f88eb2f) },
+   { OGC_U64(0xc2781f49, 0xffcfa6d5), OGC_U64(0x3cbf6b71, 0xc76b25fb) },
+   { OGC_U64(0xf316271c, 0x7fc3908a), OGC_U64(0x8bef464e, 0x3945ef7a) },
+   { OGC_U64(0x97edd871, 0xcfda3a56), OGC_U64(0x97758bf0, 0xe3cbb5ac) },
+   { OGC_U64(0xbde94e8e, 0x43d0c8ec), OGC_U64(0x3d52eeed, 0x1cbea317) },
+   { OGC_U64(0xed63a231, 0xd4c4fb27), OGC_U64(0x4ca7aaa8, 0x63ee4bdd) },
+   { OGC_U64(0x945e455f, 0x24fb1cf8), OGC_U64(0x8fe8caa9, 0x3e74ef6a) },
+   { OGC_U64(0xb975d6b6, 0xee39e436), OGC_U64(0xb3e2fd53, 0x8e122b44) },
+   { OGC_U64(0xe7d34c64, 0xa9c85d44), OGC_U64(0x60dbbca8, 0x7196b616) },
+   { OGC_U64(0x90e40fbe, 0xea1d3a4a), OGC_U64(0xbc8955e9, 0x46fe31cd) },
+   { OGC_U64(0xb51d13ae, 0xa4a488dd), OGC_U64(0x6babab63, 0x98bdbe41) },
+   { OGC_U64(0xe264589a, 0x4dcdab14), OGC_U64(0xc696963c, 0x7eed2dd1) },
+   { OGC_U64(0x8d7eb760, 0x70a08aec), OGC_U64(0xfc1e1de5, 0xcf543ca2) },
+   { OGC_U64(0xb0de6538, 0x8cc8ada8), OGC_U64(0x3b25a55f, 0x43294bcb) },
+   { OGC_U64(0xdd15fe86, 0xaffad912), OGC_U64(0x49ef0eb7, 0x13f39ebe) },
+   { OGC_U64(0x8a2dbf14, 0x2dfcc7ab), OGC_U64(0x6e356932, 0x6c784337) },
+   { OGC_U64(0xacb92ed9, 0x397bf996), OGC_U64(0x49c2c37f, 0x07965404) },
+   { OGC_U64(0xd7e77a8f, 0x87daf7fb), OGC_U64(0xdc33745e, 0xc97be906) },
+   { OGC_U64(0x86f0ac99, 0xb4e8dafd), OGC_U64(0x69a028bb, 0x3ded71a3) },
+   { OGC_U64(0xa8acd7c0, 0x222311bc), OGC_U64(0xc40832ea, 0x0d68ce0c) },
+   { OGC_U64(0xd2d80db0, 0x2aabd62b), OGC_U64(0xf50a3fa4, 0x90c30190) },
+   { OGC_U64(0x83c7088e, 0x1aab65db), OGC_U64(0x792667c6, 0xda79e0fa) },
+   { OGC_U64(0xa4b8cab1, 0xa1563f52), OGC_U64(0x577001b8, 0x91185938) },
+   { OGC_U64(0xcde6fd5e, 0x09abcf26), OGC_U64(0xed4c0226, 0xb55e6f86) },
+   { OGC_U64(0x80b05e5a, 0xc60b6178), OGC_U64(0x544f8158, 0x315b05b4) },
+   { OGC_U64(0xa0dc75f1, 0x778e39d6), OGC_U64(0x696361ae, 0x3db1c721) },
+   { OGC_U64(0xc913936d, 0xd571c84c), OGC_U64(0x03bc3a19, 0xcd1e38e9) },
+   { OGC_U64(0xfb587849, 0x4ace3a5f), OGC_U64(0x04ab48a0, 0x4065c723) },
+   { OGC_U64(0x9d174b2d, 0xcec0e47b), OGC_U64(0x62eb0d64, 0x283f9c76) },
+   { OGC_U64(0xc45d1df9, 0x42711d9a), OGC_U64(0x3ba5d0bd, 0x324f8394) },
+   { OGC_U64(0xf5746577, 0x930d6500), OGC_U64(0xca8f44ec, 0x7ee36479) },
+   { OGC_U64(0x9968bf6a, 0xbbe85f20), OGC_U64(0x7e998b13, 0xcf4e1ecb) },
+   { OGC_U64(0xbfc2ef45, 0x6ae276e8), OGC_U64(0x9e3fedd8, 0xc321a67e) },
+   { OGC_U64(0xefb3ab16, 0xc59b14a2), OGC_U64(0xc5cfe94e, 0xf3ea101e) },
+   { OGC_U64(0x95d04aee, 0x3b80ece5), OGC_U64(0xbba1f1d1, 0x58724a12) },
+   { OGC_U64(0xbb445da9, 0xca61281f), OGC_U64(0x2a8a6e45, 0xae8edc97) },
+   { OGC_U64(0xea157514, 0x3cf97226), OGC_U64(0xf52d09d7, 0x1a3293bd) },
+   { OGC_U64(0x924d692c, 0xa61be758), OGC_U64(0x593c2626, 0x705f9c56) },
+   { OGC_U64(0xb6e0c377, 0xcfa2e12e), OGC_U64(0x6f8b2fb0, 0x0c77836c) },
+   { OGC_U64(0xe498f455, 0xc38b997a), OGC_U64(0x0b6dfb9c, 0x0f956447) },
+   { OGC_U64(0x8edf98b5, 0x9a373fec), OGC_U64(0x4724bd41, 0x89bd5eac) },
+   { OGC_U64(0xb2977ee3, 0x00c50fe7), OGC_U64(0x58edec91, 0xec2cb657) },
+   { OGC_U64(0xdf3d5e9b, 0xc0f653e1), OGC_U64(0x2f2967b6, 0x6737e3ed) },
+   { OGC_U64(0x8b865b21, 0x5899f46c), OGC_U64(0xbd79e0d2, 0x0082ee74) },
+   { OGC_U64(0xae67f1e9, 0xaec07187), OGC_U64(0xecd85906, 0x80a3aa11) },
+   { OGC_U64(0xda01ee64, 0x1a708de9), OGC_U64(0xe80e6f48, 0x20cc9495) },
+   { OGC_U64(0x884134fe, 0x908658b2), OGC_U64(0x3109058d, 0x147fdcdd) },
+   { OGC_U64(0xaa51823e, 0x34a7eede), OGC_U64(0xbd4b46f0, 0x599fd415) },
+   { OGC_U64(0xd4e5e2cd, 0xc1d1ea96), OGC_U64(0x6c9e18ac, 0x7007c91a) },
+   { OGC_U64(0x850fadc0, 0x9923329e), OGC_U64(0x03e2cf6b, 0xc604ddb0) },
+   { OGC_U64(0xa6539930, 0xbf6bff45), OGC_U64(0x84db8346, 0xb786151c) },
+   { OGC_U64(0xcfe87f7c, 0xef46ff16), OGC_U64(0xe6126418, 0x65679a63) },
+   { OGC_U64(0x81f14fae, 0x158c5f6e), OGC_U64(0x4fcb7e8f, 0x3f60c07e) },
+   { OGC_U64(0xa26da399, 0x9aef7749), OGC_U64(0xe3be5e33, 0x0f38f09d) },
+   { OGC_U64(0xcb090c80, 0x01ab551c), OGC_U64(0x5cadf5bf, 0xd3072cc5) },
+   { OGC_U64(0xfdcb4fa0, 0x02162a63), OGC_U64(0x73d9732f, 0xc7c8f7f6) },
+   { OGC_U64(0x9e9f11c4, 0x014dda7e), OGC_U64(0x2867e7fd, 0xdcdd9afa) },
+   { OGC_U64(0xc646d635, 0x01a1511d), OGC_U64(0xb281e1fd, 0x541501b8) },
+   { OGC_U64(0xf7d88bc2, 0x4209a565), OGC_U64(0x1f225a7c, 0xa91a4226) },
+   { OGC_U64(0x9ae75759, 0x6946075f), OGC_U64(0x3375788d, 0xe9b06958) },
+   { OGC_U64(0xc1a12d2f, 0xc3978937), OGC_U64(0x0052d6b1, 0x641c83ae) },
+   { OGC_U64(0xf209787b, 0xb47d6b84), OGC_U64(0xc0678c5d, 0xbd23a49a) },
+   { OGC_U64(0x9745eb4d, 0x50ce6332), OGC_U64(0xf840b7ba, 0x963646e0) },
+   { OGC_U64(0xbd176620, 0xa501fbff), OGC_U64(0xb650e5a9, 0x3bc3d898) },
+   { OGC_U64(0xec5d3fa8, 0xce427aff), OGC_U64(0xa3e51f13, 0x8ab4cebe) },
+   { OGC_U64(0x93ba47c9, 0x80e98cdf), OGC_U64(0xc66f336c, 0x36b10137) },
+   { OGC_U64(0xb8a8d9bb, 0xe123f017), OGC_U64(0xb80b0047, 0x445d4184) },
+   { OGC_U64(0xe6d3102a, 0xd96cec1d), OGC_U64(0xa60dc059, 0x157491e5) },
+   { OGC_U64(0x9043ea1a, 0xc7e41392), OGC_U64(0x87c89837, 0xad68db2f) },
+   { OGC_U64(0xb454e4a1, 0x79dd1877), OGC_U64(0x29babe45, 0x98c311fb) },
+   { OGC_U64(0xe16a1dc9, 0xd8545e94), OGC_U64(0xf4296dd6, 0xfef3d67a) },
+   { OGC_U64(0x8ce2529e, 0x2734bb1d), OGC_U64(0x1899e4a6, 0x5f58660c) },
+   { OGC_U64(0xb01ae745, 0xb101e9e4), OGC_U64(0x5ec05dcf, 0xf72e7f8f) },
+   { OGC_U64(0xdc21a117, 0x1d42645d), OGC_U64(0x76707543, 0xf4fa1f73) },
+   { OGC_U64(0x899504ae, 0x72497eba), OGC_U64(0x6a06494a, 0x791c53a8) },
+   { OGC_U64(0xabfa45da, 0x0edbde69), OGC_U64(0x0487db9d, 0x17636892) },
+   { OGC_U64(0xd6f8d750, 0x9292d603), OGC_U64(0x45a9d284, 0x5d3c42b6) },
+   { OGC_U64(0x865b8692, 0x5b9bc5c2), OGC_U64(0x0b8a2392, 0xba45a9b2) },
+   { OGC_U64(0xa7f26836, 0xf282b732), OGC_U64(0x8e6cac77, 0x68d7141e) },
+   { OGC_U64(0xd1ef0244, 0xaf2364ff), OGC_U64(0x3207d795, 0x430cd926) },
+   { OGC_U64(0x8335616a, 0xed761f1f), OGC_U64(0x7f44e6bd, 0x49e807b8) },
+   { OGC_U64(0xa402b9c5, 0xa8d3a6e7), OGC_U64(0x5f16206c, 0x9c6209a6) },
+   { OGC_U64(0xcd036837, 0x130890a1), OGC_U64(0x36dba887, 0xc37a8c0f) },
+   { OGC_U64(0x80222122, 0x6be55a64), OGC_U64(0xc2494954, 0xda2c9789) },
+   { OGC_U64(0xa02aa96b, 0x06deb0fd), OGC_U64(0xf2db9baa, 0x10b7bd6c) },
+   { OGC_U64(0xc83553c5, 0xc8965d3d), OGC_U64(0x6f928294, 0x94e5acc7) },
+   { OGC_U64(0xfa42a8b7, 0x3abbf48c), OGC_U64(0xcb772339, 0xba1f17f9) },
+   { OGC_U64(0x9c69a972, 0x84b578d7), OGC_U64(0xff2a7604, 0x14536efb) },
+   { OGC_U64(0xc38413cf, 0x25e2d70d), OGC_U64(0xfef51385, 0x19684aba) },
+   { OGC_U64(0xf46518c2, 0xef5b8cd1), OGC_U64(0x7eb25866, 0x5fc25d69) },
+   { OGC_U64(0x98bf2f79, 0xd5993802), OGC_U64(0xef2f773f, 0xfbd97a61) },
+   { OGC_U64(0xbeeefb58, 0x4aff8603), OGC_U64(0xaafb550f, 0xfacfd8fa) },
+   { OGC_U64(0xeeaaba2e, 0x5dbf6784), OGC_U64(0x95ba2a53, 0xf983cf38) },
+   { OGC_U64(0x952ab45c, 0xfa97a0b2), OGC_U64(0xdd945a74, 0x7bf26183) },
+   { OGC_U64(0xba756174, 0x393d88df), OGC_U64(0x94f97111, 0x9aeef9e4) },
+   { OGC_U64(0xe912b9d1, 0x478ceb17), OGC_U64(0x7a37cd56, 0x01aab85d) },
+   { OGC_U64(0x91abb422, 0xccb812ee), OGC_U64(0xac62e055, 0xc10ab33a) },
+   { OGC_U64(0xb616a12b, 0x7fe617aa), OGC_U64(0x577b986b, 0x314d6009) },
+   { OGC_U64(0xe39c4976, 0x5fdf9d94), OGC_U64(0xed5a7e85, 0xfda0b80b) },
+   { OGC_U64(0x8e41ade9, 0xfbebc27d), OGC_U64(0x14588f13, 0xbe847307) },
+   { OGC_U64(0xb1d21964, 0x7ae6b31c), OGC_U64(0x596eb2d8, 0xae258fc8) },
+   { OGC_U64(0xde469fbd, 0x99a05fe3), OGC_U64(0x6fca5f8e, 0xd9aef3bb) },
+   { OGC_U64(0x8aec23d6, 0x80043bee), OGC_U64(0x25de7bb9, 0x480d5854) },
+   { OGC_U64(0xada72ccc, 0x20054ae9), OGC_U64(0xaf561aa7, 0x9a10ae6a) },
+   { OGC_U64(0xd910f7ff, 0x28069da4), OGC_U64(0x1b2ba151, 0x8094da04) },
+   { OGC_U64(0x87aa9aff, 0x79042286), OGC_U64(0x90fb44d2, 0xf05d0842) },
+   { OGC_U64(0xa99541bf, 0x57452b28), OGC_U64(0x353a1607, 0xac744a53) },
+   { OGC_U64(0xd3fa922f, 0x2d1675f2), OGC_U64(0x42889b89, 0x97915ce8) },
+   { OGC_U64(0x847c9b5d, 0x7c2e09b7), OGC_U64(0x69956135, 0xfebada11) },
+   { OGC_U64(0xa59bc234, 0xdb398c25), OGC_U64(0x43fab983, 0x7e699095) },
+   { OGC_U64(0xcf02b2c2, 0x1207ef2e), OGC_U64(0x94f967e4, 0x5e03f4bb) },
+   { OGC_U64(0x8161afb9, 0x4b44f57d), OGC_U64(0x1d1be0ee, 0xbac278f5) },
+   { OGC_U64(0xa1ba1ba7, 0x9e1632dc), OGC_U64(0x6462d92a, 0x69731732) },
+   { OGC_U64(0xca28a291, 0x859bbf93), OGC_U64(0x7d7b8f75, 0x03cfdcfe) },
+   { OGC_U64(0xfcb2cb35, 0xe702af78), OGC_U64(0x5cda7352, 0x44c3d43e) },
+   { OGC_U64(0x9defbf01, 0xb061adab), OGC_U64(0x3a088813, 0x6afa64a7) },
+   { OGC_U64(0xc56baec2, 0x1c7a1916), OGC_U64(0x088aaa18, 0x45b8fdd0) },
+   { OGC_U64(0xf6c69a72, 0xa3989f5b), OGC_U64(0x8aad549e, 0x57273d45) },
+   { OGC_U64(0x9a3c2087, 0xa63f6399), OGC_U64(0x36ac54e2, 0xf678864b) },
+   { OGC_U64(0xc0cb28a9, 0x8fcf3c7f), OGC_U64(0x84576a1b, 0xb416a7dd) },
+   { OGC_U64(0xf0fdf2d3, 0xf3c30b9f), OGC_U64(0x656d44a2, 0xa11c51d5) },
+   { OGC_U64(0x969eb7c4, 0x7859e743), OGC_U64(0x9f644ae5, 0xa4b1b325) },
+   { OGC_U64(0xbc4665b5, 0x96706114), OGC_U64(0x873d5d9f, 0x0dde1fee) },
+   { OGC_U64(0xeb57ff22, 0xfc0c7959), OGC_U64(0xa90cb506, 0xd155a7ea) },
+   { OGC_U64(0x9316ff75, 0xdd87cbd8), OGC_U64(0x09a7f124, 0x42d588f2) },
+   { OGC_U64(0xb7dcbf53, 0x54e9bece), OGC_U64(0x0c11ed6d, 0x538aeb2f) },
+   { OGC_U64(0xe5d3ef28, 0x2a242e81), OGC_U64(0x8f1668c8, 0xa86da5fa) },
+   { OGC_U64(0x8fa47579, 0x1a569d10), OGC_U64(0xf96e017d, 0x694487bc) },
+   { OGC_U64(0xb38d92d7, 0x60ec4455), OGC_U64(0x37c981dc, 0xc395a9ac) },
+   { OGC_U64(0xe070f78d, 0x3927556a), OGC_U64(0x85bbe253, 0xf47b1417) },
+   { OGC_U64(0x8c469ab8, 0x43b89562), OGC_U64(0x93956d74, 0x78ccec8e) },
+   { OGC_U64(0xaf584166, 0x54a6babb), OGC_U64(0x387ac8d1, 0x970027b2) },
+   { OGC_U64(0xdb2e51bf, 0xe9d0696a), OGC_U64(0x06997b05, 0xfcc0319e) },
+   { OGC_U64(0x88fcf317, 0xf22241e2), OGC_U64(0x441fece3, 0xbdf81f03) },
+   { OGC_U64(0xab3c2fdd, 0xeeaad25a), OGC_U64(0xd527e81c, 0xad7626c3) },
+   { OGC_U64(0xd60b3bd5, 0x6a5586f1), OGC_U64(0x8a71e223, 0xd8d3b074) },
+   { OGC_U64(0x85c70565, 0x62757456), OGC_U64(0xf6872d56, 0x67844e49) },
+   { OGC_U64(0xa738c6be, 0xbb12d16c), OGC_U64(0xb428f8ac, 0x016561db) },
+   { OGC_U64(0xd106f86e, 0x69d785c7), OGC_U64(0xe13336d7, 0x01beba52) },
+   { OGC_U64(0x82a45b45, 0x0226b39c), OGC_U64(0xecc00246, 0x61173473) },
+   { OGC_U64(0xa34d7216, 0x42b06084), OGC_U64(0x27f002d7, 0xf95d0190) },
+   { OGC_U64(0xcc20ce9b, 0xd35c78a5), OGC_U64(0x31ec038d, 0xf7b441f4) },
+   { OGC_U64(0xff290242, 0xc83396ce), OGC_U64(0x7e670471, 0x75a15271) },
+   { OGC_U64(0x9f79a169, 0xbd203e41), OGC_U64(0x0f0062c6, 0xe984d386) },
+   { OGC_U64(0xc75809c4, 0x2c684dd1), OGC_U64(0x52c07b78, 0xa3e60868) },
+   { OGC_U64(0xf92e0c35, 0x37826145), OGC_U64(0xa7709a56, 0xccdf8a82) },
+   { OGC_U64(0x9bbcc7a1, 0x42b17ccb), OGC_U64(0x88a66076, 0x400bb691) },
+   { OGC_U64(0xc2abf989, 0x935ddbfe), OGC_U64(0x6acff893, 0xd00ea435) },
+   { OGC_U64(0xf356f7eb, 0xf83552fe), OGC_U64(0x0583f6b8, 0xc4124d43) },
+   { OGC_U64(0x98165af3, 0x7b2153de), OGC_U64(0xc3727a33, 0x7a8b704a) },
+   { OGC_U64(0xbe1bf1b0, 0x59e9a8d6), OGC_U64(0x744f18c0, 0x592e4c5c) },
+   { OGC_U64(0xeda2ee1c, 0x7064130c), OGC_U64(0x1162def0, 0x6f79df73) },
+   { OGC_U64(0x9485d4d1, 0xc63e8be7), OGC_U64(0x8addcb56, 0x45ac2ba8) },
+   { OGC_U64(0xb9a74a06, 0x37ce2ee1), OGC_U64(0x6d953e2b, 0xd7173692) },
+   { OGC_U64(0xe8111c87, 0xc5c1ba99), OGC_U64(0xc8fa8db6, 0xccdd0437) },
+   { OGC_U64(0x910ab1d4, 0xdb9914a0), OGC_U64(0x1d9c9892, 0x400a22a2) },
+   { OGC_U64(0xb54d5e4a, 0x127f59c8), OGC_U64(0x2503beb6, 0xd00cab4b) },
+   { OGC_U64(0xe2a0b5dc, 0x971f303a), OGC_U64(0x2e44ae64, 0x840fd61d) },
+   { OGC_U64(0x8da471a9, 0xde737e24), OGC_U64(0x5ceaecfe, 0xd289e5d2) },
+   { OGC_U64(0xb10d8e14, 0x56105dad), OGC_U64(0x7425a83e, 0x872c5f47) },
+   { OGC_U64(0xdd50f199, 0x6b947518), OGC_U64(0xd12f124e, 0x28f77719) },
+   { OGC_U64(0x8a5296ff, 0xe33cc92f), OGC_U64(0x82bd6b70, 0xd99aaa6f) },
+   { OGC_U64(0xace73cbf, 0xdc0bfb7b), OGC_U64(0x636cc64d, 0x1001550b) },
+   { OGC_U64(0xd8210bef, 0xd30efa5a), OGC_U64(0x3c47f7e0, 0x5401aa4e) },
+   { OGC_U64(0x8714a775, 0xe3e95c78), OGC_U64(0x65acfaec, 0x34810a71) },
+   { OGC_U64(0xa8d9d153, 0x5ce3b396), OGC_U64(0x7f1839a7, 0x41a14d0d) },
+   { OGC_U64(0xd31045a8, 0x341ca07c), OGC_U64(0x1ede4811, 0x1209a050) },
+   { OGC_U64(0x83ea2b89, 0x2091e44d), OGC_U64(0x934aed0a, 0xab460432) },
+   { OGC_U64(0xa4e4b66b, 0x68b65d60), OGC_U64(0xf81da84d, 0x5617853f) },
+   { OGC_U64(0xce1de406, 0x42e3f4b9), OGC_U64(0x36251260, 0xab9d668e) },
+   { OGC_U64(0x80d2ae83, 0xe9ce78f3), OGC_U64(0xc1d72b7c, 0x6b426019) },
+   { OGC_U64(0xa1075a24, 0xe4421730), OGC_U64(0xb24cf65b, 0x8612f81f) },
+   { OGC_U64(0xc94930ae, 0x1d529cfc), OGC_U64(0xdee033f2, 0x6797b627) },
+   { OGC_U64(0xfb9b7cd9, 0xa4a7443c), OGC_U64(0x169840ef, 0x017da3b1) },
+   { OGC_U64(0x9d412e08, 0x06e88aa5), OGC_U64(0x8e1f2895, 0x60ee864e) },
+   { OGC_U64(0xc491798a, 0x08a2ad4e), OGC_U64(0xf1a6f2ba, 0xb92a27e2) },
+   { OGC_U64(0xf5b5d7ec, 0x8acb58a2), OGC_U64(0xae10af69, 0x6774b1db) },
+   { OGC_U64(0x9991a6f3, 0xd6bf1765), OGC_U64(0xacca6da1, 0xe0a8ef29) },
+   { OGC_U64(0xbff610b0, 0xcc6edd3f), OGC_U64(0x17fd090a, 0x58d32af3) },
+   { OGC_U64(0xeff394dc, 0xff8a948e), OGC_U64(0xddfc4b4c, 0xef07f5b0) },
+   { OGC_U64(0x95f83d0a, 0x1fb69cd9), OGC_U64(0x4abdaf10, 0x1564f98e) },
+   { OGC_U64(0xbb764c4c, 0xa7a4440f), OGC_U64(0x9d6d1ad4, 0x1abe37f1) },
+   { OGC_U64(0xea53df5f, 0xd18d5513), OGC_U64(0x84c86189, 0x216dc5ed) },
+   { OGC_U64(0x92746b9b, 0xe2f8552c), OGC_U64(0x32fd3cf5, 0xb4e49bb4) },
+   { OGC_U64(0xb7118682, 0xdbb66a77), OGC_U64(0x3fbc8c33, 0x221dc2a1) },
+   { OGC_U64(0xe4d5e823, 0x92a40515), OGC_U64(0x0fabaf3f, 0xeaa5334a) },
+   { OGC_U64(0x8f05b116, 0x3ba6832d), OGC_U64(0x29cb4d87, 0xf2a7400e) },
+   { OGC_U64(0xb2c71d5b, 0xca9023f8), OGC_U64(0x743e20e9, 0xef511012) },
+   { OGC_U64(0xdf78e4b2, 0xbd342cf6), OGC_U64(0x914da924, 0x6b255416) },
+   { OGC_U64(0x8bab8eef, 0xb6409c1a), OGC_U64(0x1ad089b6, 0xc2f7548e) },
+   { OGC_U64(0xae9672ab, 0xa3d0c320), OGC_U64(0xa184ac24, 0x73b529b1) },
+   { OGC_U64(0xda3c0f56, 0x8cc4f3e8), OGC_U64(0xc9e5d72d, 0x90a2741e) },
+   { OGC_U64(0x88658996, 0x17fb1871), OGC_U64(0x7e2fa67c, 0x7a658892) },
+   { OGC_U64(0xaa7eebfb, 0x9df9de8d), OGC_U64(0xddbb901b, 0x98feeab7) },
+   { OGC_U64(0xd51ea6fa, 0x85785631), OGC_U64(0x552a7422, 0x7f3ea565) },
+   { OGC_U64(0x8533285c, 0x936b35de), OGC_U64(0xd53a8895, 0x8f87275f) },
+   { OGC_U64(0xa67ff273, 0xb8460356), OGC_U64(0x8a892aba, 0xf368f137) },
+   { OGC_U64(0xd01fef10, 0xa657842c), OGC_U64(0x2d2b7569, 0xb0432d85) },
+   { OGC_U64(0x8213f56a, 0x67f6b29b), OGC_U64(0x9c3b2962, 0x0e29fc73) },
+   { OGC_U64(0xa298f2c5, 0x01f45f42), OGC_U64(0x8349f3ba, 0x91b47b8f) },
+   { OGC_U64(0xcb3f2f76, 0x42717713), OGC_U64(0x241c70a9, 0x36219a73) },
+   { OGC_U64(0xfe0efb53, 0xd30dd4d7), OGC_U64(0xed238cd3, 0x83aa0110) },
+   { OGC_U64(0x9ec95d14, 0x63e8a506), OGC_U64(0xf4363804, 0x324a40aa) },
+   { OGC_U64(0xc67bb459, 0x7ce2ce48), OGC_U64(0xb143c605, 0x3edcd0d5) },
+   { OGC_U64(0xf81aa16f, 0xdc1b81da), OGC_U64(0xdd94b786, 0x8e94050a) },
+   { OGC_U64(0x9b10a4e5, 0xe9913128), OGC_U64(0xca7cf2b4, 0x191c8326) },
+   { OGC_U64(0xc1d4ce1f, 0x63f57d72), OGC_U64(0xfd1c2f61, 0x1f63a3f0) },
+   { OGC_U64(0xf24a01a7, 0x3cf2dccf), OGC_U64(0xbc633b39, 0x673c8cec) },
+   { OGC_U64(0x976e4108, 0x8617ca01), OGC_U64(0xd5be0503, 0xe085d813) },
+   { OGC_U64(0xbd49d14a, 0xa79dbc82), OGC_U64(0x4b2d8644, 0xd8a74e18) },
+   { OGC_U64(0xec9c459d, 0x51852ba2), OGC_U64(0xddf8e7d6, 0x0ed1219e) },
+   { OGC_U64(0x93e1ab82, 0x52f33b45), OGC_U64(0xcabb90e5, 0xc942b503) },
+   { OGC_U64(0xb8da1662, 0xe7b00a17), OGC_U64(0x3d6a751f, 0x3b936243) },
+   { OGC_U64(0xe7109bfb, 0xa19c0c9d), OGC_U64(0x0cc51267, 0x0a783ad4) },
+   { OGC_U64(0x906a617d, 0x450187e2), OGC_U64(0x27fb2b80, 0x668b24c5) },
+   { OGC_U64(0xb484f9dc, 0x9641e9da), OGC_U64(0xb1f9f660, 0x802dedf6) },
+   { OGC_U64(0xe1a63853, 0xbbd26451), OGC_U64(0x5e7873f8, 0xa0396973) },
+   { OGC_U64(0x8d07e334, 0x55637eb2), OGC_U64(0xdb0b487b, 0x6423e1e8) },
+   { OGC_U64(0xb049dc01, 0x6abc5e5f), OGC_U64(0x91ce1a9a, 0x3d2cda62) },
+   { OGC_U64(0xdc5c5301, 0xc56b75f7), OGC_U64(0x7641a140, 0xcc7810fb) },
+   { OGC_U64(0x89b9b3e1, 0x1b6329ba), OGC_U64(0xa9e904c8, 0x7fcb0a9d) },
+   { OGC_U64(0xac2820d9, 0x623bf429), OGC_U64(0x546345fa, 0x9fbdcd44) },
+   { OGC_U64(0xd732290f, 0xbacaf133), OGC_U64(0xa97c1779, 0x47ad4095) },
+   { OGC_U64(0x867f59a9, 0xd4bed6c0), OGC_U64(0x49ed8eab, 0xcccc485d) },
+   { OGC_U64(0xa81f3014, 0x49ee8c70), OGC_U64(0x5c68f256, 0xbfff5a74) },
+   { OGC_U64(0xd226fc19, 0x5c6a2f8c), OGC_U64(0x73832eec, 0x6fff3111) },
+   { OGC_U64(0x83585d8f, 0xd9c25db7), OGC_U64(0xc831fd53, 0xc5ff7eab) },
+   { OGC_U64(0xa42e74f3, 0xd032f525), OGC_U64(0xba3e7ca8, 0xb77f5e55) },
+   { OGC_U64(0xcd3a1230, 0xc43fb26f), OGC_U64(0x28ce1bd2, 0xe55f35eb) },
+   { OGC_U64(0x80444b5e, 0x7aa7cf85), OGC_U64(0x7980d163, 0xcf5b81b3) },
+   { OGC_U64(0xa0555e36, 0x1951c366), OGC_U64(0xd7e105bc, 0xc332621f) },
+   { OGC_U64(0xc86ab5c3, 0x9fa63440), OGC_U64(0x8dd9472b, 0xf3fefaa7) },
+   { OGC_U64(0xfa856334, 0x878fc150), OGC_U64(0xb14f98f6, 0xf0feb951) },
+   { OGC_U64(0x9c935e00, 0xd4b9d8d2), OGC_U64(0x6ed1bf9a, 0x569f33d3) },
+   { OGC_U64(0xc3b83581, 0x09e84f07), OGC_U64(0x0a862f80, 0xec4700c8) },
+   { OGC_U64(0xf4a642e1, 0x4c6262c8), OGC_U64(0xcd27bb61, 0x2758c0fa) },
+   { OGC_U64(0x98e7e9cc, 0xcfbd7dbd), OGC_U64(0x8038d51c, 0xb897789c) },
+   { OGC_U64(0xbf21e440, 0x03acdd2c), OGC_U64(0xe0470a63, 0xe6bd56c3) },
+   { OGC_U64(0xeeea5d50, 0x04981478), OGC_U64(0x1858ccfc, 0xe06cac74) },
+   { OGC_U64(0x95527a52, 0x02df0ccb), OGC_U64(0x0f37801e, 0x0c43ebc8) },
+   { OGC_U64(0xbaa718e6, 0x8396cffd), OGC_U64(0xd3056025, 0x8f54e6ba) },
+   { OGC_U64(0xe950df20, 0x247c83fd), OGC_U64(0x47c6b82e, 0xf32a2069) },
+   { OGC_U64(0x91d28b74, 0x16cdd27e), OGC_U64(0x4cdc331d, 0x57fa5441) },
+   { OGC_U64(0xb6472e51, 0x1c81471d), OGC_U64(0xe0133fe4, 0xadf8e952) },
+   { OGC_U64(0xe3d8f9e5, 0x63a198e5), OGC_U64(0x58180fdd, 0xd97723a6) },
+   { OGC_U64(0x8e679c2f, 0x5e44ff8f), OGC_U64(0x570f09ea, 0xa7ea7648) },
+   { OGC_U64(0xb201833b, 0x35d63f73), OGC_U64(0x2cd2cc65, 0x51e513da) },
+   { OGC_U64(0xde81e40a, 0x034bcf4f), OGC_U64(0xf8077f7e, 0xa65e58d1) },
+   { OGC_U64(0x8b112e86, 0x420f6191), OGC_U64(0xfb04afaf, 0x27faf782) },
+   { OGC_U64(0xadd57a27, 0xd29339f6), OGC_U64(0x79c5db9a, 0xf1f9b563) },
+   { OGC_U64(0xd94ad8b1, 0xc7380874), OGC_U64(0x18375281, 0xae7822bc) },
+   { OGC_U64(0x87cec76f, 0x1c830548), OGC_U64(0x8f229391, 0x0d0b15b5) },
+   { OGC_U64(0xa9c2794a, 0xe3a3c69a), OGC_U64(0xb2eb3875, 0x504ddb22) },
+   { OGC_U64(0xd433179d, 0x9c8cb841), OGC_U64(0x5fa60692, 0xa46151eb) },
+   { OGC_U64(0x849feec2, 0x81d7f328), OGC_U64(0xdbc7c41b, 0xa6bcd333) },
+   { OGC_U64(0xa5c7ea73, 0x224deff3), OGC_U64(0x12b9b522, 0x906c0800) },
+   { OGC_U64(0xcf39e50f, 0xeae16bef), OGC_U64(0xd768226b, 0x34870a00) },
+   { OGC_U64(0x81842f29, 0xf2cce375), OGC_U64(0xe6a11583, 0x00d46640) },
+   { OGC_U64(0xa1e53af4, 0x6f801c53), OGC_U64(0x60495ae3, 0xc1097fd0) },
+   { OGC_U64(0xca5e89b1, 0x8b602368), OGC_U64(0x385bb19c, 0xb14bdfc4) },
+   { OGC_U64(0xfcf62c1d, 0xee382c42), OGC_U64(0x46729e03, 0xdd9ed7b5) },
+   { OGC_U64(0x9e19db92, 0xb4e31ba9), OGC_U64(0x6c07a2c2, 0x6a8346d1) },
+   { OGC_U64(0xc5a05277, 0x621be293), OGC_U64(0xc7098b73, 0x05241885) },
+   { OGC_U64(0xf7086715, 0x3aa2db38), OGC_U64(0xb8cbee4f, 0xc66d1ea7) },
+   { OGC_U64(0x9a65406d, 0x44a5c903), OGC_U64(0x737f74f1, 0xdc043328) },
+   { OGC_U64(0xc0fe9088, 0x95cf3b44), OGC_U64(0x505f522e, 0x53053ff2) },
+   { OGC_U64(0xf13e34aa, 0xbb430a15), OGC_U64(0x647726b9, 0xe7c68fef) },
+   { OGC_U64(0x96c6e0ea, 0xb509e64d), OGC_U64(0x5eca7834, 0x30dc19f5) },
+   { OGC_U64(0xbc789925, 0x624c5fe0), OGC_U64(0xb67d1641, 0x3d132072) },
+   { OGC_U64(0xeb96bf6e, 0xbadf77d8), OGC_U64(0xe41c5bd1, 0x8c57e88f) },
+   { OGC_U64(0x933e37a5, 0x34cbaae7), OGC_U64(0x8e91b962, 0xf7b6f159) },
+   { OGC_U64(0xb80dc58e, 0x81fe95a1), OGC_U64(0x723627bb, 0xb5a4adb0) },
+   { OGC_U64(0xe61136f2, 0x227e3b09), OGC_U64(0xcec3b1aa, 0xa30dd91c) },
+   { OGC_U64(0x8fcac257, 0x558ee4e6), OGC_U64(0x213a4f0a, 0xa5e8a7b1) },
+   { OGC_U64(0xb3bd72ed, 0x2af29e1f), OGC_U64(0xa988e2cd, 0x4f62d19d) },
+   { OGC_U64(0xe0accfa8, 0x75af45a7), OGC_U64(0x93eb1b80, 0xa33b8605) },
+   { OGC_U64(0x8c6c01c9, 0x498d8b88), OGC_U64(0xbc72f130, 0x660533c3) },
+   { OGC_U64(0xaf87023b, 0x9bf0ee6a), OGC_U64(0xeb8fad7c, 0x7f8680b4) },
+   { OGC_U64(0xdb68c2ca, 0x82ed2a05), OGC_U64(0xa67398db, 0x9f6820e1) },
+   { OGC_U64(0x892179be, 0x91d43a43), OGC_U64(0x88083f89, 0x43a1148c) },
+   { OGC_U64(0xab69d82e, 0x364948d4), OGC_U64(0x6a0a4f6b, 0x948959b0) },
+   { OGC_U64(0xd6444e39, 0xc3db9b09), OGC_U64(0x848ce346, 0x79abb01c) },
+   { OGC_U64(0x85eab0e4, 0x1a6940e5), OGC_U64(0xf2d80e0c, 0x0c0b4e11) },
+   { OGC_U64(0xa7655d1d, 0x2103911f), OGC_U64(0x6f8e118f, 0x0f0e2195) },
+   { OGC_U64(0xd13eb464, 0x69447567), OGC_U64(0x4b7195f2, 0xd2d1a9fb) }
+};
+
+/*------------------------------------------------------------------------
+ * the powers of ten that are exact doubles
+ */
+static const double ogc_pow10_exact[] =
+{
+   1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*------------------------------------------------------------------------
+ * count leading zero bits (x is non-zero)
+ */
+static inline int ogc_clz(ogc_uint64 x)
+{
+#if defined(__GNUC__)
+   return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+   unsigned long n;
+   _BitScanReverse64(&n, x);
+   return 63 - static_cast<int>(n);
+#elif defined(_MSC_VER)
+   unsigned long n;
+   if ( _BitScanReverse(&n, static_cast<unsigned long>(x >> 32)) )
+      return 31 - static_cast<int>(n);
+   _BitScanReverse(&n, static_cast<unsigned long>(x));
+   return 63 - static_cast<int>(n);
+#else
+   int n = 0;
+   while ( (x & (static_cast<ogc_uint64>(1) << 63)) == 0 )
+   {
+      x <<= 1;
+      n++;
+   }
+   return n;
+#endif
+}
+
+/*------------------------------------------------------------------------
+ * full 64 x 64 bit multiply, returning the high 64 bits
+ */
+static inline ogc_uint64 ogc_mul128(
+   ogc_uint64   a,
+   ogc_uint64   b,
+   ogc_uint64 * plo)
+{
+#if defined(__SIZEOF_INT128__)
+   __extension__ typedef unsigned __int128 ogc_uint128;
+   ogc_uint128 p = static_cast<ogc_uint128>(a) * b;
+
+   *plo = static_cast<ogc_uint64>(p);
+   return static_cast<ogc_uint64>(p >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+   ogc_uint64 hi;
+
+   *plo = _umul128(a, b, &hi);
+   return hi;
+#else
+   ogc_uint64 a_lo = a & 0xffffffff;
+   ogc_uint64 a_hi = a >> 32;
+   ogc_uint64 b_lo = b & 0xffffffff;
+   ogc_uint64 b_hi = b >> 32;
+   ogc_uint64 ll   = a_lo * b_lo;
+   ogc_uint64 lh   = a_lo * b_hi;
+   ogc_uint64 hl   = a_hi * b_lo;
+   ogc_uint64 hh   = a_hi * b_hi;
+   ogc_uint64 mid  = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+
+   *plo = (mid << 32) | (ll & 0xffffffff);
+   return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/*------------------------------------------------------------------------
+ * make a double from its bits
+ */
+static inline double ogc_bits_to_double(ogc_uint64 bits)
+{
+   double d;
+
+   memcpy(&d, &bits, sizeof(d));
+   return d;
+}
+
+/*------------------------------------------------------------------------
+ * convert w * 10^q to a double (w is non-zero)
+ * returns: false if the rounding can't be decided
+ *
+ * This is the Eisel-Lemire algorithm, as described in "Number Parsing
+ * at a Gigabyte per Second" by Daniel Lemire.
+ */
+static bool ogc_eisel_lemire(
+   ogc_uint64 w,
+   int        q,
+   double *   pd)
+{
+   const ogc_uint64 * p = ogc_pow10_tbl[q - OGC_POW10_MIN];
+   ogc_uint64 x_hi;
+   ogc_uint64 x_lo;
+   ogc_uint64 mantissa;
+   ogc_uint64 exp2;
+   int        clz = ogc_clz(w);
+   int        msb;
+
+   /* normalize w, and get the binary exponent
+      (217706 / 2^16 is log2(10), so this is floor(q * log2(10))) */
+   w  <<= clz;
+   exp2 = static_cast<ogc_uint64>(((217706 * q) >> 16) + 64 + 1023 - clz);
+
+   /* multiply by the high 64 bits of the power, and if the low bits
+      of the result might be off by a carry, by all 128 bits */
+   x_hi = ogc_mul128(w, p[0], &x_lo);
+   if ( (x_hi & 0x1ff) == 0x1ff && x_lo + w < w )
+   {
+      ogc_uint64 y_lo;
+      ogc_uint64 y_hi = ogc_mul128(w, p[1], &y_lo);
+      ogc_uint64 m_hi = x_hi;
+      ogc_uint64 m_lo = x_lo + y_hi;
+
+      if ( m_lo < x_lo )
+         m_hi++;
+      if ( (m_hi & 0x1ff) == 0x1ff && m_lo + 1 == 0 && y_lo + w < w )
+         return false;
+
+      x_hi = m_hi;
+      x_lo = m_lo;
+   }
+
+   /* shift to 54 bits */
+   msb      = static_cast<int>(x_hi >> 63);
+   mantissa = x_hi >> (msb + 9);
+   exp2    -= 1 ^ msb;
+
+   /* exactly half-way can't be decided from the truncated power */
+   if ( x_lo == 0 && (x_hi & 0x1ff) == 0 && (mantissa & 3) == 1 )
+      return false;
+
+   /* round to 53 bits */
+   mantissa += mantissa & 1;
+   mantissa >>= 1;
+   if ( (mantissa >> 53) != 0 )
+   {
+      mantissa >>= 1;
+      exp2++;
+   }
+
+   /* subnormal or infinite */
+   if ( exp2 - 1 >= 0x7ff - 1 )
+      return false;
+
+   *pd = ogc_bits_to_double((exp2 << 52) |
+                            (mantissa & ((static_cast<ogc_uint64>(1) << 52)
+                                         - 1)));
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * convert a number with strtod()
+ *
+ * The '.' is changed to the decimal point of the locale, as strtod()
+ * uses it.  The number of chars used is returned.
+ */
+static double ogc_atod_slow(
+   const char * str,
+   size_t       len,
+   size_t *     plen)
+{
+   char     dec = ogc_string::decimal_point_char();
+   OGC_NBUF tmp;
+   char *   buf = tmp;
+   char *   end;
+   double   num;
+
+   if ( len >= sizeof(tmp) )
+   {
+      buf = ogc_alloc<char>(len + 1);
+      if ( buf == OGC_NULL )
+      {
+         *plen = 0;
+         return 0.0;
+      }
+   }
+
+   memcpy(buf, str, len);
+   buf[len] = 0;
+   for (char * b = buf; *b; b++)
+   {
+      if ( *b == '.' )
+         *b = dec;
+   }
+
+   num   = strtod(buf, &end);
+   *plen = static_cast<size_t>(end - buf);
+
+   if ( buf != tmp )
+      ogc_free(buf);
+
+   return num;
+}
+
+/*------------------------------------------------------------------------
+ * convert a string to a double, given by its length
+ *
+ * The string may have leading whitespace, and the number ends at the
+ * first char that can't be part of it.  If plen is given, it is set to
+ * the number of chars used (0 if there is no number).
+ */
+double ogc_string :: atod(
+   const char * str,
+   size_t       len,
+   size_t *     plen)
+{
+   const char * s;
+   const char * e;
+   const char * digits;
+   ogc_uint64   w     = 0;
+   int          q     = 0;
+   int          nd    = 0;
+   bool         neg   = false;
+   bool         more  = false;
+   bool         any   = false;
+   double       num;
+   size_t       used;
+
+   if ( plen == OGC_NULL )
+      plen = &used;
+   *plen = 0;
+
+   if ( str == OGC_NULL )
+      return 0.0;
+
+   s = str;
+   e = str + len;
+
+   for (; s < e && isspace(static_cast<unsigned char>(*s)); s++) {}
+
+   if ( s < e && (*s == '-' || *s == '+') )
+   {
+      neg = (*s == '-');
+      s++;
+   }
+   digits = s;
+
+   /*---------------------------------------------------------
+    * Get the first 19 significant digits, and the exponent of
+    * the last one kept.
+    */
+   for (; s < e && *s == '0'; s++)
+      any = true;
+
+   for (; s < e && isdigit(static_cast<unsigned char>(*s)); s++)
+   {
+      if ( nd < OGC_ATOD_DIGITS )
+      {
+         w = (w * 10) + static_cast<ogc_uint64>(*s - '0');
+         nd++;
+      }
+      else
+      {
+         q++;
+         if ( *s != '0' )
+            more = true;
+      }
+      any = true;
+   }
+
+   if ( s < e && *s == '.' )
+   {
+      s++;
+
+      if ( nd == 0 )
+      {
+         for (; s < e && *s == '0'; s++)
+         {
+            q--;
+            any = true;
+         }
+      }
+
+      for (; s < e && isdigit(static_cast<unsigned char>(*s)); s++)
+      {
+         if ( nd < OGC_ATOD_DIGITS )
+         {
+            w = (w * 10) + static_cast<ogc_uint64>(*s - '0');
+            nd++;
+            q--;
+         }
+         else
+         {
+            if ( *s != '0' )
+               more = true;
+         }
+         any = true;
+      }
+   }
+
+   /* anything else (such as "inf" or "0x1f") is left to strtod() */
+   if ( !any || (s < e && (*s == 'x' || *s == 'X')) )
+   {
+      num = ogc_atod_slow(str, len, plen);
+      return num;
+   }
+
+   if ( s < e && (*s == 'e' || *s == 'E') )
+   {
+      const char * x     = s + 1;
+      bool         x_neg = false;
+      int          x_num = 0;
+
+      if ( x < e && (*x == '-' || *x == '+') )
+      {
+         x_neg = (*x == '-');
+         x++;
+      }
+
+      if ( x < e && isdigit(static_cast<unsigned char>(*x)) )
+      {
+         for (; x < e && isdigit(static_cast<unsigned char>(*x)); x++)
+         {
+            if ( x_num < OGC_ATOD_EXP_MAX )
+               x_num = (x_num * 10) + (*x - '0');
+         }
+         q += x_neg ? -x_num : x_num;
+         s  = x;
+      }
+   }
+
+   *plen = static_cast<size_t>(s - str);
+
+   /*---------------------------------------------------------
+    * Now convert it.
+    */
+   if ( w == 0 || q < OGC_POW10_MIN )
+   {
+      num = 0.0;
+   }
+   else
+   if ( q > OGC_POW10_MAX )
+   {
+      num = HUGE_VAL;
+   }
+   else
+#if !defined(FLT_EVAL_METHOD) || (FLT_EVAL_METHOD == 0)
+   if ( !more && w <= (static_cast<ogc_uint64>(1) << 53) &&
+        q >= -22 && q <= 22 )
+   {
+      num = static_cast<double>(w);
+      if ( q < 0 )
+         num /= ogc_pow10_exact[-q];
+      else
+         num *= ogc_pow10_exact[q];
+   }
+   else
+#endif
+   {
+      double n2;
+
+      if ( !ogc_eisel_lemire(w, q, &num) ||
+           (more && (!ogc_eisel_lemire(w + 1, q, &n2) || n2 != num)) )
+      {
+         size_t n;
+
+         num = ogc_atod_slow(digits, *plen - (digits - str), &n);
+         if ( neg )
+            num = -num;
+         return num;
+      }
+   }
+
+   return neg ? -num : num;
+}
+
+/*------------------------------------------------------------------------
+ * convert a string to a double
+ */
+double ogc_string :: atod(const char * str)
+{
+   if ( str == OGC_NULL )
+      return 0.0;
+
+   return atod(str, strlen(str), OGC_NULL);
+}
+
+/*------------------------------------------------------------------------
+ * multiply by a power of ten from the table, plus one so it is rounded
+ * up, and return the high 64 bits of the product, with the low bit set
+ * if the bits dropped aren't (almost) zero (round to odd)
+ */
+static inline ogc_uint64 ogc_round_to_odd(
+   const ogc_uint64 * p,
+   ogc_uint64         cp)
+{
+   ogc_uint64 g_lo = p[1] + 1;
+   ogc_uint64 g_hi = p[0] + ((g_lo == 0) ? 1 : 0);
+   ogc_uint64 x_lo;
+   ogc_uint64 x_hi = ogc_mul128(g_lo, cp, &x_lo);
+   ogc_uint64 y_lo;
+   ogc_uint64 y_hi = ogc_mul128(g_hi, cp, &y_lo);
+   ogc_uint64 z    = y_lo + x_hi;
+
+   if ( z < x_hi )
+      y_hi++;
+
+   return y_hi | ((z > 1) ? 1 : 0);
+}
+
+/*------------------------------------------------------------------------
+ * get the shortest decimal w * 10^q that converts back to the double
+ * given by its fraction bits and biased exponent (it isn't zero)
+ * (w may have trailing zeros)
+ *
+ * This is the Schubfach algorithm, as described in "The Schubfach way
+ * to render doubles" by Raffaello Giulietti.
+ */
+static void ogc_shortest(
+   ogc_uint64   frac,
+   int          bexp,
+   ogc_uint64 * pw,
+   int *        pq)
+{
+   const ogc_uint64 * p;
+   ogc_uint64 c;
+   ogc_uint64 cbl, cb, cbr;
+   ogc_uint64 vbl, vb, vbr;
+   ogc_uint64 lower, upper;
+   ogc_uint64 s;
+   int        e;
+   int        k;
+   int        h;
+   bool       even;
+   bool       closer;
+
+   if ( bexp != 0 )
+   {
+      c = frac | (static_cast<ogc_uint64>(1) << 52);
+      e = bexp - 1075;
+
+      /* an integer is just itself */
+      if ( e <= 0 && e > -53 && ((c >> -e) << -e) == c )
+      {
+         *pw = c >> -e;
+         *pq = 0;
+         return;
+      }
+   }
+   else
+   {
+      c = frac;
+      e = 1 - 1075;
+   }
+
+   /* the rounding interval of the double, as 4 * its bounds */
+   even   = ((c & 1) == 0);
+   closer = (frac == 0 && bexp > 1);
+
+   cbl = 4 * c - 2 + (closer ? 1 : 0);
+   cb  = 4 * c;
+   cbr = 4 * c + 2;
+
+   /* k = floor(log10(2^e)), or floor(log10(3/4 * 2^e)) if the lower
+      bound is closer, and h = e + floor(log2(10^-k)) + 1 */
+   k = closer ? ((e * 1262611 - 524031) >> 22) : ((e * 1262611) >> 22);
+   h = e + ((-k * 1741647) >> 19) + 1;
+   p = ogc_pow10_tbl[-k - OGC_POW10_MIN];
+
+   vbl = ogc_round_to_odd(p, cbl << h);
+   vb  = ogc_round_to_odd(p, cb  << h);
+   vbr = ogc_round_to_odd(p, cbr << h);
+
+   lower = vbl + (even ? 0 : 1);
+   upper = vbr - (even ? 0 : 1);
+
+   /* try one digit less first */
+   s = vb >> 2;
+   if ( s >= 10 )
+   {
+      ogc_uint64 sp    = s / 10;
+      bool       up_in = (lower <= 40 * sp);
+      bool       wp_in = (40 * sp + 40 <= upper);
+
+      if ( up_in != wp_in )
+      {
+         *pw = sp + (wp_in ? 1 : 0);
+         *pq = k + 1;
+         return;
+      }
+   }
+
+   /* otherwise whichever of s and s+1 is in it, or is closer */
+   {
+      bool u_in = (lower <= 4 * s);
+      bool w_in = (4 * s + 4 <= upper);
+
+      if ( u_in != w_in )
+      {
+         *pw = s + (w_in ? 1 : 0);
+      }
+      else
+      {
+         ogc_uint64 mid = 4 * s + 2;
+         *pw = s + ((vb > mid || (vb == mid && (s & 1) != 0)) ? 1 : 0);
+      }
+      *pq = k;
+   }
+}
+
+/*------------------------------------------------------------------------
+ * convert a double to a string
+ *
+ * The shortest string that converts back to the same double is used,
+ * and '.' is always the decimal point.  A number from 1e-9 up to 1e16
+ * is written out in full, with at least one digit after the decimal
+ * point (as "0.1" or "6378137.0"), unless that would be more than 24
+ * chars.  Otherwise it has an exponent, as with "%g" (as "1e-10").
+ */
+char * ogc_string :: dtoa(double d, OGC_NBUF buf)
+{
+   ogc_uint64 bits;
+   ogc_uint64 frac;
+   ogc_uint64 w;
+   char       digits[24];
+   char *     b;
+   int        bexp;
+   int        q;
+   int        nd;
+   int        x;
+   int        i;
+
+   if ( buf == OGC_NULL )
+      return OGC_NULL;
+
+   memcpy(&bits, &d, sizeof(bits));
+   frac = bits & ((static_cast<ogc_uint64>(1) << 52) - 1);
+   bexp = static_cast<int>((bits >> 52) & 0x7ff);
+
+   b = buf;
+   if ( (bits >> 63) != 0 && !(bexp == 0x7ff && frac != 0) )
+      *b++ = '-';
+
+   if ( bexp == 0x7ff )
+   {
+      strcpy(b, (frac == 0) ? "inf" : "nan");
+      return buf;
+   }
+
+   if ( bexp == 0 && frac == 0 )
+   {
+      strcpy(b, "0.0");
+      return buf;
+   }
+
+   /* get the digits (backwards), and the exponent of the first one */
+   ogc_shortest(frac, bexp, &w, &q);
+   for (; (w % 10) == 0; w /= 10)
+      q++;
+
+   for (nd = 0; w != 0; nd++)
+   {
+      digits[nd] = static_cast<char>('0' + (w % 10));
+      w /= 10;
+   }
+   x = q + nd - 1;
+
+   if ( x >= 0 && x < 16 )
+   {
+      /* ddd.ddd or ddd000.0 */
+      for (i = 0; i <= x; i++)
+         *b++ = (i < nd) ? digits[nd-1-i] : '0';
+      *b++ = '.';
+      if ( nd <= x + 1 )
+         *b++ = '0';
+      for (; i < nd; i++)
+         *b++ = digits[nd-1-i];
+   }
+   else
+   if ( x < 0 && x >= -9 && (b - buf) + 1 - x + nd <= 24 )
+   {
+      /* 0.000ddd */
+      *b++ = '0';
+      *b++ = '.';
+      for (i = -1; i > x; i--)
+         *b++ = '0';
+      for (i = 0; i < nd; i++)
+         *b++ = digits[nd-1-i];
+   }
+   else
+   {
+      /* d.ddde+xx */
+      *b++ = digits[nd-1];
+      if ( nd > 1 )
+      {
+         *b++ = '.';
+         for (i = 1; i < nd; i++)
+            *b++ = digits[nd-1-i];
+      }
+      *b++ = 'e';
+      *b++ = (x < 0) ? '-' : '+';
+      if ( x < 0 )
+         x = -x;
+      if ( x >= 100 )
+         *b++ = static_cast<char>('0' + (x / 100));
+      *b++ = static_cast<char>('0' + ((x / 10) % 10));
+      *b++ = static_cast<char>('0' + (x % 10));
+   }
+   *b = 0;
+
+   return buf;
+}
+
+} /* namespace OGC */
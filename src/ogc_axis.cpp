@@ -89,7 +89,11 @@ ogc_axis * ogc_axis :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_axis();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      strs.need_name(abbr);
+      p = new (strs.size(), std::nothrow) ogc_axis();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY,
@@ -97,8 +101,9 @@ ogc_axis * ogc_axis :: create(
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
-      ogc_string::unescape_str(p->_abbr, abbr, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
+      p->_abbr = strs.add_name(abbr);
       p->_obj_type  = OGC_OBJ_TYPE_AXIS;
       p->_visible   = true;
       p->_direction = direction;
@@ -144,10 +149,8 @@ ogc_axis * ogc_axis :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_axis *      obj      = OGC_NULL;
    ogc_bearing *   bearing  = OGC_NULL;
@@ -175,35 +178,24 @@ ogc_axis * ogc_axis :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_AXIS )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 2 tokens: AXIS[ "name", direction ...
@@ -214,7 +206,7 @@ ogc_axis * ogc_axis :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 2 && get_strict_parsing() )
+   if ( same > 2 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -231,7 +223,7 @@ ogc_axis * ogc_axis :: from_tokens(
     *    "name (abbr)"
     *    "(abbr)"
     */
-   ogc_string::strncpy(name_buf, arr[start++].str, OGC_NAME_MAX);
+   ogc_string::strncpy(name_buf, t->str(start++), OGC_NAME_MAX);
 
    char * s = strchr(name_buf, '(');
    if ( s != OGC_NULL )
@@ -250,12 +242,12 @@ ogc_axis * ogc_axis :: from_tokens(
       *abbr_buf = 0;
    }
 
-   direction = ogc_utils::axis_kwd_to_direction( arr[start++].str );
+   direction = ogc_utils::axis_kwd_to_direction( t->str(start++) );
 
    if ( !ogc_utils::axis_direction_valid(direction) )
    {
       ogc_error::set(err, OGC_ERR_INVALID_AXIS_DIRECTION,
-         obj_kwd(), arr[start-1].str);
+         obj_kwd(), t->str(start-1));
       bad = true;
    }
 
@@ -265,126 +257,118 @@ ogc_axis * ogc_axis :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_bearing::is_kwd(arr[i].str) )
-      {
-         if ( bearing != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_BEARING, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            bearing = ogc_bearing::from_tokens(t, i, &next, err);
-            if ( bearing == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_meridian::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         if ( meridian != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_MERIDIAN, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            meridian = ogc_meridian::from_tokens(t, i, &next, err);
-            if ( meridian == OGC_NULL )
+         case OGC_OBJ_TYPE_BEARING:
+            if ( bearing != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_BEARING, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               bearing = ogc_bearing::from_tokens(t, i, &next, err);
+               if ( bearing == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_order::is_kwd(arr[i].str) )
-      {
-         if ( order != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ORDER, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            order = ogc_order::from_tokens(t, i, &next, err);
-            if ( order == OGC_NULL )
+         case OGC_OBJ_TYPE_MERIDIAN:
+            if ( meridian != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_MERIDIAN, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               meridian = ogc_meridian::from_tokens(t, i, &next, err);
+               if ( meridian == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_unit     ::is_kwd(arr[i].str) ||
-           ogc_angunit  ::is_kwd(arr[i].str) ||
-           ogc_lenunit  ::is_kwd(arr[i].str) ||
-           ogc_paramunit::is_kwd(arr[i].str) ||
-           ogc_scaleunit::is_kwd(arr[i].str) ||
-           ogc_timeunit ::is_kwd(arr[i].str) )
-      {
-         if ( unit != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            unit = ogc_unit::from_tokens(t, i, &next, err);
-            if ( unit == OGC_NULL )
+         case OGC_OBJ_TYPE_ORDER:
+            if ( order != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ORDER, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               order = ogc_order::from_tokens(t, i, &next, err);
+               if ( order == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
+         case OGC_OBJ_TYPE_UNIT:
+         case OGC_OBJ_TYPE_ANGUNIT:
+         case OGC_OBJ_TYPE_LENUNIT:
+         case OGC_OBJ_TYPE_PARAMUNIT:
+         case OGC_OBJ_TYPE_SCALEUNIT:
+         case OGC_OBJ_TYPE_TIMEUNIT:
+            if ( unit != OGC_NULL )
             {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               unit = ogc_unit::from_tokens(t, i, &next, err);
+               if ( unit == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               bad = true;
+            }
+            else
+            {
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -394,6 +378,8 @@ ogc_axis * ogc_axis :: from_tokens(
     */
    if ( !bad )
    {
+      unit = ogc_share_obj(unit);
+
       obj = create(name_buf, abbr_buf, direction, bearing, meridian, order,
                    unit, ids, err);
    }
@@ -418,7 +404,7 @@ ogc_axis * ogc_axis :: from_wkt(
    ogc_error *  err)
 {
    ogc_axis * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -452,76 +438,65 @@ bool ogc_axis :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_bearing;
-   OGC_TBUF      buf_meridian;
-   OGC_TBUF      buf_order;
-   OGC_TBUF      buf_unit;
-   OGC_TBUF      buf_id;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_axis :: to_wkt(
+   const ogc_axis * obj,
+   ogc_wkt_writer & w,
+   int              options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_axis :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    OGC_NAME      buf_name;
    const char *  axis_dir;
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
    name_and_abbr(buf_name);
    axis_dir = ogc_utils::axis_direction_to_kwd(_direction);
 
-   rc &= ogc_bearing  :: to_wkt(_bearing,  buf_bearing,  opts, OGC_TBUF_MAX);
-   rc &= ogc_meridian :: to_wkt(_meridian, buf_meridian, opts, OGC_TBUF_MAX);
-   rc &= ogc_order    :: to_wkt(_order,    buf_order,    opts, OGC_TBUF_MAX);
-
+   w.open(kwd, options);
+   w.put_str(buf_name);
+   w.put(axis_dir);
+   rc &= ogc_bearing  :: to_wkt(_bearing,  w, opts);
+   rc &= ogc_meridian :: to_wkt(_meridian, w, opts);
+   rc &= ogc_order    :: to_wkt(_order,    w, opts);
    if ( (opts & OGC_WKT_OPT_OLD_SYNTAX) == 0 )
-      rc &= ogc_unit :: to_wkt(_unit, buf_unit, opts, OGC_TBUF_MAX);
-   else
-      *buf_unit = 0;
-
-   sprintf(buf_hdr, "%s%s\"%s\",%s",
-      kwd, opn, buf_name, axis_dir);
-
-   OGC_CPY_TO_BUF( buf_hdr      );
-   OGC_ADD_TO_BUF( buf_bearing  );
-   OGC_ADD_TO_BUF( buf_meridian );
-   OGC_ADD_TO_BUF( buf_order    );
-   OGC_ADD_TO_BUF( buf_unit     );
+      rc &= ogc_unit :: to_wkt(_unit, w, opts);
 
    if ( _ids != OGC_NULL && (options & OGC_WKT_OPT_NO_IDS) == 0 )
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
          if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
             break;
       }
    }
 
-   OGC_CPY_TO_BUF( cls );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.close(options);
 
    return rc;
 }
@@ -541,7 +516,7 @@ ogc_axis * ogc_axis :: clone() const
    ogc_bearing *  bearing  = ogc_bearing  :: clone( _bearing  );
    ogc_meridian * meridian = ogc_meridian :: clone( _meridian );
    ogc_order *    order    = ogc_order    :: clone( _order    );
-   ogc_unit *     unit     = ogc_unit     :: clone( _unit     );
+   ogc_unit *     unit     = ogc_share_clone( _unit );
    ogc_vector *   ids      = ogc_vector   :: clone( _ids      );
 
    ogc_axis * p = create(_name,
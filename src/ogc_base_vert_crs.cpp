@@ -69,19 +69,33 @@ ogc_base_vert_crs * ogc_base_vert_crs :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_base_vert_crs();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_base_vert_crs();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
-      p->_obj_type = OGC_OBJ_TYPE_BASE_VERT_CRS;
-      p->_visible  = true;
-      p->_crs_type = OGC_CRS_TYPE_BASE_VERT;
-      p->_datum    = datum;
-      p->_unit     = unit;
+      strs.begin(p);
+      p->_name = strs.add_name(name);
+      p->_obj_type      = OGC_OBJ_TYPE_BASE_VERT_CRS;
+      p->_visible       = true;
+      p->_crs_type      = OGC_CRS_TYPE_BASE_VERT;
+      p->_base_crs      = OGC_NULL;
+      p->_deriving_conv = OGC_NULL;
+      p->_datum         = datum;
+      p->_unit          = unit;
+      p->_cs            = OGC_NULL;
+      p->_axis_1        = OGC_NULL;
+      p->_axis_2        = OGC_NULL;
+      p->_axis_3        = OGC_NULL;
+      p->_scope         = OGC_NULL;
+      p->_extents       = OGC_NULL;
+      p->_ids           = OGC_NULL;
+      p->_remark        = OGC_NULL;
    }
 
    return p;
@@ -118,10 +132,8 @@ ogc_base_vert_crs * ogc_base_vert_crs :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_base_vert_crs * obj     = OGC_NULL;
    ogc_vert_datum *    datum   = OGC_NULL;
@@ -143,35 +155,24 @@ ogc_base_vert_crs * ogc_base_vert_crs :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_BASE_VERT_CRS )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: BASEVERTCRS[ "name" ...
@@ -182,7 +183,7 @@ ogc_base_vert_crs * ogc_base_vert_crs :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -194,7 +195,7 @@ ogc_base_vert_crs * ogc_base_vert_crs :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name = arr[start++].str;
+   name = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -202,42 +203,41 @@ ogc_base_vert_crs * ogc_base_vert_crs :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_vert_datum::is_kwd(arr[i].str) )
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
+
+      switch (arr[i].type)
       {
-         if ( datum != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_DATUM, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            datum = ogc_vert_datum::from_tokens(t, i, &next, err);
-            if ( datum == OGC_NULL )
+         case OGC_OBJ_TYPE_VERT_DATUM:
+            if ( datum != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_DATUM, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               datum = ogc_vert_datum::from_tokens(t, i, &next, err);
+               if ( datum == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_lenunit::is_kwd(arr[i].str) )
-      {
-         if ( unit != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            unit = ogc_lenunit::from_tokens(t, i, &next, err);
-            if ( unit == OGC_NULL )
+         case OGC_OBJ_TYPE_LENUNIT:
+         case OGC_OBJ_TYPE_UNIT:
+            if ( unit != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               unit = ogc_lenunit::from_tokens(t, i, &next, err);
+               if ( unit == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -247,6 +247,8 @@ ogc_base_vert_crs * ogc_base_vert_crs :: from_tokens(
     */
    if ( !bad )
    {
+      unit = ogc_share_obj(unit);
+
       obj = create(name, datum, unit, err);
    }
 
@@ -267,7 +269,7 @@ ogc_base_vert_crs * ogc_base_vert_crs :: from_wkt(
    ogc_error *  err)
 {
    ogc_base_vert_crs * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -301,50 +303,45 @@ bool ogc_base_vert_crs :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_datum;
-   OGC_TBUF      buf_unit;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_base_vert_crs :: to_wkt(
+   const ogc_base_vert_crs * obj,
+   ogc_wkt_writer &          w,
+   int                       options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_base_vert_crs :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
-   rc &= ogc_vert_datum :: to_wkt(_datum,  buf_datum,   opts, OGC_TBUF_MAX);
-   rc &= ogc_unit          :: to_wkt(_unit,   buf_unit,    opts, OGC_TBUF_MAX);
-
-   ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\"",
-      kwd, opn, buf_name);
-
-   OGC_CPY_TO_BUF( buf_hdr    );
-   OGC_ADD_TO_BUF( buf_datum  );
-   OGC_ADD_TO_BUF( buf_unit   );
-   OGC_CPY_TO_BUF( cls        );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.open(kwd, options);
+   w.put_str(_name);
+   rc &= ogc_vert_datum :: to_wkt(_datum, w, opts);
+   rc &= ogc_unit       :: to_wkt(_unit,  w, opts);
+   w.close(options);
 
    return rc;
 }
@@ -364,7 +361,7 @@ ogc_base_vert_crs * ogc_base_vert_crs :: clone() const
    ogc_lenunit * u = reinterpret_cast<ogc_lenunit *>(_unit);
 
    ogc_vert_datum *  datum   = ogc_vert_datum :: clone( _datum   );
-   ogc_lenunit *     lenunit = ogc_lenunit    :: clone( u        );
+   ogc_lenunit *     lenunit = ogc_share_clone( u );
 
    ogc_base_vert_crs * p = create(_name,
                                  datum,
@@ -0,0 +1,223 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* parallel batch parsing                                                    */
+/*                                                                           */
+/* The strings are split into one part per thread.  Each thread takes small  */
+/* chunks from the front of its own part, and when that is empty it steals   */
+/* chunks from the other parts, so threads that get easy strings help the    */
+/* ones that get hard ones.  A chunk is taken by atomically bumping the      */
+/* next index of a part, so no locks are needed.                             */
+/*                                                                           */
+/* Each result is stored by the index of its string, so the results are the  */
+/* same no matter which thread parsed which string.                          */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+#define OGC_BATCH_CHUNK  32    /* number of strings taken at a time */
+#define OGC_BATCH_LINE   64    /* cache line size                   */
+
+/*------------------------------------------------------------------------
+ * a part of the strings
+ * (each is on its own cache line, as they are bumped by all threads)
+ */
+struct ogc_batch_part
+{
+   volatile size_t next;      /* next string to take */
+   size_t          end;       /* end of the part     */
+   char            pad [OGC_BATCH_LINE - 2 * sizeof(size_t)];
+};
+
+/*------------------------------------------------------------------------
+ * a batch
+ */
+struct ogc_batch
+{
+   const char * const * wkts;
+   ogc_object **        out;
+   ogc_error *          errs;
+   bool                 strict;
+   int                  nparts;
+   ogc_batch_part *     parts;
+   volatile size_t      count;     /* number of objects parsed */
+};
+
+/*------------------------------------------------------------------------
+ * BATCH_PARSER constructor
+ */
+ogc_batch_parser :: ogc_batch_parser(bool strict) :
+   _t(OGC_TOKEN_MODE_SPAN)
+{
+   _ctx.set_strict(strict);
+   _ctx.set_quiet(true);   /* errors are returned, not sent */
+   _t.set_ctx(&_ctx);
+}
+
+/*------------------------------------------------------------------------
+ * parse a string
+ */
+ogc_object * ogc_batch_parser :: parse(
+   const char * str,
+   ogc_error *  err)
+{
+   ogc_error    e;
+   ogc_error *  perr = ogc_parse_ctx::begin_err(&_ctx, err, &e);
+   ogc_object * obj  = OGC_NULL;
+
+   if ( _t.tokenize(str, ogc_object::obj_kwd(), perr) )
+   {
+      obj = ogc_object::from_tokens(&_t, 0, OGC_NULL, perr);
+   }
+   ogc_parse_ctx::end_err(err, perr);
+
+   return obj;
+}
+
+/*------------------------------------------------------------------------
+ * parse a string given by its length
+ */
+ogc_object * ogc_batch_parser :: parse(
+   const char * str,
+   size_t       len,
+   ogc_error *  err)
+{
+   ogc_error    e;
+   ogc_error *  perr = ogc_parse_ctx::begin_err(&_ctx, err, &e);
+   ogc_object * obj  = OGC_NULL;
+
+   if ( _t.tokenize(str, len, ogc_object::obj_kwd(), perr) )
+   {
+      obj = ogc_object::from_tokens(&_t, 0, OGC_NULL, perr);
+   }
+   ogc_parse_ctx::end_err(err, perr);
+
+   return obj;
+}
+
+/*------------------------------------------------------------------------
+ * run one thread of a batch
+ */
+static void ogc_batch_run(
+   void * data,
+   int    n)
+{
+   ogc_batch *      b = static_cast<ogc_batch *>(data);
+   ogc_batch_parser parser(b->strict);
+   size_t           count = 0;
+
+   /* take from our own part first, and then from the others */
+   for (int k = 0; k < b->nparts; k++)
+   {
+      ogc_batch_part * p = b->parts + ((n + k) % b->nparts);
+
+      for (;;)
+      {
+         size_t i = ogc_thread::atomic_add(&p->next, OGC_BATCH_CHUNK);
+         size_t end;
+
+         if ( i >= p->end )
+            break;
+
+         end = (p->end - i > OGC_BATCH_CHUNK) ? (i + OGC_BATCH_CHUNK) :
+                                                p->end;
+         for (; i < end; i++)
+         {
+            ogc_error * err = (b->errs != OGC_NULL) ? (b->errs + i) :
+                                                      OGC_NULL;
+
+            b->out[i] = parser.parse(b->wkts[i], err);
+            if ( b->out[i] != OGC_NULL )
+               count++;
+         }
+      }
+   }
+
+   ogc_thread::atomic_add(&b->count, count);
+}
+
+/*------------------------------------------------------------------------
+ * objects from many WKT strings
+ * returns: the number of objects parsed
+ */
+size_t ogc_object :: from_wkt_batch(
+   const char * const * wkts,
+   size_t               n,
+   ogc_object **        out,
+   ogc_error *          errs,
+   int                  nthreads)
+{
+   ogc_batch        b;
+   ogc_batch_part * parts;
+   size_t           nchunks;
+
+   if ( wkts == OGC_NULL || out == OGC_NULL || n == 0 )
+      return 0;
+
+   /* no more threads than there are chunks */
+   nchunks = (n + (OGC_BATCH_CHUNK-1)) / OGC_BATCH_CHUNK;
+   if ( nthreads <= 0 )
+      nthreads = ogc_thread::cpu_count();
+   if ( nthreads > OGC_THREADS_MAX )
+      nthreads = OGC_THREADS_MAX;
+   if ( static_cast<size_t>(nthreads) > nchunks )
+      nthreads = static_cast<int>(nchunks);
+
+   parts = ogc_alloc<ogc_batch_part>(nthreads);
+   if ( parts == OGC_NULL )
+   {
+      nthreads = 1;
+      parts    = OGC_NULL;
+   }
+
+   b.wkts   = wkts;
+   b.out    = out;
+   b.errs   = errs;
+   b.strict = get_strict_parsing();
+   b.count  = 0;
+
+   if ( parts == OGC_NULL )
+   {
+      /* just parse them all in this thread */
+      ogc_batch_part p;
+
+      p.next   = 0;
+      p.end    = n;
+      b.nparts = 1;
+      b.parts  = &p;
+      ogc_batch_run(&b, 0);
+
+      return b.count;
+   }
+
+   for (int k = 0; k < nthreads; k++)
+   {
+      parts[k].next = (n / nthreads) * k;
+      parts[k].end  = (k == nthreads-1) ? n : (n / nthreads) * (k+1);
+   }
+   b.nparts = nthreads;
+   b.parts  = parts;
+
+   ogc_thread::run(nthreads, ogc_batch_run, &b);
+
+   ogc_free(parts);
+   return b.count;
+}
+
+} /* namespace OGC */
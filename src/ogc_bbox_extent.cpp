@@ -121,10 +121,8 @@ ogc_bbox_extent * ogc_bbox_extent :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  same;
    int  end;
-   int  num;
 
    ogc_bbox_extent *  obj  = OGC_NULL;
    double ll_lat;
@@ -147,35 +145,24 @@ ogc_bbox_extent * ogc_bbox_extent :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_BBOX_EXTENT )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 4 tokens: BBOX[ ll_lat, ll_lon, ur_lat, ur_lon ...
@@ -186,7 +173,7 @@ ogc_bbox_extent * ogc_bbox_extent :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 4 && get_strict_parsing() )
+   if ( same > 4 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -198,10 +185,10 @@ ogc_bbox_extent * ogc_bbox_extent :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   ll_lat = ogc_string::atod( arr[start++].str );
-   ll_lon = ogc_string::atod( arr[start++].str );
-   ur_lat = ogc_string::atod( arr[start++].str );
-   ur_lon = ogc_string::atod( arr[start++].str );
+   ll_lat = t->num(start++);
+   ll_lon = t->num(start++);
+   ur_lat = t->num(start++);
+   ur_lon = t->num(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -209,14 +196,7 @@ ogc_bbox_extent * ogc_bbox_extent :: from_tokens(
 #if 0 /* who cares? */
    int  next = 0;
    for (int i = start; i < end; i = next)
-   {
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
-            break;
-      }
-   }
+   {   }
 #endif
 
    /*---------------------------------------------------------
@@ -242,7 +222,7 @@ ogc_bbox_extent * ogc_bbox_extent :: from_wkt(
    ogc_error *  err)
 {
    ogc_bbox_extent * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -276,26 +256,32 @@ bool ogc_bbox_extent :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_TBUF      buf_hdr;
-   OGC_NBUF      buf_ll_lat;
-   OGC_NBUF      buf_ll_lon;
-   OGC_NBUF      buf_ur_lat;
-   OGC_NBUF      buf_ur_lon;
-   size_t        len   = 0;
-   bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
-   const char *  kwd   = obj_kwd();
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
+   return (rc && w.ok());
+}
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_bbox_extent :: to_wkt(
+   const ogc_bbox_extent * obj,
+   ogc_wkt_writer &        w,
+   int                     options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_bbox_extent :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
+   bool          rc    = true;
+   const char *  kwd   = obj_kwd();
 
    if ( !is_visible() )
       return true;
@@ -303,22 +289,12 @@ bool ogc_bbox_extent :: to_wkt(
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       return true;
 
-   ogc_string :: dtoa(_ll_lat, buf_ll_lat);
-   ogc_string :: dtoa(_ll_lon, buf_ll_lon);
-   ogc_string :: dtoa(_ur_lat, buf_ur_lat);
-   ogc_string :: dtoa(_ur_lon, buf_ur_lon);
-
-   sprintf(buf_hdr, "%s%s%s,%s,%s,%s",
-      kwd, opn, buf_ll_lat, buf_ll_lon, buf_ur_lat, buf_ur_lon);
-
-   OGC_CPY_TO_BUF( buf_hdr );
-   OGC_CPY_TO_BUF( cls     );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.open(kwd, options);
+   w.put_num(_ll_lat);
+   w.put_num(_ll_lon);
+   w.put_num(_ur_lat);
+   w.put_num(_ur_lon);
+   w.close(options);
 
    return rc;
 }
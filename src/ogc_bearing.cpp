@@ -100,10 +100,8 @@ ogc_bearing * ogc_bearing :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_bearing * obj     = OGC_NULL;
    ogc_angunit * angunit = OGC_NULL;
@@ -124,35 +122,24 @@ ogc_bearing * ogc_bearing :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_BEARING )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: BEARING[ value ...
@@ -163,7 +150,7 @@ ogc_bearing * ogc_bearing :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -175,7 +162,7 @@ ogc_bearing * ogc_bearing :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   value = ogc_string::atod( arr[start++].str );
+   value = t->num(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -183,26 +170,26 @@ ogc_bearing * ogc_bearing :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_id::is_kwd(arr[i].str) )
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
+
+      switch (arr[i].type)
       {
-         if ( angunit != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ANCHOR, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            angunit = ogc_angunit::from_tokens(t, i, &next, err);
-            if ( angunit == OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            if ( angunit != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ANCHOR, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               angunit = ogc_angunit::from_tokens(t, i, &next, err);
+               if ( angunit == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -212,6 +199,8 @@ ogc_bearing * ogc_bearing :: from_tokens(
     */
    if ( !bad )
    {
+      angunit = ogc_share_obj(angunit);
+
       obj = create(value, angunit, err);
    }
 
@@ -231,7 +220,7 @@ ogc_bearing * ogc_bearing :: from_wkt(
    ogc_error *  err)
 {
    ogc_bearing * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -265,51 +254,47 @@ bool ogc_bearing :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_angunit;
-   OGC_NBUF      buf_value;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_bearing :: to_wkt(
+   const ogc_bearing * obj,
+   ogc_wkt_writer &    w,
+   int                 options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_bearing :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       return true;
 
-   ogc_string :: dtoa(_value, buf_value);
-
-   rc &= ogc_angunit :: to_wkt(_angunit, buf_angunit, opts, OGC_TBUF_MAX);
-
-   sprintf(buf_hdr, "%s%s%s",
-      kwd, opn, buf_value);
-
-   OGC_CPY_TO_BUF( buf_hdr     );
-   OGC_ADD_TO_BUF( buf_angunit );
-   OGC_CPY_TO_BUF( cls         );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.open(kwd, options);
+   w.put_num(_value);
+   rc &= ogc_angunit :: to_wkt(_angunit, w, opts);
+   w.close(options);
 
    return rc;
 }
@@ -326,7 +311,7 @@ ogc_bearing * ogc_bearing :: clone(const ogc_bearing * obj)
 
 ogc_bearing * ogc_bearing :: clone() const
 {
-   ogc_angunit * angunit = ogc_angunit :: clone( _angunit );
+   ogc_angunit * angunit = ogc_share_clone( _angunit );
 
    ogc_bearing * p = create(_value,
                             angunit,
@@ -122,10 +122,8 @@ ogc_bound_crs * ogc_bound_crs :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_bound_crs * obj        = OGC_NULL;
    ogc_crs *       source_crs = OGC_NULL;
@@ -150,35 +148,24 @@ ogc_bound_crs * ogc_bound_crs :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_BOUND_CRS )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: BOUNDCRS[ ...
@@ -189,7 +176,7 @@ ogc_bound_crs * ogc_bound_crs :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 0 && get_strict_parsing() )
+   if ( same > 0 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -208,121 +195,116 @@ ogc_bound_crs * ogc_bound_crs :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_string::is_equal(arr[i].str, OGC_OBJ_KWD_SOURCE_CRS) )
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
+
+      switch (arr[i].type)
       {
-         if ( source_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SOURCE_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            source_crs = ogc_crs::from_tokens(t, i+1, &next, err);
-            if ( source_crs == OGC_NULL )
+         case OGC_OBJ_TYPE_ABRTRANS:
+            if ( abrtrans != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ABRTRANS, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               abrtrans = ogc_abrtrans::from_tokens(t, i, &next, err);
+               if ( abrtrans == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_string::is_equal(arr[i].str, OGC_OBJ_KWD_TARGET_CRS) )
-      {
-         if ( target_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_TARGET_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            target_crs = ogc_crs::from_tokens(t, i+1, &next, err);
-            if ( target_crs == OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               if ( ids == OGC_NULL )
+               {
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
+               }
 
-      if ( ogc_abrtrans::is_kwd(arr[i].str) )
-      {
-         if ( abrtrans != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ABRTRANS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            abrtrans = ogc_abrtrans::from_tokens(t, i, &next, err);
-            if ( abrtrans == OGC_NULL )
+               if ( ids != OGC_NULL )
+               {
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
+                     delete id;
+                     bad = true;
+                  }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
+               }
+            }
+            break;
+
+         case OGC_OBJ_TYPE_REMARK:
+            if ( remark != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               remark = ogc_remark::from_tokens(t, i, &next, err);
+               if ( remark == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
+         default:
+            /* these are not objects, so have no object type */
+            if ( ogc_string::is_equal(t->str(i), OGC_OBJ_KWD_SOURCE_CRS) )
             {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
+               if ( source_crs != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
+                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SOURCE_CRS,
+                     obj_kwd());
                   bad = true;
                }
+               else
+               {
+                  source_crs = ogc_crs::from_tokens(t, i+1, &next, err);
+                  if ( source_crs == OGC_NULL )
+                     bad = true;
+               }
             }
-
-            if ( ids != OGC_NULL )
+            else if ( ogc_string::is_equal(t->str(i), OGC_OBJ_KWD_TARGET_CRS) )
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( target_crs != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
+                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_TARGET_CRS,
+                     obj_kwd());
                   bad = true;
                }
                else
                {
-                  if ( ids->add( id ) < 0 )
-                  {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                     delete id;
+                  target_crs = ogc_crs::from_tokens(t, i+1, &next, err);
+                  if ( target_crs == OGC_NULL )
                      bad = true;
-                  }
                }
             }
-         }
-         continue;
-      }
-
-      if ( ogc_remark::is_kwd(arr[i].str) )
-      {
-         if ( remark != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            remark = ogc_remark::from_tokens(t, i, &next, err);
-            if ( remark == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
-
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
             break;
       }
    }
@@ -355,7 +337,7 @@ ogc_bound_crs * ogc_bound_crs :: from_wkt(
    ogc_error *  err)
 {
    ogc_bound_crs * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -389,76 +371,65 @@ bool ogc_bound_crs :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_TBUF      buf_hdr;
-   OGC_BUFF      buf_source_crs;
-   OGC_BUFF      buf_source;
-   OGC_BUFF      buf_target_crs;
-   OGC_BUFF      buf_target;
-   OGC_TBUF      buf_abrtrans;
-   OGC_TBUF      buf_id;
-   OGC_TBUF      buf_remark;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_bound_crs :: to_wkt(
+   const ogc_bound_crs * obj,
+   ogc_wkt_writer &      w,
+   int                   options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_bound_crs :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       return true;
 
-   rc &= ogc_crs :: to_wkt(_source_crs,    buf_source_crs, opts, OGC_BUFF_MAX-8);
-   rc &= ogc_crs :: to_wkt(_target_crs,    buf_target_crs, opts, OGC_BUFF_MAX-8);
-   rc &= ogc_abrtrans :: to_wkt(_abrtrans, buf_abrtrans,   opts, OGC_TBUF_MAX);
-   rc &= ogc_remark   :: to_wkt(_remark,   buf_remark,     opts, OGC_TBUF_MAX);
-
-   sprintf(buf_source, "%s%s%s%s",
-      OGC_OBJ_KWD_SOURCE_CRS, opn, buf_source_crs, cls);
+   w.open(kwd, options);
 
-   sprintf(buf_target, "%s%s%s%s",
-      OGC_OBJ_KWD_TARGET_CRS, opn, buf_target_crs, cls);
+   w.open(OGC_OBJ_KWD_SOURCE_CRS, options);
+   rc &= ogc_crs :: to_wkt(_source_crs, w, opts);
+   w.close(options);
 
-   sprintf(buf_hdr, "%s%s",
-      kwd, opn);
+   w.open(OGC_OBJ_KWD_TARGET_CRS, options);
+   rc &= ogc_crs :: to_wkt(_target_crs, w, opts);
+   w.close(options);
 
-   OGC_CPY_TO_BUF( buf_hdr      );
-   OGC_CPY_TO_BUF( buf_source   );
-   OGC_ADD_TO_BUF( buf_target   );
-   OGC_ADD_TO_BUF( buf_abrtrans );
+   rc &= ogc_abrtrans :: to_wkt(_abrtrans, w, opts);
 
    if ( _ids != OGC_NULL && (options & OGC_WKT_OPT_NO_IDS) == 0 )
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
       }
    }
 
-   OGC_ADD_TO_BUF( buf_remark );
-   OGC_CPY_TO_BUF( cls        );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   rc &= ogc_remark :: to_wkt(_remark, w, opts);
+   w.close(options);
 
    return rc;
 }
@@ -106,42 +106,490 @@ public:
 };
 
 /* ------------------------------------------------------------------------- */
-/* internal WKT output processing                                            */
+/* structural-char scanning (see ogc_simd.cpp)                               */
 /* ------------------------------------------------------------------------- */
 
-#define OGC_TBUF_MAX          2048    /* temp WKT buffer for sub-objects */
-typedef char                  OGC_TBUF [OGC_TBUF_MAX];
+#if defined(_MSC_VER)
+   typedef unsigned __int64    ogc_uint64;
+#else
+   typedef unsigned long long  ogc_uint64;
+#endif
 
-#define OGC_WKT_OPT_INTERNAL  0x8000  /* internal call */
+class ogc_simd
+{
+private:
+    ogc_simd() {}
+   ~ogc_simd() {}
+
+public:
+   /* Find the positions of all quote chars, and of all "[](),"
+      chars that are not within quotes.  The idx array must have
+      room for len entries.  Returns the number of positions found. */
+   static int structurals(
+      const char * str,
+      int          len,
+      int *        idx);
+
+   /* name of the instruction set being used */
+   static const char * name();
+};
+
+/* ------------------------------------------------------------------------- */
+/* keyword classification (see ogc_keyword.cpp)                              */
+/* ------------------------------------------------------------------------- */
+
+class ogc_keyword
+{
+private:
+    ogc_keyword() {}
+   ~ogc_keyword() {}
+
+public:
+   /* Get the object type of a keyword (OGC_OBJ_TYPE_UNKNOWN if it is
+      not one), and whether it is an old (WKT1) keyword.  If len is
+      negative, the string is null-terminated. */
+   static ogc_obj_type lookup(
+      const char * str,
+      int          len,
+      bool *       old);
+};
+
+#if defined(_MSC_VER)
+#  define OGC_THREAD_LOCAL  __declspec(thread)
+#else
+#  define OGC_THREAD_LOCAL  __thread
+#endif
+
+/* ------------------------------------------------------------------------- */
+/* memory allocation (see ogc_alloc.cpp)                                     */
+/* ------------------------------------------------------------------------- */
+
+#define OGC_ALLOC_HDR  16   /* size of the header (keeps 16-byte alignment) */
+
+/*------------------------------------------------------------------------
+ * header on each piece of memory
+ * (the allocator is null for scratch memory, which is never freed)
+ */
+struct ogc_alloc_hdr
+{
+   ogc_allocator * alloc;
+   size_t          size    : sizeof(size_t) * 8 - 1;
+   size_t          counted : 1;   /* allocated while counting */
+};
+
+/*------------------------------------------------------------------------
+ * An ogc_alloc_scope is put at the start of each method that parses
+ * with a context, so all memory allocated in this thread until it
+ * returns comes from the context's allocator (if it has one).  The
+ * allocator in use before is set back when the method returns.
+ */
+class ogc_alloc_scope
+{
+private:
+   ogc_allocator * _prev;
+   bool            _set;
+
+public:
+    ogc_alloc_scope(const ogc_parse_ctx * ctx)
+   {
+      _set  = (ctx != OGC_NULL && ctx->allocator() != OGC_NULL);
+      _prev = _set ? ogc_allocator::use(ctx->allocator()) : OGC_NULL;
+   }
+
+   ~ogc_alloc_scope()
+   {
+      if ( _set )
+         ogc_allocator::use(_prev);
+   }
+};
+
+/*------------------------------------------------------------------------
+ * make an internal object in memory from the current allocator
+ * (or delete one), as only objects and vectors have their own new
+ */
+template <class T>
+inline T * ogc_new()
+{
+   void * p = ogc_allocator::current()->alloc(sizeof(T));
+   return (p == OGC_NULL) ? OGC_NULL : new (p) T();
+}
+
+template <class T>
+inline void ogc_delete(T * p)
+{
+   if ( p != OGC_NULL )
+   {
+      p->~T();
+      ogc_allocator::free(p);
+   }
+}
+
+/*------------------------------------------------------------------------
+ * allocate (or free) an array of plain data from the current allocator
+ */
+template <class T>
+inline T * ogc_alloc(size_t n)
+{
+   return static_cast<T *>( ogc_allocator::current()->alloc(n * sizeof(T)) );
+}
+
+inline void ogc_free(void * p)
+{
+   ogc_allocator::free(p);
+}
+
+/*------------------------------------------------------------------------
+ * get the allocator a piece of memory came from (null if scratch memory)
+ */
+inline ogc_allocator * ogc_alloc_of(const void * p)
+{
+   const char * h = static_cast<const char *>(p) - OGC_ALLOC_HDR;
+   return reinterpret_cast<const ogc_alloc_hdr *>(h)->alloc;
+}
+
+/* ------------------------------------------------------------------------- */
+/* object memory: scratch memory and arenas (see ogc_scratch.cpp)            */
+/* ------------------------------------------------------------------------- */
+
+struct ogc_scratch_block;
+
+class ogc_scratch
+{
+private:
+   ogc_scratch_block * _head;
+   ogc_scratch_block * _cur;
+   char *              _pos;
+   size_t              _size;   /* total size of all blocks            */
+   ogc_scratch *       _prev;   /* memory taken from before begin()    */
+
+   void * take(size_t size);
+
+public:
+    ogc_scratch();
+   ~ogc_scratch();
+
+   /* Start or stop taking all object memory (in this thread) from this
+      scratch memory.  Stopping goes back to taking it from where it was
+      taken from before. */
+   void          begin();
+   void          end();
+
+   /* Discard everything taken (without destroying it), but keep the
+      memory for the next time. */
+   void          reset();
+
+   /* Get the total size of the memory held. */
+   size_t        size() const { return _size; }
+
+   /* Get memory for an object or a vector, from the scratch memory
+      being taken from (in this thread), or else from the current
+      allocator (OGC_NULL if out of memory).  It is freed by
+      ogc_allocator::free(), which does nothing for scratch memory (it
+      is only discarded all at once). */
+   static void * alloc(size_t size);
+
+   /* Check if object memory is being taken from scratch memory (in
+      this thread). */
+   static bool   in_use();
+
+   /* Check if memory (from alloc()) is scratch memory. */
+   static bool   is_scratch(const void * p)
+   {
+      const char * h = static_cast<const char *>(p) - OGC_ALLOC_HDR;
+      return (reinterpret_cast<const ogc_alloc_hdr *>(h)->alloc == OGC_NULL);
+   }
+};
+
+/* ------------------------------------------------------------------------- */
+/* object strings                                                            */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * hash of a string (FNV-1a)
+ */
+inline size_t ogc_hash(
+   const char * str,
+   size_t       len)
+{
+   const unsigned char * s = reinterpret_cast<const unsigned char *>(str);
+   size_t                h = 2166136261U;
+
+   for (; len > 0; len--)
+      h = (h ^ *s++) * 16777619U;
+
+   return h;
+}
+
+/*------------------------------------------------------------------------
+ * An ogc_str_pool lays out the strings of an object (its name, and any
+ * other text) in extra bytes right after it, so each takes only the
+ * room it needs (and none if it is empty), and they are all in the same
+ * memory as the object:
+ *
+ *    ogc_str_pool strs;
+ *
+ *    strs.need(name);
+ *    p = new (strs.size(), std::nothrow) ogc_xxx();
+ *    ...
+ *    strs.begin(p);
+ *    p->_name = strs.add(name);
+ *
+ * The strings are unescaped as they are added, just as
+ * ogc_string::unescape_str() does.
+ *
+ * Names use need_name() and add_name() instead (in the same order), so
+ * they are shared from the intern table (see ogc_intern.cpp) when it is
+ * on, and only take room after the object when it is off.
+ */
+#define OGC_STR_POOL_NAMES  2   /* max names of an object */
+
+class ogc_str_pool
+{
+private:
+   size_t       _size;
+   char *       _pos;
+   const char * _names[OGC_STR_POOL_NAMES];
+   int          _num_names;
+   int          _next_name;
+
+   static const char * intern(const char * str);
+
+public:
+    ogc_str_pool() : _size(0), _pos(OGC_NULL), _num_names(0), _next_name(0) {}
+
+   /* add the room a string needs */
+   void need(const char * str)
+   {
+      int len = ogc_string::unescape_len(str);
+      if ( len > 0 )
+         _size += static_cast<size_t>(len) + 1;
+   }
+
+   /* add the room a name needs (none if it is interned) */
+   void need_name(const char * str)
+   {
+      const char * s = ogc_intern::enabled() ? intern(str) : OGC_NULL;
+
+      _names[_num_names++] = s;
+      if ( s == OGC_NULL )
+         need(str);
+   }
+
+   size_t size() const { return _size; }
+
+   /* start adding strings right after an object */
+   template <class T>
+   void begin(T * obj)
+   {
+      _pos = reinterpret_cast<char *>(obj) + sizeof(T);
+   }
+
+   /* add a string, returning where it is */
+   const char * add(const char * str)
+   {
+      int    len = ogc_string::unescape_len(str);
+      char * s   = _pos;
+
+      if ( len == 0 )
+         return "";
+
+      ogc_string::unescape_str(s, str, static_cast<size_t>(len) + 1);
+      _pos += len + 1;
+      return s;
+   }
+
+   /* add a name, returning where it is */
+   const char * add_name(const char * str)
+   {
+      const char * s = _names[_next_name++];
+      return (s != OGC_NULL) ? s : add(str);
+   }
+};
+
+/* ------------------------------------------------------------------------- */
+/* sharing of sub-objects (see ogc_share.cpp)                                */
+/* ------------------------------------------------------------------------- */
+
+class ogc_share_table
+{
+private:
+    ogc_share_table() {}
+   ~ogc_share_table() {}
+
+public:
+   /* Get the object to use for a sub-object that we built, and that an
+      object is about to be created with: a shared one identical to it
+      from the same allocator (and the sub-object is destroyed), or else
+      the sub-object itself, now shared (unless sharing is off or it
+      can't be shared). */
+   static ogc_object * share(ogc_object * obj);
+
+   /* Add an owner to a shared object, returning false if it can't have
+      another (or sharing is off, or it is from another allocator than
+      the one in use). */
+   static bool add_ref(const ogc_object * obj);
+
+   /* Drop one owner of a shared object, returning true if it was the
+      last one (so it is to be deleted). */
+   static bool release(ogc_object * obj);
+};
+
+/*------------------------------------------------------------------------
+ * share a sub-object we built (see above), just before the object that
+ * is to have it is created, as unit = ogc_share_obj(unit)
+ *
+ * A sub-object passed to a create() method by a caller is never shared,
+ * so it is always the one that the object has.
+ */
+template <class T>
+inline T * ogc_share_obj(T * obj)
+{
+   return static_cast<T *>( ogc_share_table::share(obj) );
+}
+
+/*------------------------------------------------------------------------
+ * get a sub-object for a clone: the same object with another owner if it
+ * is shared, or else a copy of it, shared if it can be
+ */
+template <class T>
+inline T * ogc_share_clone(const T * obj)
+{
+   if ( obj != OGC_NULL && obj->is_shared() &&
+        ogc_share_table::add_ref(obj) )
+   {
+      return const_cast<T *>(obj);
+   }
+
+   return ogc_share_obj( T::clone(obj) );
+}
+
+/* ------------------------------------------------------------------------- */
+/* threads (see ogc_thread.cpp)                                              */
+/* ------------------------------------------------------------------------- */
+
+#define OGC_THREADS_MAX  256   /* max number of threads used */
+
+class ogc_thread
+{
+private:
+    ogc_thread() {}
+   ~ogc_thread() {}
+
+public:
+   typedef void (OGC_THREAD_RTN) (
+      void * data,
+      int    n);
+
+   /* Call rtn(data, n) for each n from 0 to count-1, each in its own
+      thread (0 is called in this thread), and wait for them all.  If a
+      thread can't be started, its call is made in this thread. */
+   static void run(
+      int              count,
+      OGC_THREAD_RTN * rtn,
+      void *           data);
+
+   /* number of processors (at least 1) */
+   static int cpu_count();
+
+   /* add to a value atomically, returning its old value */
+   static size_t atomic_add(
+      volatile size_t * p,
+      size_t            n);
+
+   /* get a pointer set by atomic_cas() (in another thread), so that
+      what it points to is seen as it was when it was set */
+   static void * atomic_get(
+      void * volatile * p);
 
-#define OGC_ADD_TO_BUF(s)     \
-   if ( *s != 0 )             \
-   {                          \
-      len += strlen(s) + 1;   \
-      if ( len < (buflen-1) ) \
-      {                       \
-         strcat(buffer, ","); \
-         strcat(buffer, s);   \
-      }                       \
-      else                    \
-      {                       \
-         rc = false;          \
-      }                       \
+   /* set a pointer to n atomically if it is still old, returning its
+      value before (so the set was done if that is old) */
+   static void * atomic_cas(
+      void * volatile * p,
+      void *            old,
+      void *            n);
+};
+
+/* ------------------------------------------------------------------------- */
+/* error positions                                                           */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * An ogc_err_pos is put at the start of each from_tokens() method, so
+ * the errors kept by the context (if it keeps them) while the object is
+ * built are given the offset of its keyword.  The position of the parent
+ * object is set back when the method returns.
+ *
+ * It also holds an ogc_alloc_scope, so an object (and its sub-objects)
+ * built from tokens with a context takes its memory from the context's
+ * allocator (if it has one).
+ */
+class ogc_err_pos
+{
+private:
+   const ogc_parse_ctx * _ctx;
+   size_t                _prev;
+   ogc_alloc_scope       _scope;
+
+public:
+    ogc_err_pos(const ogc_token * t, int start) :
+      _scope(t->ctx())
+   {
+      _ctx  = t->ctx();
+      _prev = OGC_ERR_POS_NONE;
+      if ( _ctx != OGC_NULL && (!_ctx->keep_errs() ||
+                                start < 0 || start >= t->_num) )
+         _ctx = OGC_NULL;
+
+      if ( _ctx != OGC_NULL )
+      {
+         int off = t->_arr[start].off;
+         _prev = _ctx->set_err_pos( (off < 0) ? OGC_ERR_POS_NONE :
+                                    static_cast<size_t>(off) );
+      }
    }
 
-#define OGC_CPY_TO_BUF(s)     \
-   if ( *s != 0 )             \
-   {                          \
-      len += strlen(s);       \
-      if ( len < (buflen-1) ) \
-      {                       \
-         strcat(buffer, s);   \
-      }                       \
-      else                    \
-      {                       \
-         rc = false;          \
-      }                       \
+   ~ogc_err_pos()
+   {
+      if ( _ctx != OGC_NULL )
+         _ctx->set_err_pos(_prev);
    }
+};
+
+/* ------------------------------------------------------------------------- */
+/* parsing in threads (see ogc_batch.cpp)                                    */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * parser for one thread
+ *
+ * Each thread has its own context and tokens, which are re-used for all
+ * the strings it parses.  Errors are only returned, as the global error
+ * routine must not be called from the threads.
+ */
+class ogc_batch_parser
+{
+private:
+   ogc_parse_ctx _ctx;
+   ogc_token     _t;
+
+public:
+   ogc_batch_parser(bool strict);
+
+   ogc_object * parse(
+      const char * str,
+      ogc_error *  err);
+
+   ogc_object * parse(
+      const char * str,
+      size_t       len,
+      ogc_error *  err);
+};
+
+/* ------------------------------------------------------------------------- */
+/* internal WKT output processing                                            */
+/* ------------------------------------------------------------------------- */
+
+#define OGC_WKT_OPT_INTERNAL  0x8000  /* internal call */
 
 /* ------------------------------------------------------------------------- */
 
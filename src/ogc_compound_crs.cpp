@@ -117,14 +117,18 @@ ogc_compound_crs * ogc_compound_crs :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_compound_crs();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_compound_crs();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type   = OGC_OBJ_TYPE_COMPOUND_CRS;
       p->_visible    = true;
       p->_crs_type   = OGC_CRS_TYPE_COMPOUND;
@@ -179,10 +183,8 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_compound_crs * obj        = OGC_NULL;
    ogc_crs *          first_crs  = OGC_NULL;
@@ -208,38 +210,27 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( ogc_string::is_equal(kwd, old_kwd()) )
+   if ( arr[start].type == OGC_OBJ_TYPE_COMPOUND_CRS && arr[start].old )
       return from_tokens_old(t, start, pend, err);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_COMPOUND_CRS )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: COMPOUNDCRS[ "name" ...
@@ -250,7 +241,7 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -262,7 +253,7 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name = arr[start++].str;
+   name = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -270,132 +261,124 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_geod_crs::is_kwd(arr[i].str) ||
-           ogc_proj_crs::is_kwd(arr[i].str) ||
-           ogc_engr_crs::is_kwd(arr[i].str) )
-      {
-         if ( first_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_FIRST_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            first_crs = ogc_crs::from_tokens(t, i, &next, err);
-            if ( first_crs == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_vert_crs ::is_kwd(arr[i].str) ||
-           ogc_param_crs::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         if ( second_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SECOND_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            second_crs = ogc_crs::from_tokens(t, i, &next, err);
-            if ( second_crs == OGC_NULL )
+         case OGC_OBJ_TYPE_GEOD_CRS:
+         case OGC_OBJ_TYPE_PROJ_CRS:
+         case OGC_OBJ_TYPE_ENGR_CRS:
+            if ( first_crs != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_FIRST_CRS, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               first_crs = ogc_crs::from_tokens(t, i, &next, err);
+               if ( first_crs == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_time_crs::is_kwd(arr[i].str) )
-      {
-         if ( (second_crs != OGC_NULL &&
-               second_crs->crs_type() == OGC_CRS_TYPE_TIME) ||
-              third_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_TIME_CRS, obj_kwd());
-            bad = true;
-         }
-         else if ( second_crs == OGC_NULL )
-         {
-            second_crs = ogc_time_crs::from_tokens(t, i, &next, err);
-            if ( second_crs == OGC_NULL )
-               bad = true;
-         }
-         else if ( third_crs == OGC_NULL )
-         {
-            third_crs = ogc_time_crs::from_tokens(t, i, &next, err);
-            if ( third_crs == OGC_NULL )
+         case OGC_OBJ_TYPE_VERT_CRS:
+         case OGC_OBJ_TYPE_PARAM_CRS:
+            if ( second_crs != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SECOND_CRS, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               second_crs = ogc_crs::from_tokens(t, i, &next, err);
+               if ( second_crs == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
+         case OGC_OBJ_TYPE_TIME_CRS:
+            if ( (second_crs != OGC_NULL &&
+                  second_crs->crs_type() == OGC_CRS_TYPE_TIME) ||
+                 third_crs != OGC_NULL )
             {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_TIME_CRS, obj_kwd());
+               bad = true;
+            }
+            else if ( second_crs == OGC_NULL )
+            {
+               second_crs = ogc_time_crs::from_tokens(t, i, &next, err);
+               if ( second_crs == OGC_NULL )
                   bad = true;
-               }
             }
+            else if ( third_crs == OGC_NULL )
+            {
+               third_crs = ogc_time_crs::from_tokens(t, i, &next, err);
+               if ( third_crs == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               bad = true;
+            }
+            else
+            {
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      if ( ogc_remark::is_kwd(arr[i].str) )
-      {
-         if ( remark != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            remark = ogc_remark::from_tokens(t, i, &next, err);
-            if ( remark == OGC_NULL )
+         case OGC_OBJ_TYPE_REMARK:
+            if ( remark != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               remark = ogc_remark::from_tokens(t, i, &next, err);
+               if ( remark == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -432,10 +415,8 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens_old(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_compound_crs * obj        = OGC_NULL;
    ogc_crs *          first_crs  = OGC_NULL;
@@ -459,35 +440,24 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens_old(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !ogc_string::is_equal(kwd, old_kwd()) )
+   if ( arr[start].type != OGC_OBJ_TYPE_COMPOUND_CRS || !arr[start].old )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: COMPOUNDCRS[ "name" ...
@@ -498,7 +468,7 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens_old(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -510,7 +480,7 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens_old(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name = arr[start++].str;
+   name = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -518,90 +488,86 @@ ogc_compound_crs * ogc_compound_crs :: from_tokens_old(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_geod_crs::is_kwd(arr[i].str) ||
-           ogc_proj_crs::is_kwd(arr[i].str) )
-      {
-         if ( first_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_FIRST_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            first_crs = ogc_crs::from_tokens(t, i, &next, err);
-            if ( first_crs == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_vert_crs ::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         if ( second_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SECOND_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            second_crs = ogc_crs::from_tokens(t, i, &next, err);
-            if ( second_crs == OGC_NULL )
+         case OGC_OBJ_TYPE_GEOD_CRS:
+         case OGC_OBJ_TYPE_PROJ_CRS:
+            if ( first_crs != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_FIRST_CRS, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               first_crs = ogc_crs::from_tokens(t, i, &next, err);
+               if ( first_crs == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
+         case OGC_OBJ_TYPE_VERT_CRS:
+            if ( second_crs != OGC_NULL )
             {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SECOND_CRS, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               second_crs = ogc_crs::from_tokens(t, i, &next, err);
+               if ( second_crs == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -632,7 +598,7 @@ ogc_compound_crs * ogc_compound_crs :: from_wkt(
    ogc_error *  err)
 {
    ogc_compound_crs * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -666,72 +632,61 @@ bool ogc_compound_crs :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_BUFF      buf_first;
-   OGC_BUFF      buf_second;
-   OGC_BUFF      buf_third;
-   OGC_TBUF      buf_id;
-   OGC_TBUF      buf_remark;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_compound_crs :: to_wkt(
+   const ogc_compound_crs * obj,
+   ogc_wkt_writer &         w,
+   int                      options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_compound_crs :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
    if ( (opts & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       kwd = old_kwd();
 
-   rc &= ogc_crs      :: to_wkt(_first_crs,  buf_first,  opts, OGC_BUFF_MAX);
-   rc &= ogc_crs      :: to_wkt(_second_crs, buf_second, opts, OGC_BUFF_MAX);
-   rc &= ogc_time_crs :: to_wkt(_third_crs,  buf_third,  opts, OGC_BUFF_MAX);
-   rc &= ogc_remark   :: to_wkt(_remark,     buf_remark, opts, OGC_TBUF_MAX);
-
-   ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\"",
-      kwd, opn, buf_name);
-
-   OGC_CPY_TO_BUF( buf_hdr    );
-   OGC_ADD_TO_BUF( buf_first  );
-   OGC_ADD_TO_BUF( buf_second );
-   OGC_ADD_TO_BUF( buf_third  );
+   w.open(kwd, options);
+   w.put_str(_name);
+   rc &= ogc_crs      :: to_wkt(_first_crs,  w, opts);
+   rc &= ogc_crs      :: to_wkt(_second_crs, w, opts);
+   rc &= ogc_time_crs :: to_wkt(_third_crs,  w, opts);
 
    if ( _ids != OGC_NULL && (options & OGC_WKT_OPT_NO_IDS) == 0 )
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
          if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
             break;
       }
    }
 
-   OGC_ADD_TO_BUF( buf_remark );
-   OGC_CPY_TO_BUF( cls        );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   rc &= ogc_remark :: to_wkt(_remark, w, opts);
+   w.close(options);
 
    return rc;
 }
@@ -70,14 +70,18 @@ ogc_conversion * ogc_conversion :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_conversion();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_conversion();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type   = OGC_OBJ_TYPE_CONVERSION;
       p->_visible    = true;
       p->_method     = method;
@@ -120,10 +124,8 @@ ogc_conversion * ogc_conversion :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_conversion * obj        = OGC_NULL;
    ogc_id *         id         = OGC_NULL;
@@ -148,35 +150,24 @@ ogc_conversion * ogc_conversion :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_CONVERSION )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: METHOD[ "name" ...
@@ -187,7 +178,7 @@ ogc_conversion * ogc_conversion :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -199,7 +190,7 @@ ogc_conversion * ogc_conversion :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name = arr[start++].str;
+   name = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -207,120 +198,116 @@ ogc_conversion * ogc_conversion :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_method::is_kwd(arr[i].str) )
-      {
-         if ( method != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_METHOD, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            method = ogc_method::from_tokens(t, i, &next, err);
-            if ( method == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_parameter::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         param = ogc_parameter::from_tokens(t, i, &next, err);
-         if ( param == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( parameters == OGC_NULL )
+         case OGC_OBJ_TYPE_METHOD:
+            if ( method != OGC_NULL )
             {
-               parameters = ogc_vector::create(1, 1);
-               if ( parameters == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete param;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_METHOD, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               method = ogc_method::from_tokens(t, i, &next, err);
+               if ( method == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( parameters != OGC_NULL )
+         case OGC_OBJ_TYPE_PARAMETER:
+            param = ogc_parameter::from_tokens(t, i, &next, err);
+            if ( param == OGC_NULL )
             {
-               void * p = parameters->find(
-                             param,
-                             false,
-                             ogc_utils::compare_parameter);
-               if ( p != OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAMETER,
-                     obj_kwd(), param->name());
-                  delete param;
-                  bad = true;
-               }
-               else
+               bad = true;
+            }
+            else
+            {
+               if ( parameters == OGC_NULL )
                {
-                  if ( parameters->add( param ) < 0 )
+                  parameters = ogc_vector::create(1, 1);
+                  if ( parameters == OGC_NULL )
                   {
                      ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
                      delete param;
                      bad = true;
                   }
                }
-            }
-         }
-         continue;
-      }
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
-            {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
+               if ( parameters != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
-                  bad = true;
+                  void * p = parameters->find(
+                                param,
+                                false,
+                                ogc_utils::compare_parameter);
+                  if ( p != OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAMETER,
+                        obj_kwd(), param->name());
+                     delete param;
+                     bad = true;
+                  }
+                  else
+                  {
+                     if ( parameters->add( param ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete param;
+                        bad = true;
+                     }
+                  }
                }
             }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -334,6 +321,8 @@ ogc_conversion * ogc_conversion :: from_tokens(
     */
    if ( !bad )
    {
+      method = ogc_share_obj(method);
+
       obj = create(name, method, parameters, ids, err);
    }
 
@@ -355,7 +344,7 @@ ogc_conversion * ogc_conversion :: from_wkt(
    ogc_error *  err)
 {
    ogc_conversion * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -389,56 +378,57 @@ bool ogc_conversion :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_method;
-   OGC_TBUF      buf_parameter;
-   OGC_TBUF      buf_id;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_conversion :: to_wkt(
+   const ogc_conversion * obj,
+   ogc_wkt_writer &       w,
+   int                    options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_conversion :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
-   rc &= ogc_method :: to_wkt(_method, buf_method, opts, OGC_TBUF_MAX);
-
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) == 0 )
    {
-      ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-      sprintf(buf_hdr, "%s%s\"%s\"",
-         kwd, opn, buf_name);
 
-      OGC_CPY_TO_BUF( buf_hdr    );
-      OGC_ADD_TO_BUF( buf_method );
+      w.open(kwd, options);
+      w.put_str(_name);
+      rc &= ogc_method :: to_wkt(_method, w, opts);
    }
    else
    {
-      OGC_CPY_TO_BUF( buf_method );
+      rc &= ogc_method :: to_wkt(_method, w, opts);
    }
 
    if ( _parameters != OGC_NULL )
    {
       for (int i = 0; i < parameter_count(); i++)
       {
-         rc &= ogc_parameter :: to_wkt(parameter(i), buf_parameter, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_parameter );
+         rc &= ogc_parameter :: to_wkt(parameter(i), w, opts);
       }
    }
 
@@ -448,20 +438,13 @@ bool ogc_conversion :: to_wkt(
       {
          for (int i = 0; i < id_count(); i++)
          {
-            rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-            OGC_ADD_TO_BUF( buf_id );
+            rc &= ogc_id :: to_wkt(id(i), w, opts);
          }
       }
    }
 
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) == 0 )
-      OGC_CPY_TO_BUF( cls );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+      w.close(options);
 
    return rc;
 }
@@ -478,7 +461,7 @@ ogc_conversion * ogc_conversion :: clone(const ogc_conversion * obj)
 
 ogc_conversion * ogc_conversion :: clone() const
 {
-   ogc_method * method     = ogc_method :: clone( _method     );
+   ogc_method * method     = ogc_share_clone( _method );
    ogc_vector * parameters = ogc_vector :: clone( _parameters );
    ogc_vector * ids        = ogc_vector :: clone( _ids        );
 
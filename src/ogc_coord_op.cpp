@@ -90,14 +90,18 @@ ogc_coord_op * ogc_coord_op :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_coord_op();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_coord_op();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type        = OGC_OBJ_TYPE_COORD_OP;
       p->_visible         = true;
       p->_source_crs      = source_crs;
@@ -156,10 +160,8 @@ ogc_coord_op * ogc_coord_op :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_coord_op *    obj         = OGC_NULL;
    ogc_crs *         source_crs  = OGC_NULL;
@@ -194,35 +196,24 @@ ogc_coord_op * ogc_coord_op :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_COORD_OP )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: COORDOP[ "name" ...
@@ -233,7 +224,7 @@ ogc_coord_op * ogc_coord_op :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -245,7 +236,7 @@ ogc_coord_op * ogc_coord_op :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name = arr[start++].str;
+   name = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -253,312 +244,298 @@ ogc_coord_op * ogc_coord_op :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_string::is_equal(arr[i].str, OGC_OBJ_KWD_SOURCE_CRS) )
-      {
-         if ( source_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SOURCE_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            source_crs = ogc_crs::from_tokens(t, i+1, &next, err);
-            if ( source_crs == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
-
-      if ( ogc_string::is_equal(arr[i].str, OGC_OBJ_KWD_TARGET_CRS) )
-      {
-         if ( target_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_TARGET_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            target_crs = ogc_crs::from_tokens(t, i+1, &next, err);
-            if ( target_crs == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
-
-      if ( ogc_string::is_equal(arr[i].str, OGC_OBJ_KWD_INTERP_CRS) )
-      {
-         if ( interp_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_INTERP_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            interp_crs = ogc_crs::from_tokens(t, i+1, &next, err);
-            if ( interp_crs == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_method::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         if ( method != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_METHOD, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            method = ogc_method::from_tokens(t, i, &next, err);
-            if ( method == OGC_NULL )
+         case OGC_OBJ_TYPE_METHOD:
+            if ( method != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_METHOD, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
-
-      /* must check PARAMETERFILE before PARAMETER */
-      if ( ogc_param_file::is_kwd(arr[i].str) )
-      {
-         param_file = ogc_param_file::from_tokens(t, i, &next, err);
-         if ( param_file == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( param_files == OGC_NULL )
+            }
+            else
             {
-               param_files = ogc_vector::create(1, 1);
-               if ( param_files == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete param_file;
+               method = ogc_method::from_tokens(t, i, &next, err);
+               if ( method == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( param_files != OGC_NULL )
+         case OGC_OBJ_TYPE_PARAM_FILE:
+            param_file = ogc_param_file::from_tokens(t, i, &next, err);
+            if ( param_file == OGC_NULL )
             {
-               void * p = param_files->find(
-                             param_file,
-                             false,
-                             ogc_utils::compare_param_file);
-               if ( p != OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAM_FILE,
-                     obj_kwd(), param_file->name());
-                  delete param_file;
-                  bad = true;
-               }
-               else
+               bad = true;
+            }
+            else
+            {
+               if ( param_files == OGC_NULL )
                {
-                  if ( param_files->add( param_file ) < 0 )
+                  param_files = ogc_vector::create(1, 1);
+                  if ( param_files == OGC_NULL )
                   {
                      ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
                      delete param_file;
                      bad = true;
                   }
                }
-            }
-         }
-         continue;
-      }
 
-      if ( ogc_parameter::is_kwd(arr[i].str) )
-      {
-         param = ogc_parameter::from_tokens(t, i, &next, err);
-         if ( param == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( parameters == OGC_NULL )
-            {
-               parameters = ogc_vector::create(1, 1);
-               if ( parameters == OGC_NULL )
+               if ( param_files != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete param;
-                  bad = true;
+                  void * p = param_files->find(
+                                param_file,
+                                false,
+                                ogc_utils::compare_param_file);
+                  if ( p != OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAM_FILE,
+                        obj_kwd(), param_file->name());
+                     delete param_file;
+                     bad = true;
+                  }
+                  else
+                  {
+                     if ( param_files->add( param_file ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete param_file;
+                        bad = true;
+                     }
+                  }
                }
             }
+            break;
 
-            if ( parameters != OGC_NULL )
+         case OGC_OBJ_TYPE_PARAMETER:
+            param = ogc_parameter::from_tokens(t, i, &next, err);
+            if ( param == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = parameters->find(
-                             param,
-                             false,
-                             ogc_utils::compare_parameter);
-               if ( p != OGC_NULL )
+               if ( parameters == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAMETER,
-                     obj_kwd(), param->name());
-                  delete param;
-                  bad = true;
+                  parameters = ogc_vector::create(1, 1);
+                  if ( parameters == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete param;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( parameters != OGC_NULL )
                {
-                  if ( parameters->add( param ) < 0 )
+                  void * p = parameters->find(
+                                param,
+                                false,
+                                ogc_utils::compare_parameter);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_PARAMETER,
+                        obj_kwd(), param->name());
                      delete param;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( parameters->add( param ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete param;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      if ( ogc_op_accuracy::is_kwd(arr[i].str) )
-      {
-         if ( op_accuracy != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_OPACCURACY, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            op_accuracy = ogc_op_accuracy::from_tokens(t, i, &next, err);
-            if ( op_accuracy == OGC_NULL )
+         case OGC_OBJ_TYPE_OP_ACCURACY:
+            if ( op_accuracy != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_OPACCURACY, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               op_accuracy = ogc_op_accuracy::from_tokens(t, i, &next, err);
+               if ( op_accuracy == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_scope::is_kwd(arr[i].str) )
-      {
-         if ( scope != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SCOPE, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            scope = ogc_scope::from_tokens(t, i, &next, err);
-            if ( scope == OGC_NULL )
+         case OGC_OBJ_TYPE_SCOPE:
+            if ( scope != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SCOPE, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               scope = ogc_scope::from_tokens(t, i, &next, err);
+               if ( scope == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_extent::is_kwd(arr[i].str) )
-      {
-         extent = ogc_extent::from_tokens(t, i, &next, err);
-         if ( extent == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( extents == OGC_NULL )
+         case OGC_OBJ_TYPE_AREA_EXTENT:
+         case OGC_OBJ_TYPE_BBOX_EXTENT:
+         case OGC_OBJ_TYPE_TIME_EXTENT:
+         case OGC_OBJ_TYPE_VERT_EXTENT:
+            extent = ogc_extent::from_tokens(t, i, &next, err);
+            if ( extent == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               extents = ogc_vector::create(1, 1);
                if ( extents == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete extent;
-                  bad = true;
+                  extents = ogc_vector::create(1, 1);
+                  if ( extents == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete extent;
+                     bad = true;
+                  }
+               }
+
+               if ( extents != OGC_NULL )
+               {
+                  void * p = extents->find(
+                                extent,
+                                false,
+                                ogc_utils::compare_extent);
+                  if ( p != OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_EXTENT,
+                        obj_kwd(),
+                        ogc_utils::obj_type_to_kwd(extent->obj_type()));
+                     delete extent;
+                     bad = true;
+                  }
+                  else
+                  {
+                     if ( extents->add( extent ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete extent;
+                        bad = true;
+                     }
+                  }
                }
             }
+            break;
 
-            if ( extents != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = extents->find(
-                             extent,
-                             false,
-                             ogc_utils::compare_extent);
-               if ( p != OGC_NULL )
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_EXTENT,
-                     obj_kwd(),
-                     ogc_utils::obj_type_to_kwd(extent->obj_type()));
-                  delete extent;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( extents->add( extent ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                     delete extent;
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
+                     delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
+         case OGC_OBJ_TYPE_REMARK:
+            if ( remark != OGC_NULL )
             {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               remark = ogc_remark::from_tokens(t, i, &next, err);
+               if ( remark == OGC_NULL )
+                  bad = true;
+            }
+            break;
+
+         default:
+            /* these are not objects, so have no object type */
+            if ( ogc_string::is_equal(t->str(i), OGC_OBJ_KWD_SOURCE_CRS) )
+            {
+               if ( source_crs != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
+                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SOURCE_CRS,
+                     obj_kwd());
                   bad = true;
                }
+               else
+               {
+                  source_crs = ogc_crs::from_tokens(t, i+1, &next, err);
+                  if ( source_crs == OGC_NULL )
+                     bad = true;
+               }
             }
-
-            if ( ids != OGC_NULL )
+            else if ( ogc_string::is_equal(t->str(i), OGC_OBJ_KWD_TARGET_CRS) )
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( target_crs != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
+                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_TARGET_CRS,
+                     obj_kwd());
                   bad = true;
                }
                else
                {
-                  if ( ids->add( id ) < 0 )
-                  {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                     delete id;
+                  target_crs = ogc_crs::from_tokens(t, i+1, &next, err);
+                  if ( target_crs == OGC_NULL )
+                     bad = true;
+               }
+            }
+            else if ( ogc_string::is_equal(t->str(i), OGC_OBJ_KWD_INTERP_CRS) )
+            {
+               if ( interp_crs != OGC_NULL )
+               {
+                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_INTERP_CRS,
+                     obj_kwd());
+                  bad = true;
+               }
+               else
+               {
+                  interp_crs = ogc_crs::from_tokens(t, i+1, &next, err);
+                  if ( interp_crs == OGC_NULL )
                      bad = true;
-                  }
                }
             }
-         }
-         continue;
-      }
-
-      if ( ogc_remark::is_kwd(arr[i].str) )
-      {
-         if ( remark != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            remark = ogc_remark::from_tokens(t, i, &next, err);
-            if ( remark == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
-
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
             break;
       }
    }
@@ -568,6 +545,8 @@ ogc_coord_op * ogc_coord_op :: from_tokens(
     */
    if ( !bad )
    {
+      method = ogc_share_obj(method);
+
       obj = create(name, source_crs, target_crs, interp_crs,
                    method, parameters, param_files,
                    op_accuracy, scope, extents, ids, remark, err);
@@ -599,7 +578,7 @@ ogc_coord_op * ogc_coord_op :: from_wkt(
    ogc_error *  err)
 {
    ogc_coord_op * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -633,87 +612,61 @@ bool ogc_coord_op :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_BUFF      buf_source_crs;
-   OGC_BUFF      buf_source;
-   OGC_BUFF      buf_target_crs;
-   OGC_BUFF      buf_target;
-   OGC_BUFF      buf_interp_crs;
-   OGC_BUFF      buf_interp;
-   OGC_TBUF      buf_method;
-   OGC_TBUF      buf_parameter;
-   OGC_TBUF      buf_op_accuracy;
-   OGC_TBUF      buf_scope;
-   OGC_TBUF      buf_extent;
-   OGC_TBUF      buf_id;
-   OGC_TBUF      buf_remark;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_coord_op :: to_wkt(
+   const ogc_coord_op * obj,
+   ogc_wkt_writer &     w,
+   int                  options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_coord_op :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       return true;
 
-   rc &= ogc_crs    :: to_wkt(_source_crs, buf_source_crs, opts, OGC_BUFF_MAX-8);
-   rc &= ogc_crs    :: to_wkt(_target_crs, buf_target_crs, opts, OGC_BUFF_MAX-8);
-   rc &= ogc_crs    :: to_wkt(_interp_crs, buf_interp_crs, opts, OGC_BUFF_MAX-8);
-   rc &= ogc_method :: to_wkt(_method, buf_method,         opts, OGC_TBUF_MAX);
-   rc &= ogc_op_accuracy  :: to_wkt(_op_accuracy,  buf_op_accuracy, opts, OGC_TBUF_MAX);
-   rc &= ogc_scope  :: to_wkt(_scope,  buf_scope,          opts, OGC_TBUF_MAX);
-   rc &= ogc_remark :: to_wkt(_remark, buf_remark,         opts, OGC_TBUF_MAX);
+   w.open(kwd, options);
+   w.put_str(_name);
 
-   sprintf(buf_source, "%s%s%s%s",
-      OGC_OBJ_KWD_SOURCE_CRS, opn, buf_source_crs, cls);
-
-   sprintf(buf_target, "%s%s%s%s",
-      OGC_OBJ_KWD_TARGET_CRS, opn, buf_target_crs, cls);
-
-   if ( _interp_crs != OGC_NULL )
-   {
-      sprintf(buf_interp, "%s%s%s%s",
-         OGC_OBJ_KWD_TARGET_CRS, opn, buf_interp_crs, cls);
-   }
-   else
-   {
-      *buf_interp = 0;
-   }
+   w.open(OGC_OBJ_KWD_SOURCE_CRS, options);
+   rc &= ogc_crs :: to_wkt(_source_crs, w, opts);
+   w.close(options);
 
-   ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\"",
-      kwd, opn, buf_name);
+   w.open(OGC_OBJ_KWD_TARGET_CRS, options);
+   rc &= ogc_crs :: to_wkt(_target_crs, w, opts);
+   w.close(options);
 
-   OGC_CPY_TO_BUF( buf_hdr    );
-   OGC_ADD_TO_BUF( buf_source );
-   OGC_ADD_TO_BUF( buf_target );
-   OGC_ADD_TO_BUF( buf_method );
+   rc &= ogc_method :: to_wkt(_method, w, opts);
 
    if ( _parameters != OGC_NULL )
    {
       for (int i = 0; i < parameter_count(); i++)
       {
-         rc &= ogc_parameter :: to_wkt(parameter(i),
-                                       buf_parameter, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_parameter );
+         rc &= ogc_parameter :: to_wkt(parameter(i), w, opts);
       }
    }
 
@@ -721,23 +674,25 @@ bool ogc_coord_op :: to_wkt(
    {
       for (int i = 0; i < param_file_count(); i++)
       {
-         rc &= ogc_param_file :: to_wkt(param_file(i),
-                                        buf_parameter, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_parameter );
+         rc &= ogc_param_file :: to_wkt(param_file(i), w, opts);
       }
    }
 
-   OGC_ADD_TO_BUF( buf_interp      );
-   OGC_ADD_TO_BUF( buf_op_accuracy );
-   OGC_ADD_TO_BUF( buf_scope       );
+   if ( _interp_crs != OGC_NULL )
+   {
+      w.open(OGC_OBJ_KWD_TARGET_CRS, options);
+      rc &= ogc_crs :: to_wkt(_interp_crs, w, opts);
+      w.close(options);
+   }
+
+   rc &= ogc_op_accuracy :: to_wkt(_op_accuracy, w, opts);
+   rc &= ogc_scope       :: to_wkt(_scope,       w, opts);
 
    if ( _extents != OGC_NULL )
    {
       for (int i = 0; i < extent_count(); i++)
       {
-         rc &= ogc_extent :: to_wkt(extent(i),
-                                    buf_extent, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_extent );
+         rc &= ogc_extent :: to_wkt(extent(i), w, opts);
       }
    }
 
@@ -745,19 +700,12 @@ bool ogc_coord_op :: to_wkt(
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
       }
    }
 
-   OGC_ADD_TO_BUF( buf_remark );
-   OGC_CPY_TO_BUF( cls        );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   rc &= ogc_remark :: to_wkt(_remark, w, opts);
+   w.close(options);
 
    return rc;
 }
@@ -777,7 +725,7 @@ ogc_coord_op * ogc_coord_op :: clone() const
    ogc_crs *         source_crs  = ogc_crs         :: clone( _source_crs  );
    ogc_crs *         target_crs  = ogc_crs         :: clone( _target_crs  );
    ogc_crs *         interp_crs  = ogc_crs         :: clone( _interp_crs  );
-   ogc_method *      method      = ogc_method      :: clone( _method      );
+   ogc_method *      method      = ogc_share_clone( _method );
    ogc_vector *      parameters  = ogc_vector      :: clone( _parameters  );
    ogc_vector *      param_files = ogc_vector      :: clone( _param_files );
    ogc_op_accuracy * op_accuracy = ogc_op_accuracy :: clone( _op_accuracy );
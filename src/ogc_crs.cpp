@@ -68,32 +68,37 @@ ogc_crs * ogc_crs :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_EMPTY_STRING, obj_kwd());
       return OGC_NULL;
    }
+   ogc_err_pos epos(t, start);
 
-   const char * kwd = t->_arr[start].str;
+#  define CHECK(type, n) \
+      case OGC_OBJ_TYPE_##type: \
+         return ogc_##n :: from_tokens(t, start, pend, err)
 
-#  define CHECK(n) \
-   if ( ogc_##n::is_kwd(kwd) ) \
-      return ogc_##n :: from_tokens(t, start, pend, err)
-
-   CHECK( engr_crs       );
-   CHECK( geod_crs       );
-   CHECK( image_crs      );
-   CHECK( param_crs      );
-   CHECK( proj_crs       );
-   CHECK( time_crs       );
-   CHECK( vert_crs       );
-   CHECK( compound_crs   );
-
-   CHECK( base_engr_crs  );
-   CHECK( base_geod_crs  );
-   CHECK( base_param_crs );
-   CHECK( base_proj_crs  );
-   CHECK( base_time_crs  );
-   CHECK( base_vert_crs  );
+   switch (t->type(start))
+   {
+      CHECK( ENGR_CRS,       engr_crs       );
+      CHECK( GEOD_CRS,       geod_crs       );
+      CHECK( IMAGE_CRS,      image_crs      );
+      CHECK( PARAM_CRS,      param_crs      );
+      CHECK( PROJ_CRS,       proj_crs       );
+      CHECK( TIME_CRS,       time_crs       );
+      CHECK( VERT_CRS,       vert_crs       );
+      CHECK( COMPOUND_CRS,   compound_crs   );
+
+      CHECK( BASE_ENGR_CRS,  base_engr_crs  );
+      CHECK( BASE_GEOD_CRS,  base_geod_crs  );
+      CHECK( BASE_PARAM_CRS, base_param_crs );
+      CHECK( BASE_PROJ_CRS,  base_proj_crs  );
+      CHECK( BASE_TIME_CRS,  base_time_crs  );
+      CHECK( BASE_VERT_CRS,  base_vert_crs  );
+
+      default:
+         break;
+   }
 
 #  undef CHECK
 
-   ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
+   ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), t->str(start));
    return OGC_NULL;
 }
 
@@ -104,7 +109,7 @@ ogc_crs * ogc_crs :: from_wkt(
    const char * wkt,
    ogc_error *  err)
 {
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( ! t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -138,10 +143,30 @@ bool ogc_crs :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_crs :: to_wkt(
+   const ogc_crs *  obj,
+   ogc_wkt_writer & w,
+   int              options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
 
+bool ogc_crs :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    if ( !is_visible() )
       return true;
 
@@ -150,7 +175,7 @@ bool ogc_crs :: to_wkt(
 #  define CASE(o,n) \
       case OGC_OBJ_TYPE_##o: \
          return (reinterpret_cast<const ogc_##n *>(this))-> \
-                to_wkt(buffer, options, buflen)
+                to_wkt(w, options)
 
    CASE( ENGR_CRS,       engr_crs       );
    CASE( GEOD_CRS,       geod_crs       );
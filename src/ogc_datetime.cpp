@@ -330,17 +330,14 @@ bool ogc_datetime :: parse_time(
 
    /* get second (as a double) */
 
-   char buf[24];
-   char * b = buf;
+   const char * b = s;
    for (; *s; s++)
    {
       if (*s != '.' && !isdigit(*s) )
          break;
-      *b++ = *s;
    }
-   *b = 0;
 
-   dbl = atof(buf);
+   dbl = ogc_string::atod(b, static_cast<size_t>(s - b));
    if ( dbl >= 60.0 )
       return false;
    _sec = dbl;
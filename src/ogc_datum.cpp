@@ -62,23 +62,28 @@ ogc_datum * ogc_datum :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_EMPTY_STRING, obj_kwd());
       return OGC_NULL;
    }
+   ogc_err_pos epos(t, start);
 
-   const char * kwd = t->_arr[start].str;
+#  define CHECK(type, n) \
+      case OGC_OBJ_TYPE_##type: \
+         return ogc_##n :: from_tokens(t, start, pend, err)
 
-#  define CHECK(n) \
-   if ( ogc_##n::is_kwd(kwd) ) \
-      return ogc_##n :: from_tokens(t, start, pend, err)
-
-   CHECK( engr_datum  );
-   CHECK( geod_datum  );
-   CHECK( image_datum );
-   CHECK( param_datum );
-   CHECK( time_datum  );
-   CHECK( vert_datum  );
+   switch (t->type(start))
+   {
+      CHECK( ENGR_DATUM,  engr_datum  );
+      CHECK( GEOD_DATUM,  geod_datum  );
+      CHECK( IMAGE_DATUM, image_datum );
+      CHECK( PARAM_DATUM, param_datum );
+      CHECK( TIME_DATUM,  time_datum  );
+      CHECK( VERT_DATUM,  vert_datum  );
+
+      default:
+         break;
+   }
 
 #  undef CHECK
 
-   ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, kwd);
+   ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, t->str(start));
    return OGC_NULL;
 }
 
@@ -89,7 +94,7 @@ ogc_datum * ogc_datum :: from_wkt(
    const char * wkt,
    ogc_error *  err)
 {
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( ! t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -123,10 +128,30 @@ bool ogc_datum :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_datum :: to_wkt(
+   const ogc_datum * obj,
+   ogc_wkt_writer &  w,
+   int               options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
 
+bool ogc_datum :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    if ( !is_visible() )
       return true;
 
@@ -135,7 +160,7 @@ bool ogc_datum :: to_wkt(
 #  define CASE(o,n) \
       case OGC_OBJ_TYPE_##o: \
          return (reinterpret_cast<const ogc_##n *>(this))-> \
-                to_wkt(buffer, options, buflen)
+                to_wkt(w, options)
 
    CASE( ENGR_DATUM,  engr_datum  );
    CASE( GEOD_DATUM,  geod_datum  );
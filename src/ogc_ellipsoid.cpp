@@ -80,14 +80,18 @@ ogc_ellipsoid * ogc_ellipsoid :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_ellipsoid();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_ellipsoid();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type        = OGC_OBJ_TYPE_ELLIPSOID;
       p->_visible         = true;
       p->_semi_major_axis = semi_major_axis;
@@ -111,10 +115,7 @@ ogc_ellipsoid :: ~ogc_ellipsoid()
 ogc_ellipsoid * ogc_ellipsoid :: destroy(
    ogc_ellipsoid * obj)
 {
-   if ( obj != OGC_NULL )
-   {
-      delete obj;
-   }
+   ogc_object::destroy(obj);
    return OGC_NULL;
 }
 
@@ -130,10 +131,8 @@ ogc_ellipsoid * ogc_ellipsoid :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_ellipsoid * obj     = OGC_NULL;
    ogc_lenunit *   lenunit = OGC_NULL;
@@ -158,35 +157,24 @@ ogc_ellipsoid * ogc_ellipsoid :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_ELLIPSOID )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 3 tokens: ELLIPSOID[ "name", semi_major_axis, flattening ...
@@ -197,7 +185,7 @@ ogc_ellipsoid * ogc_ellipsoid :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 3 && get_strict_parsing() )
+   if ( same > 3 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -209,9 +197,9 @@ ogc_ellipsoid * ogc_ellipsoid :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntcatically fixed.
     */
-   name            = arr[start++].str;
-   semi_major_axis = ogc_string::atod( arr[start++].str );
-   flattening      = ogc_string::atod( arr[start++].str );
+   name            = t->str(start++);
+   semi_major_axis = t->num(start++);
+   flattening      = t->num(start++);
 
    if ( flattening != 0.0 )
    {
@@ -224,73 +212,72 @@ ogc_ellipsoid * ogc_ellipsoid :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_lenunit::is_kwd(arr[i].str) )
-      {
-         if ( lenunit != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            lenunit = ogc_lenunit::from_tokens(t, i, &next, err);
-            if ( lenunit == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_id::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
+         case OGC_OBJ_TYPE_LENUNIT:
+         case OGC_OBJ_TYPE_UNIT:
+            if ( lenunit != OGC_NULL )
             {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               lenunit = ogc_lenunit::from_tokens(t, i, &next, err);
+               if ( lenunit == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -300,6 +287,8 @@ ogc_ellipsoid * ogc_ellipsoid :: from_tokens(
     */
    if ( !bad )
    {
+      lenunit = ogc_share_obj(lenunit);
+
       obj = create(name, semi_major_axis, flattening, lenunit, ids, err);
    }
 
@@ -320,7 +309,7 @@ ogc_ellipsoid * ogc_ellipsoid :: from_wkt(
    ogc_error *  err)
 {
    ogc_ellipsoid * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -354,32 +343,37 @@ bool ogc_ellipsoid :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_lenunit;
-   OGC_TBUF      buf_id;
-   OGC_NBUF      buf_sm_axis;
-   OGC_NBUF      buf_flattening;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_ellipsoid :: to_wkt(
+   const ogc_ellipsoid * obj,
+   ogc_wkt_writer &      w,
+   int                   options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_ellipsoid :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
@@ -390,39 +384,24 @@ bool ogc_ellipsoid :: to_wkt(
    if ( flattening != 0.0 )
       flattening = (1.0 / flattening);
 
-   ogc_string :: dtoa(_semi_major_axis, buf_sm_axis);
-   ogc_string :: dtoa( flattening,      buf_flattening);
-
+   w.open(kwd, options);
+   w.put_str(_name);
+   w.put_num(_semi_major_axis);
+   w.put_num(flattening);
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) == 0 )
-      rc &= ogc_lenunit :: to_wkt(_lenunit, buf_lenunit, opts, OGC_TBUF_MAX);
-   else
-      *buf_lenunit = 0;
-
-   ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\",%s,%s",
-      kwd, opn, buf_name, buf_sm_axis, buf_flattening);
-
-   OGC_CPY_TO_BUF( buf_hdr     );
-   OGC_ADD_TO_BUF( buf_lenunit );
+      rc &= ogc_lenunit :: to_wkt(_lenunit, w, opts);
 
    if ( _ids != OGC_NULL && (options & OGC_WKT_OPT_NO_IDS) == 0 )
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
          if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
             break;
       }
    }
 
-   OGC_CPY_TO_BUF( cls );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.close(options);
 
    return rc;
 }
@@ -439,7 +418,7 @@ ogc_ellipsoid * ogc_ellipsoid :: clone(const ogc_ellipsoid * obj)
 
 ogc_ellipsoid * ogc_ellipsoid :: clone() const
 {
-   ogc_lenunit * lenunit = ogc_lenunit :: clone( _lenunit );
+   ogc_lenunit * lenunit = ogc_share_clone( _lenunit );
    ogc_vector *  ids     = ogc_vector  :: clone( _ids     );
 
    ogc_ellipsoid * p = create(_name,
@@ -33,6 +33,10 @@ void *                     ogc_error :: _usr_data = OGC_NULL;
  */
 ogc_error :: ogc_error()
 {
+   _rtn   = OGC_NULL;
+   _data  = OGC_NULL;
+   _quiet = false;
+   _ctx   = OGC_NULL;
    clear();
 }
 
@@ -47,47 +51,136 @@ void ogc_error :: set_err_rtn(
    _usr_data = data;
 }
 
+/*------------------------------------------------------------------------
+ * set the call-back routine for this object
+ */
+void ogc_error :: set_rtn(
+   OGC_ERR_RTN * rtn,
+   void *        data)
+{
+   _rtn  = rtn;
+   _data = data;
+}
+
 /*------------------------------------------------------------------------
  * internal send the message
+ *
+ * The message is only made if there is a routine to send it to.
  */
 void ogc_error :: send()
 {
-   if ( _usr_rtn != OGC_NULL )
+   if ( _rtn != OGC_NULL )
+   {
+      (_rtn)(_data, _err_code, err_msg());
+   }
+   else
+   if ( _usr_rtn != OGC_NULL && !_quiet )
    {
-      (_usr_rtn)(_usr_data, _err_code, _err_msg);
+      (_usr_rtn)(_usr_data, _err_code, err_msg());
    }
 }
 
+/*------------------------------------------------------------------------
+ * internal record an error (the arg is already set) and send it
+ *
+ * A keyword too long to keep (one taken from the WKT being parsed) is
+ * put in the message now, so the message is the same as it would be
+ * with the whole keyword.
+ */
+void ogc_error :: record(
+   ogc_err_code err_code,
+   const char * obj_kwd,
+   int          arg_type)
+{
+   int n = 0;
+
+   _err_code = err_code;
+   _arg_type = arg_type;
+   _fmt      = false;
+
+   if ( obj_kwd != OGC_NULL )
+   {
+      for (; n < OGC_ERR_KWD_MAX-1 && obj_kwd[n] != 0; n++)
+         _kwd[n] = obj_kwd[n];
+   }
+   _kwd[n] = 0;
+
+   if ( _ctx != OGC_NULL )
+      _ctx->keep_err(*this);
+
+   if ( obj_kwd != OGC_NULL && obj_kwd[n] != 0 )
+   {
+      OGC_ERR_BUF buf;
+
+      format(buf, _err_code, obj_kwd, _arg_type, _err_msg, _iarg, _darg);
+      strcpy(_err_msg, buf);
+      _fmt = true;
+   }
+
+   send();
+}
+
+/*------------------------------------------------------------------------
+ * copy the error of another object
+ */
+void ogc_error :: copy(
+   const ogc_error & e)
+{
+   _err_code = e._err_code;
+   _arg_type = e._arg_type;
+   _iarg     = e._iarg;
+   _darg     = e._darg;
+   _fmt      = e._fmt;
+   strcpy(_kwd,     e._kwd);
+   strcpy(_err_msg, e._err_msg);
+}
+
 /*------------------------------------------------------------------------
  * clear the error code
  */
 void ogc_error :: clear()
 {
    _err_code   = OGC_ERR_NONE;
+   _arg_type   = OGC_ERR_ARG_NONE;
+   _iarg       = 0;
+   _darg       = 0.0;
+   _kwd[0]     = 0;
+   _fmt        = true;
    _err_msg[0] = 0;
 }
 
 /*------------------------------------------------------------------------
- * set the error code to a value
+ * get the error message (made when first asked for)
  */
-void ogc_error :: set(ogc_err_code err_code)
+const char * ogc_error :: err_msg() const
 {
-   _err_code = err_code;
-   strcpy(_err_msg, err_str(err_code));
+   if ( !_fmt )
+   {
+      OGC_ERR_BUF buf;
 
-   send();
+      format(buf, _err_code, _kwd, _arg_type, _err_msg, _iarg, _darg);
+      strcpy(_err_msg, buf);
+      _fmt = true;
+   }
+
+   return _err_msg;
 }
 
 /*------------------------------------------------------------------------
- * set the error code to a value
+ * internal make an error message
  */
-void ogc_error :: set(
+void ogc_error :: format(
+   char *       buf,
    ogc_err_code err_code,
-   const char * obj_kwd)
+   const char * obj_kwd,
+   int          arg_type,
+   const char * sarg,
+   int          iarg,
+   double       darg)
 {
-   char * s = _err_msg;
+   char * s = buf;
+   OGC_NBUF nbuf;
 
-   _err_code = err_code;
    if ( obj_kwd != OGC_NULL && *obj_kwd != 0 )
    {
       s += ogc_string::strlwr(s, obj_kwd);
@@ -95,32 +188,55 @@ void ogc_error :: set(
    }
    s += ogc_string::strcpy(s, err_str(err_code));
 
-   send();
+   switch ( arg_type )
+   {
+      case OGC_ERR_ARG_STR:
+         s += ogc_string::strcpy(s, ": ");
+         ogc_string::strncpy(s, sarg, OGC_ERR_MSG_MAX - (s - buf));
+         break;
+
+      case OGC_ERR_ARG_INT:
+         s += ogc_string::strcpy(s, ": ");
+         s += ogc_string::strcpy(s, ogc_string::itoa(iarg, nbuf));
+         break;
+
+      case OGC_ERR_ARG_DBL:
+         s += ogc_string::strcpy(s, ": ");
+         s += ogc_string::strcpy(s, ogc_string::dtoa(darg, nbuf));
+         break;
+   }
+}
+
+/*------------------------------------------------------------------------
+ * set the error code to a value
+ */
+void ogc_error :: set(ogc_err_code err_code)
+{
+   record(err_code, OGC_NULL, OGC_ERR_ARG_NONE);
+}
+
+/*------------------------------------------------------------------------
+ * set the error code to a value
+ */
+void ogc_error :: set(
+   ogc_err_code err_code,
+   const char * obj_kwd)
+{
+   record(err_code, obj_kwd, OGC_ERR_ARG_NONE);
 }
 
 /*------------------------------------------------------------------------
  * set the error code and string
+ *
+ * The string is kept in the message buffer until the message is made.
  */
 void ogc_error :: set(
    ogc_err_code err_code,
    const char * obj_kwd,
    const char * arg)
 {
-   char * s = _err_msg;
-
-   _err_code = err_code;
-   if ( obj_kwd != OGC_NULL && *obj_kwd != 0 )
-   {
-      s += ogc_string::strlwr(s, obj_kwd);
-      s += ogc_string::strcpy(s, ": ");
-   }
-   s += ogc_string::strcpy(s, err_str(err_code));
-   s += ogc_string::strcpy(s, ": ");
-
-   size_t len = strlen(_err_msg);
-   ogc_string::strncpy(s, arg, OGC_ERR_MSG_MAX-len);
-
-   send();
+   ogc_string::strncpy(_err_msg, arg, OGC_ERR_MSG_MAX);
+   record(err_code, obj_kwd, OGC_ERR_ARG_STR);
 }
 
 /*------------------------------------------------------------------------
@@ -131,20 +247,8 @@ void ogc_error :: set(
    const char * obj_kwd,
    int          arg)
 {
-   char * s = _err_msg;
-   OGC_NBUF buf;
-
-   _err_code = err_code;
-   if ( obj_kwd != OGC_NULL && *obj_kwd != 0 )
-   {
-      s += ogc_string::strlwr(s, obj_kwd);
-      s += ogc_string::strcpy(s, ": ");
-   }
-   s += ogc_string::strcpy(s, err_str(err_code));
-   s += ogc_string::strcpy(s, ": ");
-   s += ogc_string::strcpy(s, ogc_string::itoa(arg, buf));
-
-   send();
+   _iarg = arg;
+   record(err_code, obj_kwd, OGC_ERR_ARG_INT);
 }
 
 /*------------------------------------------------------------------------
@@ -155,20 +259,8 @@ void ogc_error :: set(
    const char * obj_kwd,
    double       arg)
 {
-   char * s = _err_msg;
-   OGC_NBUF buf;
-
-   _err_code = err_code;
-   if ( obj_kwd != OGC_NULL && *obj_kwd != 0 )
-   {
-      s += ogc_string::strlwr(s, obj_kwd);
-      s += ogc_string::strcpy(s, ": ");
-   }
-   s += ogc_string::strcpy(s, err_str(err_code));
-   s += ogc_string::strcpy(s, ": ");
-   s += ogc_string::strcpy(s, ogc_string::dtoa(arg, buf));
-
-   send();
+   _darg = arg;
+   record(err_code, obj_kwd, OGC_ERR_ARG_DBL);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -187,14 +279,24 @@ void ogc_error :: clear(
 
 /*------------------------------------------------------------------------
  * static set the error code to a value
+ *
+ * With no error object, the error is only made if the global routine
+ * is set (as nobody else would see it).
  */
 void ogc_error :: set(
    ogc_error *  err,
    ogc_err_code err_code)
 {
-   ogc_error e;
-   if ( err == OGC_NULL ) err = &e;
-   err->set(err_code);
+   if ( err != OGC_NULL )
+   {
+      err->set(err_code);
+   }
+   else
+   if ( _usr_rtn != OGC_NULL )
+   {
+      ogc_error e;
+      e.set(err_code);
+   }
 }
 
 /*------------------------------------------------------------------------
@@ -205,9 +307,16 @@ void ogc_error :: set(
    ogc_err_code err_code,
    const char * obj_kwd)
 {
-   ogc_error e;
-   if ( err == OGC_NULL ) err = &e;
-   err->set(err_code, obj_kwd);
+   if ( err != OGC_NULL )
+   {
+      err->set(err_code, obj_kwd);
+   }
+   else
+   if ( _usr_rtn != OGC_NULL )
+   {
+      ogc_error e;
+      e.set(err_code, obj_kwd);
+   }
 }
 
 /*------------------------------------------------------------------------
@@ -219,9 +328,16 @@ void ogc_error :: set(
    const char * obj_kwd,
    const char * arg)
 {
-   ogc_error e;
-   if ( err == OGC_NULL ) err = &e;
-   err->set(err_code, obj_kwd, arg);
+   if ( err != OGC_NULL )
+   {
+      err->set(err_code, obj_kwd, arg);
+   }
+   else
+   if ( _usr_rtn != OGC_NULL )
+   {
+      ogc_error e;
+      e.set(err_code, obj_kwd, arg);
+   }
 }
 
 /*------------------------------------------------------------------------
@@ -233,9 +349,16 @@ void ogc_error :: set(
    const char * obj_kwd,
    int          arg)
 {
-   ogc_error e;
-   if ( err == OGC_NULL ) err = &e;
-   err->set(err_code, obj_kwd, arg);
+   if ( err != OGC_NULL )
+   {
+      err->set(err_code, obj_kwd, arg);
+   }
+   else
+   if ( _usr_rtn != OGC_NULL )
+   {
+      ogc_error e;
+      e.set(err_code, obj_kwd, arg);
+   }
 }
 
 /*------------------------------------------------------------------------
@@ -247,9 +370,16 @@ void ogc_error :: set(
    const char * obj_kwd,
    double       arg)
 {
-   ogc_error e;
-   if ( err == OGC_NULL ) err = &e;
-   err->set(err_code, obj_kwd, arg);
+   if ( err != OGC_NULL )
+   {
+      err->set(err_code, obj_kwd, arg);
+   }
+   else
+   if ( _usr_rtn != OGC_NULL )
+   {
+      ogc_error e;
+      e.set(err_code, obj_kwd, arg);
+   }
 }
 
 /*------------------------------------------------------------------------
@@ -273,7 +403,22 @@ const char * ogc_error :: err_msg(
    if ( err == OGC_NULL )
       return "?";
    else
-      return err->_err_msg;
+      return err->err_msg();
+}
+
+/*------------------------------------------------------------------------
+ * static make the message of an error record
+ */
+const char * ogc_error :: err_msg(
+   const ogc_err_rec * rec,
+   OGC_ERR_BUF         buf)
+{
+   if ( rec == OGC_NULL )
+      return "?";
+
+   format(buf, rec->code, rec->kwd, rec->arg_type, rec->sarg,
+          rec->iarg, rec->darg);
+   return buf;
 }
 
 /*------------------------------------------------------------------------
@@ -63,21 +63,26 @@ ogc_extent * ogc_extent :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_EMPTY_STRING, obj_kwd());
       return OGC_NULL;
    }
+   ogc_err_pos epos(t, start);
 
-   const char * kwd = t->_arr[start].str;
+#  define CHECK(type, n) \
+      case OGC_OBJ_TYPE_##type: \
+         return ogc_##n :: from_tokens(t, start, pend, err)
 
-#  define CHECK(n) \
-   if ( ogc_##n::is_kwd(kwd) ) \
-      return ogc_##n :: from_tokens(t, start, pend, err)
+   switch (t->type(start))
+   {
+      CHECK( AREA_EXTENT, area_extent );
+      CHECK( BBOX_EXTENT, bbox_extent );
+      CHECK( TIME_EXTENT, time_extent );
+      CHECK( VERT_EXTENT, vert_extent );
 
-   CHECK( area_extent );
-   CHECK( bbox_extent );
-   CHECK( time_extent );
-   CHECK( vert_extent );
+      default:
+         break;
+   }
 
 #  undef CHECK
 
-   ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
+   ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), t->str(start));
    return OGC_NULL;
 }
 
@@ -88,7 +93,7 @@ ogc_extent * ogc_extent :: from_wkt(
    const char * wkt,
    ogc_error *  err)
 {
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( ! t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -122,10 +127,30 @@ bool ogc_extent :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
 
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_extent :: to_wkt(
+   const ogc_extent * obj,
+   ogc_wkt_writer &   w,
+   int                options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_extent :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    if ( !is_visible() )
       return true;
 
@@ -134,7 +159,7 @@ bool ogc_extent :: to_wkt(
 #  define CASE(o,n) \
       case OGC_OBJ_TYPE_##o: \
          return (reinterpret_cast<const ogc_##n *>(this))-> \
-                to_wkt(buffer, options, buflen)
+                to_wkt(w, options)
 
    CASE( AREA_EXTENT, area_extent );
    CASE( BBOX_EXTENT, bbox_extent );
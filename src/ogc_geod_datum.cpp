@@ -72,14 +72,18 @@ ogc_geod_datum * ogc_geod_datum :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_geod_datum();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_geod_datum();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type   = OGC_OBJ_TYPE_GEOD_DATUM;
       p->_visible    = true;
       p->_datum_type = OGC_DATUM_TYPE_GEOD;
@@ -121,10 +125,8 @@ ogc_geod_datum * ogc_geod_datum :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_geod_datum * obj       = OGC_NULL;
    ogc_ellipsoid *      ellipsoid = OGC_NULL;
@@ -148,35 +150,24 @@ ogc_geod_datum * ogc_geod_datum :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_GEOD_DATUM )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: DATUM[ "name" ...
@@ -187,7 +178,7 @@ ogc_geod_datum * ogc_geod_datum :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -199,7 +190,7 @@ ogc_geod_datum * ogc_geod_datum :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name = arr[start++].str;
+   name = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -207,89 +198,85 @@ ogc_geod_datum * ogc_geod_datum :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_ellipsoid::is_kwd(arr[i].str) )
-      {
-         if ( ellipsoid != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ELLIPSOID, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            ellipsoid = ogc_ellipsoid::from_tokens(t, i, &next, err);
-            if ( ellipsoid == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_anchor::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         if ( anchor != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ANCHOR, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            anchor = ogc_anchor::from_tokens(t, i, &next, err);
-            if ( anchor == OGC_NULL )
+         case OGC_OBJ_TYPE_ELLIPSOID:
+            if ( ellipsoid != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ELLIPSOID, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               ellipsoid = ogc_ellipsoid::from_tokens(t, i, &next, err);
+               if ( ellipsoid == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
+         case OGC_OBJ_TYPE_ANCHOR:
+            if ( anchor != OGC_NULL )
             {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ANCHOR, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               anchor = ogc_anchor::from_tokens(t, i, &next, err);
+               if ( anchor == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -299,6 +286,8 @@ ogc_geod_datum * ogc_geod_datum :: from_tokens(
     */
    if ( !bad )
    {
+      ellipsoid = ogc_share_obj(ellipsoid);
+
       obj = create(name, ellipsoid, anchor, ids, err);
    }
 
@@ -320,7 +309,7 @@ ogc_geod_datum * ogc_geod_datum :: from_wkt(
    ogc_error *  err)
 {
    ogc_geod_datum * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -354,63 +343,56 @@ bool ogc_geod_datum :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_ellipsoid;
-   OGC_TBUF      buf_anchor;
-   OGC_TBUF      buf_id;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_geod_datum :: to_wkt(
+   const ogc_geod_datum * obj,
+   ogc_wkt_writer &       w,
+   int                    options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_geod_datum :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
-   rc &= ogc_ellipsoid :: to_wkt(_ellipsoid, buf_ellipsoid, opts, OGC_TBUF_MAX);
-   rc &= ogc_anchor    :: to_wkt(_anchor,    buf_anchor,    opts, OGC_TBUF_MAX);
-
-   ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\"",
-      kwd, opn, buf_name);
-
-   OGC_CPY_TO_BUF( buf_hdr       );
-   OGC_ADD_TO_BUF( buf_ellipsoid );
-   OGC_ADD_TO_BUF( buf_anchor    );
+   w.open(kwd, options);
+   w.put_str(_name);
+   rc &= ogc_ellipsoid :: to_wkt(_ellipsoid, w, opts);
+   rc &= ogc_anchor    :: to_wkt(_anchor,    w, opts);
 
    if ( _ids != OGC_NULL && (options & OGC_WKT_OPT_NO_IDS) == 0 )
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
          if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
             break;
       }
    }
 
-   OGC_CPY_TO_BUF( cls );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.close(options);
 
    return rc;
 }
@@ -427,7 +409,7 @@ ogc_geod_datum * ogc_geod_datum :: clone(const ogc_geod_datum * obj)
 
 ogc_geod_datum * ogc_geod_datum :: clone() const
 {
-   ogc_ellipsoid * ellipsoid = ogc_ellipsoid :: clone( _ellipsoid );
+   ogc_ellipsoid * ellipsoid = ogc_share_clone( _ellipsoid );
    ogc_anchor *    anchor    = ogc_anchor    :: clone( _anchor    );
    ogc_vector *    ids       = ogc_vector    :: clone( _ids       );
 
@@ -95,16 +95,22 @@ ogc_id * ogc_id :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_id();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      strs.need(identifier);
+      strs.need(version);
+      p = new (strs.size(), std::nothrow) ogc_id();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name,       name,       OGC_NAME_MAX);
-      ogc_string::unescape_str(p->_identifier, identifier, OGC_TEXT_MAX);
-      ogc_string::unescape_str(p->_version,    version,    OGC_TEXT_MAX);
+      strs.begin(p);
+      p->_name       = strs.add_name(name);
+      p->_identifier = strs.add(identifier);
+      p->_version    = strs.add(version);
       p->_obj_type = OGC_OBJ_TYPE_ID;
       p->_visible  = true;
       p->_citation = citation;
@@ -145,10 +151,8 @@ ogc_id * ogc_id :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_id *       obj      = OGC_NULL;
    ogc_citation * citation = OGC_NULL;
@@ -172,35 +176,24 @@ ogc_id * ogc_id :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_ID )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 2 or 3 tokens: ID[ "name", "identity" ...
@@ -212,7 +205,7 @@ ogc_id * ogc_id :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 3 && get_strict_parsing() )
+   if ( same > 3 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -225,11 +218,11 @@ ogc_id * ogc_id :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name       = arr[start++].str;
-   identifier = arr[start++].str;
+   name       = t->str(start++);
+   identifier = t->str(start++);
 
    if ( same > 2 )
-      version = arr[start++].str;
+      version = t->str(start++);
    else
       version = "";
 
@@ -239,42 +232,40 @@ ogc_id * ogc_id :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_citation::is_kwd(arr[i].str) )
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
+
+      switch (arr[i].type)
       {
-         if ( citation != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_CITATION, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            citation = ogc_citation::from_tokens(t, i, &next, err);
-            if ( citation == OGC_NULL )
+         case OGC_OBJ_TYPE_CITATION:
+            if ( citation != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_CITATION, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               citation = ogc_citation::from_tokens(t, i, &next, err);
+               if ( citation == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_uri::is_kwd(arr[i].str) )
-      {
-         if ( uri != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_URI, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            uri = ogc_uri::from_tokens(t, i, &next, err);
-            if ( uri == OGC_NULL )
+         case OGC_OBJ_TYPE_URI:
+            if ( uri != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_URI, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               uri = ogc_uri::from_tokens(t, i, &next, err);
+               if ( uri == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -304,7 +295,7 @@ ogc_id * ogc_id :: from_wkt(
    ogc_error *  err)
 {
    ogc_id * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -338,32 +329,37 @@ bool ogc_id :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_UTF8_TEXT buf_identifier;
-   OGC_UTF8_TEXT buf_version;
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_citation;
-   OGC_TBUF      buf_uri;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_id :: to_wkt(
+   const ogc_id *   obj,
+   ogc_wkt_writer & w,
+   int              options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_id :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
@@ -379,45 +375,28 @@ bool ogc_id :: to_wkt(
       }
    }
 
-   rc &= ogc_citation :: to_wkt(_citation, buf_citation, opts, OGC_TBUF_MAX);
-   rc &= ogc_uri      :: to_wkt(_uri,      buf_uri,      opts, OGC_TBUF_MAX);
-
-   ogc_string::escape_str(buf_name,       _name,       OGC_UTF8_NAME_MAX);
-   ogc_string::escape_str(buf_identifier, _identifier, OGC_UTF8_TEXT_MAX);
-   ogc_string::escape_str(buf_version,    _version,    OGC_UTF8_TEXT_MAX);
+   w.open(kwd, options);
+   w.put_str(_name);
 
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
    {
-      sprintf(buf_hdr, "%s%s\"%s\",%s",
-         kwd, opn, buf_name, _identifier);
+      w.put(_identifier);
    }
    else
    {
-      const char * q = (ogc_string::is_numeric(buf_identifier) ? "" : "\"");
-
-      if ( *buf_version != 0 )
-      {
-         sprintf(buf_hdr, "%s%s\"%s\",%s%s%s,\"%s\"",
-            kwd, opn, buf_name, q, buf_identifier, q, buf_version);
-      }
+      if ( ogc_string::is_numeric(_identifier) )
+         w.put(_identifier);
       else
-      {
-         sprintf(buf_hdr, "%s%s\"%s\",%s%s%s",
-            kwd, opn, buf_name, q, buf_identifier, q);
-      }
-   }
-
-   OGC_CPY_TO_BUF( buf_hdr      );
-   OGC_ADD_TO_BUF( buf_citation );
-   OGC_ADD_TO_BUF( buf_uri      );
-   OGC_CPY_TO_BUF( cls          );
+         w.put_str(_identifier);
 
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
+      if ( *_version != 0 )
+         w.put_str(_version);
    }
 
+   rc &= ogc_citation :: to_wkt(_citation, w, opts);
+   rc &= ogc_uri      :: to_wkt(_uri,      w, opts);
+   w.close(options);
+
    return rc;
 }
 
@@ -0,0 +1,249 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* string interning                                                          */
+/*                                                                           */
+/* The table is a fixed array of hash chains.  A string is only ever added   */
+/* at the head of a chain, by an atomic compare-and-swap of the head, and    */
+/* nothing is ever removed, so a chain can be walked with no lock while      */
+/* other threads add to it.  If two threads add to the same chain at once,   */
+/* the one that loses the swap walks the chain again (the other may have     */
+/* just added the same string) and tries again.                              */
+/*                                                                           */
+/* The table and its strings come from the heap and not from an allocator,   */
+/* as they are shared by all objects, whatever allocator they came from,     */
+/* and are kept until the program ends.                                      */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+#define OGC_INTERN_BUCKETS  (16 * 1024)  /* number of chains (power of 2) */
+
+struct ogc_intern_str
+{
+   ogc_intern_str * next;
+   size_t           hash;
+   size_t           len;
+   char             str[1];
+};
+
+typedef void * volatile ogc_intern_head;   /* head of a chain */
+
+static void * volatile            ogc_intern_table   = OGC_NULL;
+static volatile bool              ogc_intern_on      = false;
+static volatile size_t            ogc_intern_count   = 0;
+static volatile size_t            ogc_intern_size    = 0;
+
+/*------------------------------------------------------------------------
+ * turn interning on or off
+ */
+bool ogc_intern :: set_enabled(bool on_off)
+{
+   bool rc = ogc_intern_on;
+   ogc_intern_on = on_off;
+   return rc;
+}
+
+bool ogc_intern :: enabled()
+{
+   return ogc_intern_on;
+}
+
+/*------------------------------------------------------------------------
+ * internal look for a string in a chain
+ */
+static ogc_intern_str * ogc_intern_lookup(
+   ogc_intern_str * p,
+   const char *     str,
+   size_t           len,
+   size_t           hash)
+{
+   for (; p != OGC_NULL; p = p->next)
+   {
+      if ( p->hash == hash && p->len == len &&
+           memcmp(p->str, str, len) == 0 )
+      {
+         return p;
+      }
+   }
+
+   return OGC_NULL;
+}
+
+/*------------------------------------------------------------------------
+ * internal get the table, creating it if needed
+ */
+static ogc_intern_head * ogc_intern_get_table()
+{
+   void * t = ogc_thread::atomic_get(&ogc_intern_table);
+   void * old;
+
+   if ( t != OGC_NULL )
+      return static_cast<ogc_intern_head *>(t);
+
+   t = ::calloc(OGC_INTERN_BUCKETS, sizeof(ogc_intern_head));
+   if ( t == OGC_NULL )
+      return OGC_NULL;
+
+   old = ogc_thread::atomic_cas(&ogc_intern_table, OGC_NULL, t);
+   if ( old != OGC_NULL )
+   {
+      /* another thread created it first */
+      ::free(t);
+      return static_cast<ogc_intern_head *>(old);
+   }
+
+   ogc_thread::atomic_add(&ogc_intern_size,
+                          OGC_INTERN_BUCKETS * sizeof(ogc_intern_head));
+   return static_cast<ogc_intern_head *>(t);
+}
+
+/*------------------------------------------------------------------------
+ * internal get the table's copy of a string of a given length, adding
+ * it if it isn't there
+ */
+static const char * ogc_intern_add(
+   const char * str,
+   size_t       len)
+{
+   ogc_intern_head * t;
+   ogc_intern_head * b;
+   ogc_intern_str *  n = OGC_NULL;
+   size_t            hash;
+
+   t = ogc_intern_get_table();
+   if ( t == OGC_NULL )
+      return OGC_NULL;
+
+   hash = ogc_hash(str, len);
+   b    = t + (hash & (OGC_INTERN_BUCKETS - 1));
+
+   for (;;)
+   {
+      void *           head = ogc_thread::atomic_get(b);
+      ogc_intern_str * p    = ogc_intern_lookup(
+                                 static_cast<ogc_intern_str *>(head),
+                                 str, len, hash);
+
+      if ( p != OGC_NULL )
+      {
+         ::free(n);
+         return p->str;
+      }
+
+      if ( n == OGC_NULL )
+      {
+         n = static_cast<ogc_intern_str *>(
+                ::malloc(sizeof(*n) + len) );
+         if ( n == OGC_NULL )
+            return OGC_NULL;
+
+         n->hash = hash;
+         n->len  = len;
+         memcpy(n->str, str, len + 1);
+      }
+
+      n->next = static_cast<ogc_intern_str *>(head);
+      if ( ogc_thread::atomic_cas(b, head, n) == head )
+      {
+         break;
+      }
+   }
+
+   ogc_thread::atomic_add(&ogc_intern_count, 1);
+   ogc_thread::atomic_add(&ogc_intern_size,  sizeof(*n) + len);
+
+   return n->str;
+}
+
+/*------------------------------------------------------------------------
+ * get the table's copy of a string, adding it if it isn't there
+ */
+const char * ogc_intern :: add(const char * str)
+{
+   size_t len;
+
+   if ( str == OGC_NULL )
+      return OGC_NULL;
+
+   len = strlen(str);
+   if ( len >= OGC_NAME_MAX )
+      return OGC_NULL;
+
+   return ogc_intern_add(str, len);
+}
+
+/*------------------------------------------------------------------------
+ * get the table's copy of a string (if it is there)
+ */
+const char * ogc_intern :: find(const char * str)
+{
+   ogc_intern_head * t = static_cast<ogc_intern_head *>(
+                            ogc_thread::atomic_get(&ogc_intern_table) );
+   ogc_intern_str *  p;
+   size_t            len;
+   size_t            hash;
+
+   if ( str == OGC_NULL || t == OGC_NULL )
+      return OGC_NULL;
+
+   len  = strlen(str);
+   hash = ogc_hash(str, len);
+   p    = ogc_intern_lookup(static_cast<ogc_intern_str *>(
+                               ogc_thread::atomic_get(
+                                  t + (hash & (OGC_INTERN_BUCKETS - 1)) )),
+                            str, len, hash);
+
+   return (p == OGC_NULL) ? OGC_NULL : p->str;
+}
+
+/*------------------------------------------------------------------------
+ * get statistics
+ */
+size_t ogc_intern :: count()
+{
+   return ogc_intern_count;
+}
+
+size_t ogc_intern :: bytes()
+{
+   return ogc_intern_size;
+}
+
+/* ------------------------------------------------------------------------- */
+/* object strings                                                            */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * internal get the interned copy of a name (unescaped), or NULL if it is
+ * empty or can't be interned
+ */
+const char * ogc_str_pool :: intern(const char * str)
+{
+   OGC_NAME buf;
+   int      len = ogc_string::unescape_len(str);
+
+   if ( len <= 0 || len >= OGC_NAME_MAX )
+      return OGC_NULL;
+
+   ogc_string::unescape_str(buf, str, OGC_NAME_MAX);
+   return ogc_intern_add(buf, static_cast<size_t>(len));
+}
+
+} /* namespace OGC */
@@ -0,0 +1,223 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* keyword classification                                                    */
+/*                                                                           */
+/* A keyword is matched the same way as ogc_string::is_equal() does: case    */
+/* is ignored, as are whitespace and the "-_()/" chars.  The remaining       */
+/* chars are upper-cased and hashed, and the hash selects the only keyword   */
+/* that it could be, which is then compared.                                 */
+/*                                                                           */
+/* The slot table is generated: the multiplier was found by trying odd      */
+/* values until all keywords hashed to distinct slots.  If a keyword is      */
+/* added, a new multiplier and slot table must be generated the same way.    */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+#define OGC_KWD_MAX_LEN   22          /* longest keyword              */
+#define OGC_KWD_HASH_MUL  12263U      /* per-char hash multiplier     */
+#define OGC_KWD_HASH_MIX  0x9E3779B1U /* final mix (top 8 bits used)  */
+
+struct ogc_keyword_entry
+{
+   const char * kwd;    /* keyword with all ignorable chars removed */
+   int          len;    /* length of keyword                        */
+   ogc_obj_type type;   /* object type                              */
+   bool         old;    /* true if an old (WKT1) keyword            */
+};
+
+/*------------------------------------------------------------------------
+ * keyword table (entry 0 is an empty slot)
+ */
+static const ogc_keyword_entry ogc_keywords[] =
+{
+   { "",                         0, OGC_OBJ_TYPE_UNKNOWN,        false },
+   { "CITATION",                 8, OGC_OBJ_TYPE_CITATION,       false },
+   { "URI",                      3, OGC_OBJ_TYPE_URI,            false },
+   { "ID",                       2, OGC_OBJ_TYPE_ID,             false },
+   { "AUTHORITY",                9, OGC_OBJ_TYPE_ID,             true  },
+   { "UNIT",                     4, OGC_OBJ_TYPE_UNIT,           false },
+   { "ANGLEUNIT",                9, OGC_OBJ_TYPE_ANGUNIT,        false },
+   { "LENGTHUNIT",              10, OGC_OBJ_TYPE_LENUNIT,        false },
+   { "SCALEUNIT",                9, OGC_OBJ_TYPE_SCALEUNIT,      false },
+   { "TIMEUNIT",                 8, OGC_OBJ_TYPE_TIMEUNIT,       false },
+   { "PARAMETRICUNIT",          14, OGC_OBJ_TYPE_PARAMUNIT,      false },
+   { "SCOPE",                    5, OGC_OBJ_TYPE_SCOPE,          false },
+   { "AREA",                     4, OGC_OBJ_TYPE_AREA_EXTENT,    false },
+   { "BBOX",                     4, OGC_OBJ_TYPE_BBOX_EXTENT,    false },
+   { "VERTICALEXTENT",          14, OGC_OBJ_TYPE_VERT_EXTENT,    false },
+   { "TIMEEXTENT",              10, OGC_OBJ_TYPE_TIME_EXTENT,    false },
+   { "REMARK",                   6, OGC_OBJ_TYPE_REMARK,         false },
+   { "PARAMETER",                9, OGC_OBJ_TYPE_PARAMETER,      false },
+   { "PARAMETERFILE",           13, OGC_OBJ_TYPE_PARAM_FILE,     false },
+   { "ELLIPSOID",                9, OGC_OBJ_TYPE_ELLIPSOID,      false },
+   { "SPHEROID",                 8, OGC_OBJ_TYPE_ELLIPSOID,      false },
+   { "ANCHOR",                   6, OGC_OBJ_TYPE_ANCHOR,         false },
+   { "TIMEORIGIN",              10, OGC_OBJ_TYPE_TIME_ORIGIN,    false },
+   { "DATUM",                    5, OGC_OBJ_TYPE_GEOD_DATUM,     false },
+   { "GEODETICDATUM",           13, OGC_OBJ_TYPE_GEOD_DATUM,     false },
+   { "EDATUM",                   6, OGC_OBJ_TYPE_ENGR_DATUM,     false },
+   { "ENGINEERINGDATUM",        16, OGC_OBJ_TYPE_ENGR_DATUM,     false },
+   { "LOCALDATUM",              10, OGC_OBJ_TYPE_ENGR_DATUM,     true  },
+   { "IDATUM",                   6, OGC_OBJ_TYPE_IMAGE_DATUM,    false },
+   { "IMAGEDATUM",              10, OGC_OBJ_TYPE_IMAGE_DATUM,    false },
+   { "PDATUM",                   6, OGC_OBJ_TYPE_PARAM_DATUM,    false },
+   { "PARAMETRICDATUM",         15, OGC_OBJ_TYPE_PARAM_DATUM,    false },
+   { "TDATUM",                   6, OGC_OBJ_TYPE_TIME_DATUM,     false },
+   { "TIMEDATUM",                9, OGC_OBJ_TYPE_TIME_DATUM,     false },
+   { "VDATUM",                   6, OGC_OBJ_TYPE_VERT_DATUM,     false },
+   { "VERTICALDATUM",           13, OGC_OBJ_TYPE_VERT_DATUM,     false },
+   { "VERTDATUM",                9, OGC_OBJ_TYPE_VERT_DATUM,     true  },
+   { "PRIMEM",                   6, OGC_OBJ_TYPE_PRIMEM,         false },
+   { "PRIMEMERIDIAN",           13, OGC_OBJ_TYPE_PRIMEM,         false },
+   { "ORDER",                    5, OGC_OBJ_TYPE_ORDER,          false },
+   { "MERIDIAN",                 8, OGC_OBJ_TYPE_MERIDIAN,       false },
+   { "BEARING",                  7, OGC_OBJ_TYPE_BEARING,        false },
+   { "AXIS",                     4, OGC_OBJ_TYPE_AXIS,           false },
+   { "CS",                       2, OGC_OBJ_TYPE_CS,             false },
+   { "CONVERSION",              10, OGC_OBJ_TYPE_CONVERSION,     false },
+   { "DERIVINGCONVERSION",      18, OGC_OBJ_TYPE_DERIVING_CONV,  false },
+   { "METHOD",                   6, OGC_OBJ_TYPE_METHOD,         false },
+   { "PROJECTION",              10, OGC_OBJ_TYPE_METHOD,         false },
+   { "GEODCRS",                  7, OGC_OBJ_TYPE_GEOD_CRS,       false },
+   { "GEODETICCRS",             11, OGC_OBJ_TYPE_GEOD_CRS,       false },
+   { "GEOGCS",                   6, OGC_OBJ_TYPE_GEOD_CRS,       true  },
+   { "ENGCRS",                   6, OGC_OBJ_TYPE_ENGR_CRS,       false },
+   { "ENGINEERINGCRS",          14, OGC_OBJ_TYPE_ENGR_CRS,       false },
+   { "LOCALCS",                  7, OGC_OBJ_TYPE_ENGR_CRS,       true  },
+   { "IMAGECRS",                 8, OGC_OBJ_TYPE_IMAGE_CRS,      false },
+   { "PARAMETRICCRS",           13, OGC_OBJ_TYPE_PARAM_CRS,      false },
+   { "PROJCRS",                  7, OGC_OBJ_TYPE_PROJ_CRS,       false },
+   { "PROJECTEDCCRS",           13, OGC_OBJ_TYPE_PROJ_CRS,       false },
+   { "PROJCS",                   6, OGC_OBJ_TYPE_PROJ_CRS,       true  },
+   { "TIMECRS",                  7, OGC_OBJ_TYPE_TIME_CRS,       false },
+   { "VERTCRS",                  7, OGC_OBJ_TYPE_VERT_CRS,       false },
+   { "VERTICALCRS",             11, OGC_OBJ_TYPE_VERT_CRS,       false },
+   { "VERTCS",                   6, OGC_OBJ_TYPE_VERT_CRS,       true  },
+   { "COMPOUNDCRS",             11, OGC_OBJ_TYPE_COMPOUND_CRS,   false },
+   { "COMPDCS",                  7, OGC_OBJ_TYPE_COMPOUND_CRS,   true  },
+   { "BASEGEODCRS",             11, OGC_OBJ_TYPE_BASE_GEOD_CRS,  false },
+   { "BASEENGCRS",              10, OGC_OBJ_TYPE_BASE_ENGR_CRS,  false },
+   { "BASEPARAMETRICCRS",       17, OGC_OBJ_TYPE_BASE_PARAM_CRS, false },
+   { "BASEPROJCRS",             11, OGC_OBJ_TYPE_BASE_PROJ_CRS,  false },
+   { "BASETIMECRS",             11, OGC_OBJ_TYPE_BASE_TIME_CRS,  false },
+   { "BASEVERTCRS",             11, OGC_OBJ_TYPE_BASE_VERT_CRS,  false },
+   { "OPERATIONACCURACY",       17, OGC_OBJ_TYPE_OP_ACCURACY,    false },
+   { "COORDINATEOPERATION",     19, OGC_OBJ_TYPE_COORD_OP,       false },
+   { "BOUNDCRS",                 8, OGC_OBJ_TYPE_BOUND_CRS,      false },
+   { "ABRIDGEDTRANSFORMATION",  22, OGC_OBJ_TYPE_ABRTRANS,       false }
+};
+
+static const unsigned char ogc_keyword_slots[256] =
+{
+   26,  0,  1, 44,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 73,
+   28, 61,  0,  0, 47,  0,  0,  0, 68,  0,  0,  0,  0, 72,  0,  0,
+    0,  0,  2,  0, 64,  0, 45,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0, 49, 31,  0,  0, 69, 65,  0,  0, 56,  0,  0,  0, 35, 27,
+    0, 10,  0,  0,  0,  0,  0, 34,  0,  0,  0, 62, 54,  0,  0, 18,
+    0,  0,  0,  0,  0, 30,  0, 50, 59, 48,  0, 40,  5,  0, 42,  0,
+   70,  0, 23,  0, 22, 24,  0,  0,  0,  0,  0, 63, 36,  0,  3,  0,
+    0, 38,  0,  0,  0,  0,  0,  0, 11,  0,  4,  0,  0,  0,  0,  0,
+    0, 60,  0,  0, 17, 21, 51,  0,  0,  0,  0,  0, 39,  0,  0,  0,
+   53, 74,  0, 66,  0,  0,  0, 41,  0,  0, 16,  0,  0,  0,  0,  0,
+    0, 32,  0,  0,  0,  0,  0,  0,  0, 33, 13,  0, 71, 19,  0, 14,
+    0,  0,  0,  0,  0,  0,  0, 46,  0,  0,  0,  0,  0,  0,  0, 29,
+    0,  0, 57,  0, 25,  0,  0,  0,  9,  0,  0,  0,  0,  0,  0,  0,
+   20,  0,  0,  0,  0,  0, 52,  0,  0,  6,  0,  0,  0, 55,  0,  0,
+    0,  0, 37,  0,  0,  0,  0, 58,  0,  0,  0,  0,  8, 67,  7,  0,
+    0,  0,  0,  0,  0,  0,  0, 12,  0,  0,  0,  0,  0, 15,  0, 43
+};
+
+/*------------------------------------------------------------------------
+ * check if a char is ignored when comparing keywords
+ */
+static inline bool ogc_keyword_ignore(int c)
+{
+   switch (c)
+   {
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\v':
+      case '\f':
+      case '\r':
+      case '-':
+      case '_':
+      case '(':
+      case ')':
+      case '/':
+         return true;
+   }
+
+   return false;
+}
+
+/*------------------------------------------------------------------------
+ * get the object type of a keyword
+ *
+ * If len is negative, the string is null-terminated.
+ */
+ogc_obj_type ogc_keyword :: lookup(
+   const char * str,
+   int          len,
+   bool *       old)
+{
+   const unsigned char * s = reinterpret_cast<const unsigned char *>(str);
+   const unsigned char * e = s + (len < 0 ? 0 : len);
+   char                  buf[OGC_KWD_MAX_LEN];
+   unsigned int          h = 0;
+   int                   n = 0;
+
+   if ( old != OGC_NULL )
+      *old = false;
+
+   if ( s == OGC_NULL )
+      return OGC_OBJ_TYPE_UNKNOWN;
+
+   for (; len < 0 ? (*s != 0) : (s < e); s++)
+   {
+      int c = *s;
+
+      if ( ogc_keyword_ignore(c) )
+         continue;
+
+      if ( n == OGC_KWD_MAX_LEN )
+         return OGC_OBJ_TYPE_UNKNOWN;
+
+      if ( c >= 'a' && c <= 'z' )
+         c -= ('a' - 'A');
+
+      buf[n++] = static_cast<char>(c);
+      h = h * OGC_KWD_HASH_MUL + static_cast<unsigned int>(c);
+   }
+
+   h = ((h * OGC_KWD_HASH_MIX) & 0xffffffffU) >> 24;
+
+   const ogc_keyword_entry * k = ogc_keywords + ogc_keyword_slots[h];
+   if ( k->len != n || memcmp(k->kwd, buf, n) != 0 )
+      return OGC_OBJ_TYPE_UNKNOWN;
+
+   if ( old != OGC_NULL )
+      *old = k->old;
+
+   return k->type;
+}
+
+} /* namespace OGC */
@@ -0,0 +1,374 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* lazily-built object                                                       */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+/*------------------------------------------------------------------------
+ * LAZY_OBJECT constructor
+ *
+ * The tokens are kept in copy mode, so the caller's string isn't needed
+ * once it has been tokenized.
+ */
+ogc_lazy_object :: ogc_lazy_object() : _token(OGC_TOKEN_MODE_COPY)
+{
+   *_name = 0;
+   _obj   = OGC_NULL;
+   _kids  = OGC_NULL;
+   _nkids = 0;
+}
+
+/*------------------------------------------------------------------------
+ * new and delete (using the current allocator)
+ */
+void * ogc_lazy_object :: operator new(
+   size_t                 size,
+   const std::nothrow_t & nt) OGC_NOTHROW
+{
+   (void)(nt);
+   return ogc_allocator::current()->alloc(size);
+}
+
+void ogc_lazy_object :: operator delete(
+   void * p)
+{
+   ogc_allocator::free(p);
+}
+
+void ogc_lazy_object :: operator delete(
+   void *                 p,
+   const std::nothrow_t & nt) OGC_NOTHROW
+{
+   (void)(nt);
+   ogc_lazy_object::operator delete(p);
+}
+
+/*------------------------------------------------------------------------
+ * destroy
+ */
+ogc_lazy_object :: ~ogc_lazy_object()
+{
+   if ( _kids != OGC_NULL )
+   {
+      for (int i = 0; i < _nkids; i++)
+         _kids[i] = ogc_object::destroy( _kids[i] );
+      ogc_free(_kids);
+   }
+
+   _obj = ogc_object::destroy( _obj );
+}
+
+ogc_lazy_object * ogc_lazy_object :: destroy(
+   ogc_lazy_object * obj)
+{
+   if ( obj != OGC_NULL )
+   {
+      delete obj;
+   }
+   return OGC_NULL;
+}
+
+/*------------------------------------------------------------------------
+ * check if an object type has a name
+ * (its first token is something else for these types)
+ */
+static bool ogc_has_name(
+   ogc_obj_type type)
+{
+   switch (type)
+   {
+      case OGC_OBJ_TYPE_ANCHOR:
+      case OGC_OBJ_TYPE_AREA_EXTENT:
+      case OGC_OBJ_TYPE_BBOX_EXTENT:
+      case OGC_OBJ_TYPE_BEARING:
+      case OGC_OBJ_TYPE_BOUND_CRS:
+      case OGC_OBJ_TYPE_CITATION:
+      case OGC_OBJ_TYPE_CS:
+      case OGC_OBJ_TYPE_MERIDIAN:
+      case OGC_OBJ_TYPE_OP_ACCURACY:
+      case OGC_OBJ_TYPE_ORDER:
+      case OGC_OBJ_TYPE_REMARK:
+      case OGC_OBJ_TYPE_SCOPE:
+      case OGC_OBJ_TYPE_TIME_EXTENT:
+      case OGC_OBJ_TYPE_TIME_ORIGIN:
+      case OGC_OBJ_TYPE_URI:
+      case OGC_OBJ_TYPE_VERT_EXTENT:
+         return false;
+
+      default:
+         break;
+   }
+
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * lazy object from WKT
+ *
+ * Any error goes to the context's error routine (if there is one).
+ */
+ogc_lazy_object * ogc_lazy_object :: from_wkt(
+   const char * wkt,
+   ogc_error *  err)
+{
+   return from_wkt(OGC_NULL, wkt, err);
+}
+
+ogc_lazy_object * ogc_lazy_object :: from_wkt(
+   ogc_parse_ctx * ctx,
+   const char *    wkt,
+   ogc_error *     err)
+{
+   ogc_alloc_scope   ascope(ctx);
+   ogc_error         e;
+   ogc_error *       perr = ogc_parse_ctx::begin_err(ctx, err, &e);
+   ogc_lazy_object * p;
+
+   p = parse(ctx, wkt, perr);
+   ogc_parse_ctx::end_err(err, perr);
+
+   return p;
+}
+
+/*------------------------------------------------------------------------
+ * parse a lazy object
+ *
+ * Only the string is checked and tokenized here (and its keyword must
+ * be known), and the name (the first non-object token of an object that
+ * has a name) is saved.
+ * The children are just counted by jumping from the end of each one to
+ * the next.
+ */
+ogc_lazy_object * ogc_lazy_object :: parse(
+   ogc_parse_ctx * ctx,
+   const char *    wkt,
+   ogc_error *     err)
+{
+   const char * kwd = ogc_object::obj_kwd();
+   const ogc_token_entry * arr;
+   ogc_lazy_object * p;
+   int end;
+   int same;
+
+   p = new (std::nothrow) ogc_lazy_object();
+   if ( p == OGC_NULL )
+   {
+      ogc_error::set(err, OGC_ERR_NO_MEMORY, kwd);
+      return p;
+   }
+
+   p->_token.set_ctx(ctx);
+   if ( !p->_token.tokenize(wkt, kwd, err) )
+   {
+      delete p;
+      return OGC_NULL;
+   }
+   arr  = p->_token._arr;
+   end  = arr[0].end;
+   same = arr[0].same;
+
+   if ( arr[0].type == OGC_OBJ_TYPE_UNKNOWN )
+   {
+      ogc_error::set(err, OGC_ERR_WKT_UNKNOWN_KEYWORD, kwd,
+         p->_token.str(0));
+      delete p;
+      return OGC_NULL;
+   }
+
+   if ( same >= 1 && ogc_has_name(arr[0].type) )
+   {
+      const char * name = p->_token.str(1);
+      int len = ogc_string::unescape_len(name);
+
+      if ( len >= OGC_NAME_MAX )
+      {
+         ogc_error::set(err, OGC_ERR_NAME_TOO_LONG, kwd, len);
+         delete p;
+         return OGC_NULL;
+      }
+      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+   }
+
+   for (int i = 1 + same; i < end; i = arr[i].end)
+      p->_nkids++;
+
+   return p;
+}
+
+/*------------------------------------------------------------------------
+ * get the object type
+ *
+ * This is the type of the object that object() builds, so a UNIT is
+ * taken as an angle unit (as ogc_object::from_tokens() does).
+ */
+ogc_obj_type ogc_lazy_object :: obj_type() const
+{
+   ogc_obj_type type = _token.type(0);
+
+   if ( type == OGC_OBJ_TYPE_UNIT )
+      type = OGC_OBJ_TYPE_ANGUNIT;
+
+   return type;
+}
+
+/*------------------------------------------------------------------------
+ * get the token index of the nth child
+ */
+int ogc_lazy_object :: kid_index(int n) const
+{
+   const ogc_token_entry * arr = _token._arr;
+   int i = 1 + arr[0].same;
+
+   if ( n < 0 || n >= _nkids )
+      return -1;
+
+   for (; n > 0; n--)
+      i = arr[i].end;
+
+   return i;
+}
+
+/*------------------------------------------------------------------------
+ * get the type of the nth child
+ */
+ogc_obj_type ogc_lazy_object :: child_type(int n) const
+{
+   int i = kid_index(n);
+
+   if ( i < 0 )
+      return OGC_OBJ_TYPE_UNKNOWN;
+
+   return _token.type(i);
+}
+
+/*------------------------------------------------------------------------
+ * get the nth child, building it if needed
+ */
+ogc_object * ogc_lazy_object :: child(
+   int          n,
+   ogc_error *  err)
+{
+   int i = kid_index(n);
+
+   ogc_error::clear(err);
+
+   if ( i < 0 )
+   {
+      ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE,
+         ogc_object::obj_kwd(), n);
+      return OGC_NULL;
+   }
+
+   /* the child array is allocated when the first child is built */
+   if ( _kids == OGC_NULL )
+   {
+      _kids = ogc_alloc<ogc_object *>(_nkids);
+      if ( _kids == OGC_NULL )
+      {
+         ogc_error::set(err, OGC_ERR_NO_MEMORY, ogc_object::obj_kwd());
+         return OGC_NULL;
+      }
+      memset(_kids, 0, _nkids * sizeof(*_kids));
+   }
+
+   if ( _kids[n] == OGC_NULL )
+   {
+      ogc_error   e;
+      ogc_error * perr = ogc_parse_ctx::begin_err(_token.ctx(), err, &e);
+
+      _kids[n] = ogc_object::from_tokens(&_token, i, OGC_NULL, perr);
+      ogc_parse_ctx::end_err(err, perr);
+   }
+
+   return _kids[n];
+}
+
+/*------------------------------------------------------------------------
+ * get the nth child of a given type, building it if needed
+ */
+ogc_object * ogc_lazy_object :: find(
+   ogc_obj_type type,
+   int          n,
+   ogc_error *  err)
+{
+   const ogc_token_entry * arr = _token._arr;
+   int i = 1 + arr[0].same;
+
+   ogc_error::clear(err);
+
+   for (int k = 0; k < _nkids; k++, i = arr[i].end)
+   {
+      if ( arr[i].type == type && n-- == 0 )
+         return child(k, err);
+   }
+
+   return OGC_NULL;
+}
+
+/*------------------------------------------------------------------------
+ * get the number of IDs
+ */
+int ogc_lazy_object :: id_count() const
+{
+   const ogc_token_entry * arr = _token._arr;
+   int i     = 1 + arr[0].same;
+   int count = 0;
+
+   for (int k = 0; k < _nkids; k++, i = arr[i].end)
+   {
+      if ( arr[i].type == OGC_OBJ_TYPE_ID )
+         count++;
+   }
+
+   return count;
+}
+
+/*------------------------------------------------------------------------
+ * get the nth ID, building it if needed
+ */
+ogc_id * ogc_lazy_object :: id(
+   int          n,
+   ogc_error *  err)
+{
+   return static_cast<ogc_id *>( find(OGC_OBJ_TYPE_ID, n, err) );
+}
+
+/*------------------------------------------------------------------------
+ * get the whole object, building it if needed
+ */
+ogc_object * ogc_lazy_object :: object(
+   ogc_error *  err)
+{
+   ogc_error::clear(err);
+
+   if ( _obj == OGC_NULL )
+   {
+      ogc_error   e;
+      ogc_error * perr = ogc_parse_ctx::begin_err(_token.ctx(), err, &e);
+
+      _obj = ogc_object::from_tokens(&_token, 0, OGC_NULL, perr);
+      ogc_parse_ctx::end_err(err, perr);
+   }
+
+   return _obj;
+}
+
+} /* namespace OGC */
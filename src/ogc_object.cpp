@@ -46,8 +46,58 @@ bool ogc_object :: set_strict_parsing(bool on_off)
    return rc;
 }
 
+/*------------------------------------------------------------------------
+ * allocation
+ *
+ * Objects come from the current allocator, except while validating (or
+ * parsing into an arena), when they are taken from scratch memory, and
+ * are never freed.
+ */
+void * ogc_object :: operator new(
+   size_t                 size,
+   const std::nothrow_t & nt) OGC_NOTHROW
+{
+   (void)(nt);
+   return ogc_scratch::alloc(size);
+}
+
+void * ogc_object :: operator new(
+   size_t                 size,
+   size_t                 extra,
+   const std::nothrow_t & nt) OGC_NOTHROW
+{
+   (void)(nt);
+   return ogc_scratch::alloc(size + extra);
+}
+
+void ogc_object :: operator delete(
+   void * p)
+{
+   ogc_allocator::free(p);
+}
+
+void ogc_object :: operator delete(
+   void *                 p,
+   const std::nothrow_t & nt) OGC_NOTHROW
+{
+   (void)(nt);
+   ogc_object::operator delete(p);
+}
+
+void ogc_object :: operator delete(
+   void *                 p,
+   size_t                 extra,
+   const std::nothrow_t & nt) OGC_NOTHROW
+{
+   (void)(extra);
+   (void)(nt);
+   ogc_object::operator delete(p);
+}
+
 /*------------------------------------------------------------------------
  * destroy
+ *
+ * A shared object is only deleted by its last owner.
  */
 ogc_object :: ~ogc_object()
 {
@@ -58,7 +108,8 @@ ogc_object * ogc_object :: destroy(
 {
    if ( obj != OGC_NULL )
    {
-      delete obj;
+      if ( !obj->_shared || ogc_share_table::release(obj) )
+         delete obj;
    }
    return OGC_NULL;
 }
@@ -77,70 +128,75 @@ ogc_object * ogc_object :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_EMPTY_STRING, obj_kwd());
       return OGC_NULL;
    }
+   ogc_err_pos epos(t, start);
+
+#  define CHECK(type, n) \
+      case OGC_OBJ_TYPE_##type: \
+         return ogc_##n :: from_tokens(t, start, pend, err)
 
-   const char * kwd = t->_arr[start].str;
-
-#  define CHECK(n) \
-   if ( ogc_##n::is_kwd(kwd) ) \
-      return ogc_##n :: from_tokens(t, start, pend, err)
-
-   CHECK( abrtrans        );
-   CHECK( anchor          );
-   CHECK( angunit         );
-   CHECK( area_extent     );
-   CHECK( axis            );
-   CHECK( base_engr_crs   );
-   CHECK( base_geod_crs   );
-   CHECK( base_param_crs  );
-   CHECK( base_proj_crs   );
-   CHECK( base_time_crs   );
-   CHECK( base_vert_crs   );
-   CHECK( bbox_extent     );
-   CHECK( bearing         );
-   CHECK( bound_crs       );
-   CHECK( citation        );
-   CHECK( compound_crs    );
-   CHECK( conversion      );
-   CHECK( coord_op        );
-   CHECK( cs              );
-   CHECK( deriving_conv   );
-   CHECK( ellipsoid       );
-   CHECK( engr_crs        );
-   CHECK( engr_datum      );
-   CHECK( geod_crs        );
-   CHECK( geod_datum      );
-   CHECK( id              );
-   CHECK( image_crs       );
-   CHECK( image_datum     );
-   CHECK( lenunit         );
-   CHECK( meridian        );
-   CHECK( method          );
-   CHECK( op_accuracy     );
-   CHECK( order           );
-   CHECK( parameter       );
-   CHECK( param_file      );
-   CHECK( param_crs       );
-   CHECK( param_datum     );
-   CHECK( paramunit       );
-   CHECK( primem          );
-   CHECK( proj_crs        );
-   CHECK( remark          );
-   CHECK( scaleunit       );
-   CHECK( scope           );
-   CHECK( time_crs        );
-   CHECK( time_datum      );
-   CHECK( time_extent     );
-   CHECK( time_origin     );
-   CHECK( timeunit        );
-   CHECK( unit            );
-   CHECK( uri             );
-   CHECK( vert_crs        );
-   CHECK( vert_datum      );
-   CHECK( vert_extent     );
+   switch (t->type(start))
+   {
+      CHECK( ABRTRANS,       abrtrans       );
+      CHECK( ANCHOR,         anchor         );
+      case OGC_OBJ_TYPE_UNIT:               /* taken as an angle unit */
+      CHECK( ANGUNIT,        angunit        );
+      CHECK( AREA_EXTENT,    area_extent    );
+      CHECK( AXIS,           axis           );
+      CHECK( BASE_ENGR_CRS,  base_engr_crs  );
+      CHECK( BASE_GEOD_CRS,  base_geod_crs  );
+      CHECK( BASE_PARAM_CRS, base_param_crs );
+      CHECK( BASE_PROJ_CRS,  base_proj_crs  );
+      CHECK( BASE_TIME_CRS,  base_time_crs  );
+      CHECK( BASE_VERT_CRS,  base_vert_crs  );
+      CHECK( BBOX_EXTENT,    bbox_extent    );
+      CHECK( BEARING,        bearing        );
+      CHECK( BOUND_CRS,      bound_crs      );
+      CHECK( CITATION,       citation       );
+      CHECK( COMPOUND_CRS,   compound_crs   );
+      CHECK( CONVERSION,     conversion     );
+      CHECK( COORD_OP,       coord_op       );
+      CHECK( CS,             cs             );
+      CHECK( DERIVING_CONV,  deriving_conv  );
+      CHECK( ELLIPSOID,      ellipsoid      );
+      CHECK( ENGR_CRS,       engr_crs       );
+      CHECK( ENGR_DATUM,     engr_datum     );
+      CHECK( GEOD_CRS,       geod_crs       );
+      CHECK( GEOD_DATUM,     geod_datum     );
+      CHECK( ID,             id             );
+      CHECK( IMAGE_CRS,      image_crs      );
+      CHECK( IMAGE_DATUM,    image_datum    );
+      CHECK( LENUNIT,        lenunit        );
+      CHECK( MERIDIAN,       meridian       );
+      CHECK( METHOD,         method         );
+      CHECK( OP_ACCURACY,    op_accuracy    );
+      CHECK( ORDER,          order          );
+      CHECK( PARAMETER,      parameter      );
+      CHECK( PARAM_FILE,     param_file     );
+      CHECK( PARAM_CRS,      param_crs      );
+      CHECK( PARAM_DATUM,    param_datum    );
+      CHECK( PARAMUNIT,      paramunit      );
+      CHECK( PRIMEM,         primem         );
+      CHECK( PROJ_CRS,       proj_crs       );
+      CHECK( REMARK,         remark         );
+      CHECK( SCALEUNIT,      scaleunit      );
+      CHECK( SCOPE,          scope          );
+      CHECK( TIME_CRS,       time_crs       );
+      CHECK( TIME_DATUM,     time_datum     );
+      CHECK( TIME_EXTENT,    time_extent    );
+      CHECK( TIME_ORIGIN,    time_origin    );
+      CHECK( TIMEUNIT,       timeunit       );
+      CHECK( URI,            uri            );
+      CHECK( VERT_CRS,       vert_crs       );
+      CHECK( VERT_DATUM,     vert_datum     );
+      CHECK( VERT_EXTENT,    vert_extent    );
+
+      default:
+         break;
+   }
 
 #  undef CHECK
 
-   ogc_error::set(err, OGC_ERR_WKT_UNKNOWN_KEYWORD, obj_kwd(), kwd);
+   ogc_error::set(err, OGC_ERR_WKT_UNKNOWN_KEYWORD, obj_kwd(), t->str(start));
    return OGC_NULL;
 }
 
@@ -151,14 +207,156 @@ ogc_object* ogc_object :: from_wkt(
    const char * wkt,
    ogc_error *  err)
 {
-   ogc_token t;
+   return from_wkt(wkt, err, OGC_NULL);
+}
+
+ogc_object* ogc_object :: from_wkt(
+   ogc_parse_ctx * ctx,
+   const char *    wkt,
+   ogc_error *     err)
+{
+   return from_wkt(ctx, wkt, err, OGC_NULL);
+}
+
+/*------------------------------------------------------------------------
+ * object from WKT (in an arena)
+ *
+ * Only the objects are taken from the arena, as the tokens are only
+ * needed while parsing.
+ */
+ogc_object* ogc_object :: from_wkt(
+   const char * wkt,
+   ogc_error *  err,
+   ogc_arena *  arena)
+{
+   ogc_token     t(OGC_TOKEN_MODE_SPAN);
+   ogc_scratch * s   = OGC_NULL;
+   ogc_object *  obj = OGC_NULL;
 
-   if ( ! t.tokenize(wkt, obj_kwd(), err) )
+   if ( arena != OGC_NULL )
    {
-      return OGC_NULL;
+      s = arena->mem();
+      if ( s == OGC_NULL )
+      {
+         ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+         return OGC_NULL;
+      }
    }
 
-   return from_tokens(&t, 0, OGC_NULL, err);
+   if ( t.tokenize(wkt, obj_kwd(), err) )
+   {
+      if ( s != OGC_NULL )
+         s->begin();
+      obj = from_tokens(&t, 0, OGC_NULL, err);
+      if ( s != OGC_NULL )
+         s->end();
+   }
+
+   return obj;
+}
+
+ogc_object* ogc_object :: from_wkt(
+   ogc_parse_ctx * ctx,
+   const char *    wkt,
+   ogc_error *     err,
+   ogc_arena *     arena)
+{
+   ogc_alloc_scope ascope(ctx);
+   ogc_token       t(OGC_TOKEN_MODE_SPAN);
+   ogc_error       e;
+   ogc_error *     perr = ogc_parse_ctx::begin_err(ctx, err, &e);
+   ogc_scratch *   s    = OGC_NULL;
+   ogc_object *    obj  = OGC_NULL;
+
+   if ( arena != OGC_NULL )
+   {
+      s = arena->mem();
+      if ( s == OGC_NULL )
+      {
+         ogc_error::set(perr, OGC_ERR_NO_MEMORY, obj_kwd());
+         ogc_parse_ctx::end_err(err, perr);
+         return OGC_NULL;
+      }
+   }
+
+   t.set_ctx(ctx);
+   if ( t.tokenize(wkt, obj_kwd(), perr) )
+   {
+      if ( s != OGC_NULL )
+         s->begin();
+      obj = from_tokens(&t, 0, OGC_NULL, perr);
+      if ( s != OGC_NULL )
+         s->end();
+   }
+   ogc_parse_ctx::end_err(err, perr);
+
+   return obj;
+}
+
+/*------------------------------------------------------------------------
+ * validate a WKT string
+ *
+ * The token object is kept, so its memory is re-used.  The object tree
+ * is built in scratch memory, and is just discarded when done.
+ */
+static bool ogc_validate(
+   ogc_token *   t,
+   ogc_scratch * s,
+   const char *  wkt,
+   ogc_error *   err)
+{
+   ogc_object * obj;
+
+   if ( ! t->tokenize(wkt, ogc_object::obj_kwd(), err) )
+   {
+      return false;
+   }
+
+   s->begin();
+   obj = ogc_object::from_tokens(t, 0, OGC_NULL, err);
+   s->end();
+   s->reset();
+
+   return (obj != OGC_NULL);
+}
+
+bool ogc_object :: validate_wkt(
+   const char * wkt,
+   ogc_error *  err)
+{
+   static ogc_token   t(OGC_TOKEN_MODE_SPAN);
+   static ogc_scratch s;
+
+   return ogc_validate(&t, &s, wkt, err);
+}
+
+bool ogc_object :: validate_wkt(
+   ogc_parse_ctx * ctx,
+   const char *    wkt,
+   ogc_error *     err)
+{
+   ogc_token *   t;
+   ogc_scratch * s;
+   ogc_error     e;
+   ogc_error *   perr;
+   bool          rc = false;
+
+   if ( ctx == OGC_NULL )
+      return validate_wkt(wkt, err);
+
+   ogc_alloc_scope ascope(ctx);
+
+   perr = ogc_parse_ctx::begin_err(ctx, err, &e);
+
+   t = ctx->token();
+   s = ctx->scratch();
+   if ( t == OGC_NULL || s == OGC_NULL )
+      ogc_error::set(perr, OGC_ERR_NO_MEMORY, obj_kwd());
+   else
+      rc = ogc_validate(t, s, wkt, perr);
+
+   ogc_parse_ctx::end_err(err, perr);
+   return rc;
 }
 
 /*------------------------------------------------------------------------
@@ -185,10 +383,30 @@ bool ogc_object :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_object :: to_wkt(
+   const ogc_object * obj,
+   ogc_wkt_writer &   w,
+   int                options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
 
+bool ogc_object :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    if ( !is_visible() )
       return true;
 
@@ -197,7 +415,7 @@ bool ogc_object :: to_wkt(
 #  define CASE(o,n) \
       case OGC_OBJ_TYPE_##o: \
          return (reinterpret_cast<const ogc_##n *>(this))-> \
-                to_wkt(buffer, options, buflen)
+                to_wkt(w, options)
 
       CASE( ABRTRANS,        abrtrans        );
       CASE( ANCHOR,          anchor          );
@@ -86,14 +86,18 @@ ogc_param_crs * ogc_param_crs :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_param_crs();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_param_crs();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type      = OGC_OBJ_TYPE_PARAM_CRS;
       p->_visible       = true;
       p->_crs_type      = OGC_CRS_TYPE_PARAM;
@@ -175,14 +179,18 @@ ogc_param_crs * ogc_param_crs :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_param_crs();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_param_crs();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type      = OGC_OBJ_TYPE_PARAM_CRS;
       p->_visible       = true;
       p->_crs_type      = OGC_CRS_TYPE_PARAM;
@@ -235,10 +243,8 @@ ogc_param_crs * ogc_param_crs :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  end;
    int  same;
-   int  num;
 
    ogc_param_crs *      obj      = OGC_NULL;
    ogc_param_datum *    datum    = OGC_NULL;
@@ -271,35 +277,24 @@ ogc_param_crs * ogc_param_crs :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_PARAM_CRS )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 1 token: PARAMCRS[ "name" ...
@@ -310,7 +305,7 @@ ogc_param_crs * ogc_param_crs :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 1 && get_strict_parsing() )
+   if ( same > 1 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -322,7 +317,7 @@ ogc_param_crs * ogc_param_crs :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name = arr[start++].str;
+   name = t->str(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -330,236 +325,222 @@ ogc_param_crs * ogc_param_crs :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_param_datum::is_kwd(arr[i].str) )
-      {
-         if ( datum != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_DATUM, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            datum = ogc_param_datum::from_tokens(t, i, &next, err);
-            if ( datum == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
-
-      if ( ogc_base_param_crs::is_kwd(arr[i].str) )
-      {
-         if ( base_crs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_BASE_CRS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            base_crs = ogc_base_param_crs::from_tokens(t, i, &next, err);
-            if ( base_crs == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_deriving_conv::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         if ( conv != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_CONVERSION, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            conv = ogc_deriving_conv::from_tokens(t, i, &next, err);
-            if ( conv == OGC_NULL )
+         case OGC_OBJ_TYPE_PARAM_DATUM:
+            if ( datum != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_DATUM, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               datum = ogc_param_datum::from_tokens(t, i, &next, err);
+               if ( datum == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_cs::is_kwd(arr[i].str) )
-      {
-         if ( cs != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_CS, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            cs = ogc_cs::from_tokens(t, i, &next, err);
-            if ( cs == OGC_NULL )
+         case OGC_OBJ_TYPE_BASE_PARAM_CRS:
+            if ( base_crs != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_BASE_CRS, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               base_crs = ogc_base_param_crs::from_tokens(t, i, &next, err);
+               if ( base_crs == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_axis::is_kwd(arr[i].str) )
-      {
-         axis = ogc_axis::from_tokens(t, i, &next, err);
-         if ( axis == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( !ogc_utils::place_axis(axis, &axis_1, OGC_NULL, OGC_NULL,
-                                        obj_kwd(), err) )
+         case OGC_OBJ_TYPE_DERIVING_CONV:
+            if ( conv != OGC_NULL )
             {
-               delete axis;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_CONVERSION, obj_kwd());
                bad = true;
             }
-         }
-         continue;
-      }
+            else
+            {
+               conv = ogc_deriving_conv::from_tokens(t, i, &next, err);
+               if ( conv == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_paramunit::is_kwd(arr[i].str) )
-      {
-         if ( unit != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            unit = ogc_paramunit::from_tokens(t, i, &next, err);
-            if ( unit == OGC_NULL )
+         case OGC_OBJ_TYPE_CS:
+            if ( cs != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_CS, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               cs = ogc_cs::from_tokens(t, i, &next, err);
+               if ( cs == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      if ( ogc_scope::is_kwd(arr[i].str) )
-      {
-         if ( scope != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SCOPE, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            scope = ogc_scope::from_tokens(t, i, &next, err);
-            if ( scope == OGC_NULL )
+         case OGC_OBJ_TYPE_AXIS:
+            axis = ogc_axis::from_tokens(t, i, &next, err);
+            if ( axis == OGC_NULL )
+            {
                bad = true;
-         }
-         continue;
-      }
-
-      if ( ogc_extent::is_kwd(arr[i].str) )
-      {
-         extent = ogc_extent::from_tokens(t, i, &next, err);
-         if ( extent == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( extents == OGC_NULL )
+            }
+            else
             {
-               extents = ogc_vector::create(1, 1);
-               if ( extents == OGC_NULL )
+               if ( !ogc_utils::place_axis(axis, &axis_1, OGC_NULL, OGC_NULL,
+                                           obj_kwd(), err) )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete extent;
+                  delete axis;
                   bad = true;
                }
             }
+            break;
 
-            if ( extents != OGC_NULL )
+         case OGC_OBJ_TYPE_PARAMUNIT:
+         case OGC_OBJ_TYPE_UNIT:
+            if ( unit != OGC_NULL )
             {
-               void * p = extents->find(
-                             extent,
-                             false,
-                             ogc_utils::compare_extent);
-               if ( p != OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_EXTENT,
-                     obj_kwd(),
-                     ogc_utils::obj_type_to_kwd(extent->obj_type()));
-                  delete extent;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               unit = ogc_paramunit::from_tokens(t, i, &next, err);
+               if ( unit == OGC_NULL )
                   bad = true;
-               }
-               else
+            }
+            break;
+
+         case OGC_OBJ_TYPE_SCOPE:
+            if ( scope != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_SCOPE, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               scope = ogc_scope::from_tokens(t, i, &next, err);
+               if ( scope == OGC_NULL )
+                  bad = true;
+            }
+            break;
+
+         case OGC_OBJ_TYPE_AREA_EXTENT:
+         case OGC_OBJ_TYPE_BBOX_EXTENT:
+         case OGC_OBJ_TYPE_TIME_EXTENT:
+         case OGC_OBJ_TYPE_VERT_EXTENT:
+            extent = ogc_extent::from_tokens(t, i, &next, err);
+            if ( extent == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
+            {
+               if ( extents == OGC_NULL )
                {
-                  if ( extents->add( extent ) < 0 )
+                  extents = ogc_vector::create(1, 1);
+                  if ( extents == OGC_NULL )
                   {
                      ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
                      delete extent;
                      bad = true;
                   }
                }
-            }
-         }
-         continue;
-      }
 
-      if ( ogc_id::is_kwd(arr[i].str) )
-      {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
-            {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
+               if ( extents != OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
-                  bad = true;
+                  void * p = extents->find(
+                                extent,
+                                false,
+                                ogc_utils::compare_extent);
+                  if ( p != OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_EXTENT,
+                        obj_kwd(),
+                        ogc_utils::obj_type_to_kwd(extent->obj_type()));
+                     delete extent;
+                     bad = true;
+                  }
+                  else
+                  {
+                     if ( extents->add( extent ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete extent;
+                        bad = true;
+                     }
+                  }
                }
             }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      if ( ogc_remark::is_kwd(arr[i].str) )
-      {
-         if ( remark != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            remark = ogc_remark::from_tokens(t, i, &next, err);
-            if ( remark == OGC_NULL )
+         case OGC_OBJ_TYPE_REMARK:
+            if ( remark != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_REMARK, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               remark = ogc_remark::from_tokens(t, i, &next, err);
+               if ( remark == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -571,6 +552,9 @@ ogc_param_crs * ogc_param_crs :: from_tokens(
    {
       if ( base_crs != OGC_NULL )
       {
+         cs   = ogc_share_obj(cs);
+         unit = ogc_share_obj(unit);
+
          obj = create(name, base_crs, conv, cs, axis_1, unit,
                       scope, extents, ids, remark, err);
 
@@ -580,6 +564,9 @@ ogc_param_crs * ogc_param_crs :: from_tokens(
       }
       else
       {
+         cs   = ogc_share_obj(cs);
+         unit = ogc_share_obj(unit);
+
          obj = create(name, datum, cs, axis_1, unit,
                       scope, extents, ids, remark, err);
 
@@ -616,7 +603,7 @@ ogc_param_crs * ogc_param_crs :: from_wkt(
    ogc_error *  err)
 {
    ogc_param_crs * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -650,72 +637,58 @@ bool ogc_param_crs :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_datum;
-   OGC_TBUF      buf_base_crs;
-   OGC_TBUF      buf_conv;
-   OGC_TBUF      buf_cs;
-   OGC_TBUF      buf_axis_1;
-   OGC_TBUF      buf_unit;
-   OGC_TBUF      buf_scope;
-   OGC_TBUF      buf_extent;
-   OGC_TBUF      buf_id;
-   OGC_TBUF      buf_remark;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_param_crs :: to_wkt(
+   const ogc_param_crs * obj,
+   ogc_wkt_writer &      w,
+   int                   options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_param_crs :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
    if ( (opts & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       return true;
 
-   rc &= ogc_param_datum    :: to_wkt(_datum,         buf_datum,    opts, OGC_TBUF_MAX);
-   rc &= ogc_base_param_crs :: to_wkt(_base_crs,      buf_base_crs, opts, OGC_TBUF_MAX);
-   rc &= ogc_deriving_conv  :: to_wkt(_deriving_conv, buf_conv,     opts, OGC_TBUF_MAX);
-   rc &= ogc_cs             :: to_wkt(_cs,            buf_cs,       opts, OGC_TBUF_MAX);
-   rc &= ogc_axis           :: to_wkt(_axis_1,        buf_axis_1,   opts, OGC_TBUF_MAX);
-   rc &= ogc_unit           :: to_wkt(_unit,          buf_unit,     opts, OGC_TBUF_MAX);
-   rc &= ogc_scope          :: to_wkt(_scope,         buf_scope,    opts, OGC_TBUF_MAX);
-   rc &= ogc_remark         :: to_wkt(_remark,        buf_remark,   opts, OGC_TBUF_MAX);
-
-   ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\"",
-      kwd, opn, buf_name);
-
-   OGC_CPY_TO_BUF( buf_hdr      );
-   OGC_ADD_TO_BUF( buf_datum    );
-   OGC_ADD_TO_BUF( buf_base_crs );
-   OGC_ADD_TO_BUF( buf_conv     );
-   OGC_ADD_TO_BUF( buf_cs       );
-   OGC_ADD_TO_BUF( buf_axis_1   );
-   OGC_ADD_TO_BUF( buf_unit     );
-   OGC_ADD_TO_BUF( buf_scope    );
+   w.open(kwd, options);
+   w.put_str(_name);
+   rc &= ogc_param_datum    :: to_wkt(_datum,         w, opts);
+   rc &= ogc_base_param_crs :: to_wkt(_base_crs,      w, opts);
+   rc &= ogc_deriving_conv  :: to_wkt(_deriving_conv, w, opts);
+   rc &= ogc_cs             :: to_wkt(_cs,            w, opts);
+   rc &= ogc_axis           :: to_wkt(_axis_1,        w, opts);
+   rc &= ogc_unit           :: to_wkt(_unit,          w, opts);
+   rc &= ogc_scope          :: to_wkt(_scope,         w, opts);
 
    if ( _extents != OGC_NULL )
    {
       for (int i = 0; i < extent_count(); i++)
       {
-         rc &= ogc_extent :: to_wkt(extent(i), buf_extent, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_extent );
+         rc &= ogc_extent :: to_wkt(extent(i), w, opts);
       }
    }
 
@@ -723,19 +696,12 @@ bool ogc_param_crs :: to_wkt(
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
       }
    }
 
-   OGC_ADD_TO_BUF( buf_remark );
-   OGC_CPY_TO_BUF( cls        );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   rc &= ogc_remark :: to_wkt(_remark, w, opts);
+   w.close(options);
 
    return rc;
 }
@@ -757,9 +723,9 @@ ogc_param_crs * ogc_param_crs :: clone() const
    ogc_param_datum *    datum     = OGC_NULL;
    ogc_base_param_crs * base_crs  = OGC_NULL;
    ogc_deriving_conv *  conv      = OGC_NULL;
-   ogc_cs *             cs        = ogc_cs        :: clone( _cs      );
+   ogc_cs *             cs        = ogc_share_clone( _cs );
    ogc_axis *           axis_1    = ogc_axis      :: clone( _axis_1  );
-   ogc_paramunit *      paramunit = ogc_paramunit :: clone( u        );
+   ogc_paramunit *      paramunit = ogc_share_clone( u );
    ogc_scope *          scope     = ogc_scope     :: clone( _scope   );
    ogc_vector *         extents   = ogc_vector    :: clone( _extents );
    ogc_vector *         ids       = ogc_vector    :: clone( _ids     );
@@ -0,0 +1,242 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* parse context                                                             */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+/*------------------------------------------------------------------------
+ * PARSE_CTX constructor
+ *
+ * A new context has the default settings (not the current global ones).
+ */
+ogc_parse_ctx :: ogc_parse_ctx()
+{
+   _strict    = true;
+   _max_len   = 0;
+   _err_rtn   = OGC_NULL;
+   _err_data  = OGC_NULL;
+   _token     = OGC_NULL;
+   _scratch   = OGC_NULL;
+   _quiet     = false;
+   _keep_errs = false;
+   _num_errs  = 0;
+   _err_pos   = OGC_ERR_POS_NONE;
+   _alloc     = OGC_NULL;
+}
+
+/*------------------------------------------------------------------------
+ * PARSE_CTX destructor
+ */
+ogc_parse_ctx :: ~ogc_parse_ctx()
+{
+   ogc_delete(_token);
+   ogc_delete(_scratch);
+}
+
+/*------------------------------------------------------------------------
+ * set the strict parsing option
+ */
+bool ogc_parse_ctx :: set_strict(bool on_off)
+{
+   bool rc = _strict;
+   _strict = on_off;
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * set the error call-back routine
+ */
+void ogc_parse_ctx :: set_err_rtn(
+   ogc_error::OGC_ERR_RTN * rtn,
+   void *                   data)
+{
+   _err_rtn  = rtn;
+   _err_data = data;
+}
+
+/*------------------------------------------------------------------------
+ * set the quiet option
+ */
+bool ogc_parse_ctx :: set_quiet(bool on_off)
+{
+   bool rc = _quiet;
+   _quiet = on_off;
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * set the keep errors option
+ */
+bool ogc_parse_ctx :: set_keep_errs(bool on_off)
+{
+   bool rc = _keep_errs;
+   _keep_errs = on_off;
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * set the allocator (OGC_NULL for the global one)
+ */
+ogc_allocator * ogc_parse_ctx :: set_allocator(ogc_allocator * a)
+{
+   ogc_allocator * rc = _alloc;
+   _alloc = a;
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * get the number of error records held
+ */
+size_t ogc_parse_ctx :: errs_held() const
+{
+   return (_num_errs < OGC_CTX_ERRS_MAX) ? _num_errs : OGC_CTX_ERRS_MAX;
+}
+
+/*------------------------------------------------------------------------
+ * get the n-th error record held (oldest first)
+ */
+const ogc_err_rec * ogc_parse_ctx :: err_rec(size_t n) const
+{
+   size_t held = errs_held();
+
+   if ( n >= held )
+      return OGC_NULL;
+
+   return _errs + ((_num_errs - held + n) % OGC_CTX_ERRS_MAX);
+}
+
+/*------------------------------------------------------------------------
+ * internal keep a record of an error
+ * (the oldest record is overwritten if the ring is full)
+ */
+void ogc_parse_ctx :: keep_err(const ogc_error & e) const
+{
+   ogc_err_rec * r;
+
+   if ( !_keep_errs )
+      return;
+
+   r = _errs + (_num_errs++ % OGC_CTX_ERRS_MAX);
+
+   r->code     = e._err_code;
+   r->arg_type = e._arg_type;
+   r->iarg     = e._iarg;
+   r->darg     = e._darg;
+   r->pos      = _err_pos;
+   strcpy(r->kwd, e._kwd);
+
+   if ( e._arg_type == OGC_ERR_ARG_STR )
+      ogc_string::strncpy(r->sarg, e._err_msg, OGC_ERR_ARG_MAX);
+   else
+      r->sarg[0] = 0;
+}
+
+/*------------------------------------------------------------------------
+ * internal set the position given to the errors kept
+ */
+size_t ogc_parse_ctx :: set_err_pos(size_t pos) const
+{
+   size_t rc = _err_pos;
+   _err_pos = pos;
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * get the tokens for validating (allocated when first needed)
+ */
+ogc_token * ogc_parse_ctx :: token()
+{
+   if ( _token == OGC_NULL )
+   {
+      void * p = ogc_allocator::current()->alloc(sizeof(ogc_token));
+
+      if ( p != OGC_NULL )
+      {
+         _token = new (p) ogc_token(OGC_TOKEN_MODE_SPAN);
+         _token->set_ctx(this);
+      }
+   }
+
+   return _token;
+}
+
+/*------------------------------------------------------------------------
+ * get the scratch memory for validating (allocated when first needed)
+ */
+ogc_scratch * ogc_parse_ctx :: scratch()
+{
+   if ( _scratch == OGC_NULL )
+   {
+      _scratch = ogc_new<ogc_scratch>();
+   }
+
+   return _scratch;
+}
+
+/*------------------------------------------------------------------------
+ * get the error object to use for a parse
+ *
+ * If the context has no routine and isn't quiet or keeping errors, or
+ * the caller's error object is already set up for this context, it is
+ * just used (as it is if it has its own routine, unless errors are
+ * kept).  Otherwise, the local object is set up for the context (with
+ * the caller's routine, if it has one), and is used instead.
+ */
+ogc_error * ogc_parse_ctx :: begin_err(
+   const ogc_parse_ctx * ctx,
+   ogc_error *           err,
+   ogc_error *           local)
+{
+   if ( ctx == OGC_NULL ||
+        (ctx->_err_rtn == OGC_NULL && !ctx->_quiet && !ctx->_keep_errs) )
+      return err;
+
+   if ( err != OGC_NULL && err->_ctx == ctx )
+      return err;
+
+   if ( err != OGC_NULL && err->rtn() != OGC_NULL )
+   {
+      if ( !ctx->_keep_errs )
+         return err;
+      local->set_rtn(err->rtn(), err->data());
+   }
+   else
+   {
+      local->set_rtn(ctx->_err_rtn, ctx->_err_data);
+      local->_quiet = ctx->_quiet;
+   }
+
+   local->_ctx = ctx;
+   return local;
+}
+
+/*------------------------------------------------------------------------
+ * copy the error (if any) back to the caller's error object
+ */
+void ogc_parse_ctx :: end_err(
+   ogc_error *           err,
+   const ogc_error *     used)
+{
+   if ( err != OGC_NULL && used != err )
+      err->copy(*used);
+}
+
+} /* namespace OGC */
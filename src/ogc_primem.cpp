@@ -72,14 +72,18 @@ ogc_primem * ogc_primem :: create(
     */
    if ( !bad )
    {
-      p = new (std::nothrow) ogc_primem();
+      ogc_str_pool strs;
+
+      strs.need_name(name);
+      p = new (strs.size(), std::nothrow) ogc_primem();
       if ( p == OGC_NULL )
       {
          ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
          return p;
       }
 
-      ogc_string::unescape_str(p->_name, name, OGC_NAME_MAX);
+      strs.begin(p);
+      p->_name = strs.add_name(name);
       p->_obj_type  = OGC_OBJ_TYPE_PRIMEM;
       p->_visible   = true;
       p->_longitude = longitude;
@@ -102,10 +106,7 @@ ogc_primem :: ~ogc_primem()
 ogc_primem * ogc_primem :: destroy(
    ogc_primem * obj)
 {
-   if ( obj != OGC_NULL )
-   {
-      delete obj;
-   }
+   ogc_object::destroy(obj);
    return OGC_NULL;
 }
 
@@ -121,10 +122,8 @@ ogc_primem * ogc_primem :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  same;
    int  end;
-   int  num;
 
    ogc_primem *  obj     = OGC_NULL;
    ogc_angunit * angunit = OGC_NULL;
@@ -148,35 +147,24 @@ ogc_primem * ogc_primem :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_PRIMEM )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 2 tokens: PRIMEM[ "name", longitude ...
@@ -187,7 +175,7 @@ ogc_primem * ogc_primem :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 2 && get_strict_parsing() )
+   if ( same > 2 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -199,8 +187,8 @@ ogc_primem * ogc_primem :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name      = arr[start++].str;
-   longitude = ogc_string::atod( arr[start++].str );
+   name      = t->str(start++);
+   longitude = t->num(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -208,73 +196,72 @@ ogc_primem * ogc_primem :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_angunit::is_kwd(arr[i].str) )
-      {
-         if ( angunit != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            angunit = ogc_angunit::from_tokens(t, i, &next, err);
-            if ( angunit == OGC_NULL )
-               bad = true;
-         }
-         continue;
-      }
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
 
-      if ( ogc_id::is_kwd(arr[i].str) )
+      switch (arr[i].type)
       {
-         id = ogc_id::from_tokens(t, i, &next, err);
-         if ( id == OGC_NULL )
-         {
-            bad = true;
-         }
-         else
-         {
-            if ( ids == OGC_NULL )
+         case OGC_OBJ_TYPE_ANGUNIT:
+         case OGC_OBJ_TYPE_UNIT:
+            if ( angunit != OGC_NULL )
             {
-               ids = ogc_vector::create(1, 1);
-               if ( ids == OGC_NULL )
-               {
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-                  delete id;
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
+               bad = true;
+            }
+            else
+            {
+               angunit = ogc_angunit::from_tokens(t, i, &next, err);
+               if ( angunit == OGC_NULL )
                   bad = true;
-               }
             }
+            break;
 
-            if ( ids != OGC_NULL )
+         case OGC_OBJ_TYPE_ID:
+            id = ogc_id::from_tokens(t, i, &next, err);
+            if ( id == OGC_NULL )
+            {
+               bad = true;
+            }
+            else
             {
-               void * p = ids->find(
-                             id,
-                             false,
-                             ogc_utils::compare_id);
-               if ( p != OGC_NULL )
+               if ( ids == OGC_NULL )
                {
-                  ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
-                     obj_kwd(), id->name());
-                  delete id;
-                  bad = true;
+                  ids = ogc_vector::create(1, 1);
+                  if ( ids == OGC_NULL )
+                  {
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     delete id;
+                     bad = true;
+                  }
                }
-               else
+
+               if ( ids != OGC_NULL )
                {
-                  if ( ids->add( id ) < 0 )
+                  void * p = ids->find(
+                                id,
+                                false,
+                                ogc_utils::compare_id);
+                  if ( p != OGC_NULL )
                   {
-                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_ID,
+                        obj_kwd(), id->name());
                      delete id;
                      bad = true;
                   }
+                  else
+                  {
+                     if ( ids->add( id ) < 0 )
+                     {
+                        ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                        delete id;
+                        bad = true;
+                     }
+                  }
                }
             }
-         }
-         continue;
-      }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -284,6 +271,8 @@ ogc_primem * ogc_primem :: from_tokens(
     */
    if ( !bad )
    {
+      angunit = ogc_share_obj(angunit);
+
       obj = create(name, longitude, angunit, ids, err);
    }
 
@@ -304,7 +293,7 @@ ogc_primem * ogc_primem :: from_wkt(
    ogc_error *  err)
 {
    ogc_primem * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -338,67 +327,58 @@ bool ogc_primem :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_UTF8_NAME buf_name;
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_angunit;
-   OGC_TBUF      buf_id;
-   OGC_NBUF      buf_longitude;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_primem :: to_wkt(
+   const ogc_primem * obj,
+   ogc_wkt_writer &   w,
+   int                options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_primem :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
    if ( (opts & OGC_WKT_OPT_TOP_ID_ONLY) != 0 )
       opts |= OGC_WKT_OPT_NO_IDS;
 
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    /* if old syntax, we want to output primem even if not visible */
    if ( !is_visible() && (options & OGC_WKT_OPT_OLD_SYNTAX) == 0 )
       return true;
 
-   ogc_string :: dtoa(_longitude, buf_longitude);
-
+   w.open(kwd, options);
+   w.put_str(_name);
+   w.put_num(_longitude);
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) == 0 )
-      rc &= ogc_angunit :: to_wkt(_angunit, buf_angunit, opts, OGC_TBUF_MAX);
-   else
-      *buf_angunit = 0;
-
-   ogc_string::escape_str(buf_name, _name, OGC_UTF8_NAME_MAX);
-   sprintf(buf_hdr, "%s%s\"%s\",%s",
-      kwd, opn, buf_name, buf_longitude);
-
-   OGC_CPY_TO_BUF( buf_hdr     );
-   OGC_ADD_TO_BUF( buf_angunit );
+      rc &= ogc_angunit :: to_wkt(_angunit, w, opts);
 
    if ( _ids != OGC_NULL && (options & OGC_WKT_OPT_NO_IDS) == 0 )
    {
       for (int i = 0; i < id_count(); i++)
       {
-         rc &= ogc_id :: to_wkt(id(i), buf_id, opts, OGC_TBUF_MAX);
-         OGC_ADD_TO_BUF( buf_id );
+         rc &= ogc_id :: to_wkt(id(i), w, opts);
          if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
             break;
       }
    }
 
-   OGC_CPY_TO_BUF( cls );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.close(options);
 
    return rc;
 }
@@ -415,7 +395,7 @@ ogc_primem * ogc_primem :: clone(const ogc_primem * obj)
 
 ogc_primem * ogc_primem :: clone() const
 {
-   ogc_angunit * angunit = ogc_angunit :: clone( _angunit );
+   ogc_angunit * angunit = ogc_share_clone( _angunit );
    ogc_vector *  ids     = ogc_vector  :: clone( _ids     );
 
    ogc_primem * p = create(_name,
@@ -521,10 +501,8 @@ ogc_primem * ogc_primem :: from_tokens_geogcs(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  same;
    int  end;
-   int  num;
 
    ogc_primem *  obj     = OGC_NULL;
    ogc_angunit * angunit = OGC_NULL;
@@ -548,35 +526,24 @@ ogc_primem * ogc_primem :: from_tokens_geogcs(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !ogc_string::is_equal(kwd, obj_kwd()) )
+   if ( arr[start].type != OGC_OBJ_TYPE_PRIMEM )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 2 tokens: PRIMEM[ "name", longitude ...
@@ -587,7 +554,7 @@ ogc_primem * ogc_primem :: from_tokens_geogcs(
       return OGC_NULL;
    }
 
-   if ( same > 2 && get_strict_parsing() )
+   if ( same > 2 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -599,8 +566,8 @@ ogc_primem * ogc_primem :: from_tokens_geogcs(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   name      = arr[start++].str;
-   longitude = ogc_string::atod( arr[start++].str );
+   name      = t->str(start++);
+   longitude = t->num(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -608,42 +575,42 @@ ogc_primem * ogc_primem :: from_tokens_geogcs(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_string::is_equal(arr[i].str, ogc_id::obj_kwd()) )
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
+
+      switch (arr[i].type)
       {
-         if ( ids == OGC_NULL )
-         {
-            ids = ogc_vector::create(1,1);
+         case OGC_OBJ_TYPE_ID:
             if ( ids == OGC_NULL )
             {
-               ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
-               bad = true;
+               ids = ogc_vector::create(1,1);
+               if ( ids == OGC_NULL )
+               {
+                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                  bad = true;
+               }
             }
-         }
 
-         if ( ids != OGC_NULL )
-         {
-            id = ogc_id::from_tokens(t, i, &next, err);
-            if ( id == OGC_NULL )
-            {
-               bad = true;
-            }
-            else
+            if ( ids != OGC_NULL )
             {
-               if ( ids->add( id ) < 0 )
+               id = ogc_id::from_tokens(t, i, &next, err);
+               if ( id == OGC_NULL )
                {
-                  delete id;
-                  ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
                   bad = true;
                }
+               else
+               {
+                  if ( ids->add( id ) < 0 )
+                  {
+                     delete id;
+                     ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd());
+                     bad = true;
+                  }
+               }
             }
-         }
-         continue;
-      }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -665,6 +632,8 @@ ogc_primem * ogc_primem :: from_tokens_geogcs(
     */
    if ( !bad )
    {
+      angunit = ogc_share_obj(angunit);
+
       obj = create(name, longitude, angunit, ids, err);
    }
 
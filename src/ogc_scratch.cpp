@@ -0,0 +1,228 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* object memory: scratch memory and arenas                                  */
+/*                                                                           */
+/* All objects and vectors get their memory here.  Normally it comes from    */
+/* the allocator in use (see ogc_alloc.cpp), but while scratch memory is     */
+/* being taken from, it comes from a chain of blocks (which come from the    */
+/* allocator) just by bumping a pointer.  Freeing scratch memory does        */
+/* nothing, and all of it is discarded at once, by resetting the blocks      */
+/* (when validating) or by deleting them (when an arena is deleted).  The    */
+/* blocks are kept until then, so after the first few strings, nothing is    */
+/* ever allocated while validating.                                          */
+/*                                                                           */
+/* The scratch memory being taken from is kept per thread, so each thread    */
+/* may validate (or parse into an arena) at once.                            */
+/*                                                                           */
+/* Each piece of memory starts with the same header as memory from an       */
+/* allocator, but with a null allocator, so it can be freed (or not) by      */
+/* ogc_allocator::free() at any time, and not just while its scratch memory  */
+/* is being taken from.                                                      */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+#define OGC_SCRATCH_SIZE   (64 * 1024)  /* size of each block            */
+#define OGC_SCRATCH_ALIGN  16           /* alignment of all memory taken */
+
+struct ogc_scratch_block
+{
+   ogc_scratch_block * next;
+   char *              beg;
+   char *              end;
+};
+
+/* scratch memory being taken from in this thread */
+static OGC_THREAD_LOCAL ogc_scratch * ogc_scratch_current = OGC_NULL;
+
+/*------------------------------------------------------------------------
+ * SCRATCH constructor
+ */
+ogc_scratch :: ogc_scratch()
+{
+   _head = OGC_NULL;
+   _cur  = OGC_NULL;
+   _pos  = OGC_NULL;
+   _size = 0;
+   _prev = OGC_NULL;
+}
+
+/*------------------------------------------------------------------------
+ * SCRATCH destructor
+ */
+ogc_scratch :: ~ogc_scratch()
+{
+   if ( ogc_scratch_current == this )
+      ogc_scratch_current = _prev;
+
+   while ( _head != OGC_NULL )
+   {
+      ogc_scratch_block * b = _head;
+
+      _head = b->next;
+      ogc_free(b);
+   }
+}
+
+/*------------------------------------------------------------------------
+ * start taking memory
+ */
+void ogc_scratch :: begin()
+{
+   _prev = ogc_scratch_current;
+   ogc_scratch_current = this;
+}
+
+/*------------------------------------------------------------------------
+ * stop taking memory
+ */
+void ogc_scratch :: end()
+{
+   if ( ogc_scratch_current == this )
+      ogc_scratch_current = _prev;
+   _prev = OGC_NULL;
+}
+
+/*------------------------------------------------------------------------
+ * discard everything taken
+ */
+void ogc_scratch :: reset()
+{
+   _cur = _head;
+   _pos = (_head == OGC_NULL) ? OGC_NULL : _head->beg;
+}
+
+/*------------------------------------------------------------------------
+ * internal take memory from the blocks
+ *
+ * If the current block is full, we move on to the next block, adding
+ * one if there isn't one.
+ */
+void * ogc_scratch :: take(size_t size)
+{
+   char * p;
+
+   size = (size + (OGC_SCRATCH_ALIGN-1)) & ~(size_t)(OGC_SCRATCH_ALIGN-1);
+
+   while ( _cur == OGC_NULL ||
+           size > static_cast<size_t>(_cur->end - _pos) )
+   {
+      ogc_scratch_block * b = (_cur == OGC_NULL) ? _head : _cur->next;
+
+      if ( b == OGC_NULL )
+      {
+         size_t len = sizeof(*b) + OGC_SCRATCH_ALIGN +
+                      ((size > OGC_SCRATCH_SIZE) ? size : OGC_SCRATCH_SIZE);
+         char * m = ogc_alloc<char>(len);
+         if ( m == OGC_NULL )
+            return OGC_NULL;
+
+         b = reinterpret_cast<ogc_scratch_block *>(m);
+         b->next = OGC_NULL;
+         b->beg  = m + sizeof(*b);
+         b->beg += (OGC_SCRATCH_ALIGN -
+                    (reinterpret_cast<size_t>(b->beg) % OGC_SCRATCH_ALIGN)) %
+                   OGC_SCRATCH_ALIGN;
+         b->end  = m + len;
+
+         if ( _cur == OGC_NULL )
+            _head = b;
+         else
+            _cur->next = b;
+         _size += len;
+      }
+
+      _cur = b;
+      _pos = b->beg;
+   }
+
+   p = _pos;
+   _pos += size;
+
+   return p;
+}
+
+/*------------------------------------------------------------------------
+ * get memory for an object or a vector
+ */
+void * ogc_scratch :: alloc(size_t size)
+{
+   ogc_scratch *   s = ogc_scratch_current;
+   ogc_alloc_hdr * h;
+
+   if ( s == OGC_NULL )
+      return ogc_allocator::current()->alloc(size);
+
+   h = static_cast<ogc_alloc_hdr *>( s->take(OGC_ALLOC_HDR + size) );
+   if ( h == OGC_NULL )
+      return OGC_NULL;
+
+   h->alloc   = OGC_NULL;
+   h->size    = size;
+   h->counted = 0;
+   return reinterpret_cast<char *>(h) + OGC_ALLOC_HDR;
+}
+
+/*------------------------------------------------------------------------
+ * check if object memory is being taken from scratch memory
+ */
+bool ogc_scratch :: in_use()
+{
+   return (ogc_scratch_current != OGC_NULL);
+}
+
+/* ------------------------------------------------------------------------- */
+/* arenas                                                                    */
+/* ------------------------------------------------------------------------- */
+
+/*------------------------------------------------------------------------
+ * ARENA constructor
+ */
+ogc_arena :: ogc_arena()
+{
+   _mem = ogc_new<ogc_scratch>();
+}
+
+/*------------------------------------------------------------------------
+ * ARENA destructor
+ */
+ogc_arena :: ~ogc_arena()
+{
+   ogc_delete(_mem);
+}
+
+/*------------------------------------------------------------------------
+ * discard all objects in the arena (but keep its memory)
+ */
+void ogc_arena :: reset()
+{
+   if ( _mem != OGC_NULL )
+      _mem->reset();
+}
+
+/*------------------------------------------------------------------------
+ * get the total size of the memory held
+ */
+size_t ogc_arena :: size() const
+{
+   return (_mem == OGC_NULL) ? 0 : _mem->size();
+}
+
+} /* namespace OGC */
@@ -0,0 +1,333 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* sharing of sub-objects                                                    */
+/*                                                                           */
+/* Only sub-objects that we build ourselves are shared: when parsing, each   */
+/* object shares the ellipsoid, prime meridian, unit, coordinate system or   */
+/* method it is built with, through ogc_share_obj(), just before it is       */
+/* created, and when cloning, it takes another owner of each such sub-object */
+/* that is shared, through ogc_share_clone(), in place of a copy.  A         */
+/* sub-object passed to a create() method by a caller is never shared.       */
+/*                                                                           */
+/* The sub-object's key is its WKT (written as if it were visible, after a   */
+/* char giving whether it is), so two sub-objects with the same key are the  */
+/* same in every way, as numbers are written exactly.  As any hidden         */
+/* sub-objects of it aren't written, ogc_object::is_identical() is also      */
+/* checked.                                                                  */
+/*                                                                           */
+/* The table holds the shared objects in use, each in a chain by its key (to */
+/* find it when sharing) and in a chain by its address (to remove it when    */
+/* its last owner is destroyed).  The count of owners is kept in the object  */
+/* (in what would be padding), and all changes to it and to the table are    */
+/* made under one lock.  An object is marked as shared before any other      */
+/* thread can see it, so checking that needs no lock.                        */
+/*                                                                           */
+/* Objects from different allocators are never shared with each other:       */
+/* an object only matches one in the table from the same allocator, and a    */
+/* clone only takes another owner of a shared object if it is from the       */
+/* allocator in use (else it copies it).  So no object ever has memory       */
+/* from an allocator that it (or its parse) didn't use, and an allocator     */
+/* can be deleted once all objects made with it are.                         */
+/*                                                                           */
+/* If the count of an object is full, a new shared object takes its place in */
+/* the table, and it is deleted (when its owners are) without being in the   */
+/* table.                                                                    */
+/*                                                                           */
+/* Each entry comes from the allocator in use, as the object it is for does, */
+/* and is freed along with that object.                                      */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+namespace OGC {
+
+#define OGC_SHARE_BUCKETS   (4 * 1024)  /* number of chains (power of 2)  */
+#define OGC_SHARE_REFS_MAX  0xffff      /* max owners of a shared object */
+
+struct ogc_share_entry
+{
+   ogc_share_entry * next;       /* next in its chain by key        */
+   ogc_share_entry * next_obj;   /* next in its chain by address    */
+   ogc_object *      obj;
+   size_t            hash;
+   size_t            len;
+   char              key[1];
+};
+
+static ogc_share_entry * ogc_share_keys[OGC_SHARE_BUCKETS];
+static ogc_share_entry * ogc_share_objs[OGC_SHARE_BUCKETS];
+
+static volatile bool     ogc_share_on    = false;
+static size_t            ogc_share_count = 0;
+static size_t            ogc_share_refs  = 0;
+static size_t            ogc_share_size  = 0;
+
+#ifdef _WIN32
+static SRWLOCK           ogc_share_mutex = SRWLOCK_INIT;
+#else
+static pthread_mutex_t   ogc_share_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/*------------------------------------------------------------------------
+ * internal lock or unlock the table
+ */
+static void ogc_share_lock()
+{
+#ifdef _WIN32
+   AcquireSRWLockExclusive(&ogc_share_mutex);
+#else
+   pthread_mutex_lock(&ogc_share_mutex);
+#endif
+}
+
+static void ogc_share_unlock()
+{
+#ifdef _WIN32
+   ReleaseSRWLockExclusive(&ogc_share_mutex);
+#else
+   pthread_mutex_unlock(&ogc_share_mutex);
+#endif
+}
+
+/*------------------------------------------------------------------------
+ * internal get the chain of an object by its address
+ */
+static ogc_share_entry ** ogc_share_obj_chain(const ogc_object * obj)
+{
+   size_t n = reinterpret_cast<size_t>(obj) / sizeof(void *);
+   return ogc_share_objs + (n & (OGC_SHARE_BUCKETS - 1));
+}
+
+/*------------------------------------------------------------------------
+ * internal remove an object from the table (if it is there)
+ * (the table is locked)
+ */
+static void ogc_share_remove(const ogc_object * obj)
+{
+   ogc_share_entry ** pp;
+   ogc_share_entry *  e;
+
+   for (pp = ogc_share_obj_chain(obj); *pp != OGC_NULL; pp = &e->next_obj)
+   {
+      e = *pp;
+      if ( e->obj == obj )
+         break;
+   }
+   if ( *pp == OGC_NULL )
+      return;
+
+   *pp = e->next_obj;
+
+   pp = ogc_share_keys + (e->hash & (OGC_SHARE_BUCKETS - 1));
+   while ( *pp != e )
+      pp = &(*pp)->next;
+   *pp = e->next;
+
+   ogc_share_count--;
+   ogc_share_size -= sizeof(*e) + e->len;
+   ogc_free(e);
+}
+
+/*------------------------------------------------------------------------
+ * turn sharing on or off
+ */
+bool ogc_share :: set_enabled(bool on_off)
+{
+   bool rc = ogc_share_on;
+   ogc_share_on = on_off;
+   return rc;
+}
+
+bool ogc_share :: enabled()
+{
+   return ogc_share_on;
+}
+
+/*------------------------------------------------------------------------
+ * get statistics
+ */
+size_t ogc_share :: count()
+{
+   return ogc_share_count;
+}
+
+size_t ogc_share :: refs()
+{
+   return ogc_share_refs;
+}
+
+size_t ogc_share :: bytes()
+{
+   return ogc_share_size;
+}
+
+/*------------------------------------------------------------------------
+ * get the object to use for a sub-object an object is being created with
+ */
+ogc_object * ogc_share_table :: share(ogc_object * obj)
+{
+   char              buf[OGC_BUFF_MAX];
+   ogc_wkt_writer    w(buf, sizeof(buf));
+   ogc_share_entry ** pp;
+   ogc_share_entry *  e;
+   ogc_object *       p = OGC_NULL;
+   size_t             hash;
+   size_t             len;
+   bool               vis;
+
+   if ( !ogc_share_on || obj == OGC_NULL || obj->_shared ||
+        ogc_scratch::is_scratch(obj) )
+   {
+      return obj;
+   }
+
+   /*---------------------------------------------------------
+    * get its key (it isn't shared yet, so it is ours to change)
+    */
+   vis = obj->_visible;
+   w.write(vis ? "+" : "-", 1);
+   obj->_visible = true;
+   ogc_object::to_wkt(obj, w, OGC_WKT_OPT_NONE);
+   obj->_visible = vis;
+
+   if ( !w.ok() )
+      return obj;
+
+   len  = w.len();
+   hash = ogc_hash(buf, len);
+   pp   = ogc_share_keys + (hash & (OGC_SHARE_BUCKETS - 1));
+
+   /*---------------------------------------------------------
+    * use the one already shared, or else share this one
+    */
+   ogc_share_lock();
+
+   for (e = *pp; e != OGC_NULL; e = e->next)
+   {
+      if ( e->hash == hash && e->len == len &&
+           ogc_alloc_of(e->obj) == ogc_alloc_of(obj) &&
+           memcmp(e->key, buf, len) == 0 &&
+           ogc_object::is_identical(e->obj, obj) )
+      {
+         break;
+      }
+   }
+
+   if ( e != OGC_NULL && e->obj->_refs < OGC_SHARE_REFS_MAX )
+   {
+      p = e->obj;
+      p->_refs++;
+      ogc_share_refs++;
+   }
+   else
+   {
+      if ( e != OGC_NULL )
+         ogc_share_remove(e->obj);
+
+      e = reinterpret_cast<ogc_share_entry *>(
+             ogc_alloc<char>(sizeof(*e) + len) );
+      if ( e != OGC_NULL )
+      {
+         e->obj  = obj;
+         e->hash = hash;
+         e->len  = len;
+         memcpy(e->key, buf, len);
+         e->key[len] = 0;
+
+         e->next     = *pp;
+         *pp         = e;
+         pp          = ogc_share_obj_chain(obj);
+         e->next_obj = *pp;
+         *pp         = e;
+
+         obj->_shared = true;
+         obj->_refs   = 1;
+         ogc_share_count++;
+         ogc_share_refs++;
+         ogc_share_size += sizeof(*e) + len;
+      }
+   }
+
+   ogc_share_unlock();
+
+   /* this one isn't needed (this is done unlocked, as any shared objects
+      it has are released) */
+   if ( p != OGC_NULL )
+   {
+      ogc_object::destroy(obj);
+      return p;
+   }
+
+   return obj;
+}
+
+/*------------------------------------------------------------------------
+ * add an owner to a shared object
+ */
+bool ogc_share_table :: add_ref(const ogc_object * obj)
+{
+   ogc_object * p = const_cast<ogc_object *>(obj);
+   bool         ok;
+
+   if ( !ogc_share_on || ogc_scratch::in_use() ||
+        ogc_alloc_of(obj) != ogc_allocator::current() )
+   {
+      return false;
+   }
+
+   ogc_share_lock();
+
+   ok = (p->_refs < OGC_SHARE_REFS_MAX);
+   if ( ok )
+   {
+      p->_refs++;
+      ogc_share_refs++;
+   }
+
+   ogc_share_unlock();
+
+   return ok;
+}
+
+/*------------------------------------------------------------------------
+ * drop one owner of a shared object
+ */
+bool ogc_share_table :: release(ogc_object * obj)
+{
+   bool last;
+
+   ogc_share_lock();
+
+   obj->_refs--;
+   ogc_share_refs--;
+   last = (obj->_refs == 0);
+   if ( last )
+      ogc_share_remove(obj);
+
+   ogc_share_unlock();
+
+   return last;
+}
+
+} /* namespace OGC */
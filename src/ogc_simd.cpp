@@ -0,0 +1,547 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* structural-char scanning                                                  */
+/*                                                                           */
+/* The string is processed in 64-byte blocks.  For each block, we build a    */
+/* 64-bit mask of the quote chars and a mask of the "[](),"  chars, using    */
+/* the widest vector instructions available.  A prefix-XOR of the quote      */
+/* mask gives the in-quote regions (a "" pair inside quotes just toggles     */
+/* twice), and the positions of the quote chars and of all "[](),"  chars    */
+/* outside of quotes are then added to the index.                            */
+/*                                                                           */
+/* Define OGC_NO_SIMD to use only the portable code.                         */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+#if !defined(OGC_NO_SIMD)
+
+#  if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define OGC_SIMD_SSE2  1
+#    include <emmintrin.h>
+#  endif
+
+#  if defined(OGC_SIMD_SSE2) && \
+      ( (defined(__GNUC__) && \
+           (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || \
+        (defined(_MSC_VER) && _MSC_VER >= 1800) )
+#    define OGC_SIMD_AVX2  1
+#    include <immintrin.h>
+#    if defined(_MSC_VER)
+#      include <intrin.h>
+#    endif
+#  endif
+
+#  if defined(__aarch64__) && defined(__ARM_NEON)
+#    define OGC_SIMD_NEON  1
+#    include <arm_neon.h>
+#  endif
+
+#endif /* OGC_NO_SIMD */
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace OGC {
+
+/*------------------------------------------------------------------------
+ * instruction sets
+ */
+enum ogc_simd_impl
+{
+   OGC_SIMD_IMPL_PORTABLE = 0,
+   OGC_SIMD_IMPL_SSE2,
+   OGC_SIMD_IMPL_AVX2,
+   OGC_SIMD_IMPL_NEON
+};
+
+/*------------------------------------------------------------------------
+ * count trailing zero bits (x is non-zero)
+ */
+static inline int ogc_ctz(ogc_uint64 x)
+{
+#if defined(__GNUC__)
+   return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+   unsigned long n;
+   _BitScanForward64(&n, x);
+   return static_cast<int>(n);
+#elif defined(_MSC_VER)
+   unsigned long n;
+   if ( _BitScanForward(&n, static_cast<unsigned long>(x)) )
+      return static_cast<int>(n);
+   _BitScanForward(&n, static_cast<unsigned long>(x >> 32));
+   return static_cast<int>(n) + 32;
+#else
+   int n = 0;
+   while ( (x & 1) == 0 )
+   {
+      x >>= 1;
+      n++;
+   }
+   return n;
+#endif
+}
+
+/*------------------------------------------------------------------------
+ * prefix-XOR: bit i of the result is the XOR of bits 0 - i of x
+ */
+static inline ogc_uint64 ogc_prefix_xor(ogc_uint64 x)
+{
+   x ^= x << 1;
+   x ^= x << 2;
+   x ^= x << 4;
+   x ^= x << 8;
+   x ^= x << 16;
+   x ^= x << 32;
+   return x;
+}
+
+/*------------------------------------------------------------------------
+ * add the structural positions for a block
+ *
+ *    quote    mask of quote chars
+ *    delim    mask of "[]()," chars
+ *    carry    all ones if the block starts within quotes
+ */
+static inline int ogc_add_block(
+   ogc_uint64   quote,
+   ogc_uint64   delim,
+   ogc_uint64 & carry,
+   int          base,
+   int *        idx,
+   int          n)
+{
+   ogc_uint64 in_quotes = ogc_prefix_xor(quote) ^ carry;
+   ogc_uint64 bits      = quote | (delim & ~in_quotes);
+
+   carry = ((in_quotes >> 63) != 0) ? ~static_cast<ogc_uint64>(0) : 0;
+
+   for (; bits != 0; bits &= (bits - 1))
+      idx[n++] = base + ogc_ctz(bits);
+
+   return n;
+}
+
+/*------------------------------------------------------------------------
+ * portable block masks
+ */
+static void ogc_masks_portable(
+   const unsigned char * p,
+   ogc_uint64 &          quote,
+   ogc_uint64 &          delim)
+{
+   ogc_uint64 q = 0;
+   ogc_uint64 d = 0;
+
+   for (int i = 63; i >= 0; i--)
+   {
+      unsigned char c = p[i];
+
+      q <<= 1;
+      d <<= 1;
+      switch (c)
+      {
+         case '"':
+            q |= 1;
+            break;
+
+         case '[':
+         case ']':
+         case '(':
+         case ')':
+         case ',':
+            d |= 1;
+            break;
+      }
+   }
+
+   quote = q;
+   delim = d;
+}
+
+static int ogc_scan_portable(
+   const unsigned char * s,
+   int                   len,
+   int *                 idx)
+{
+   ogc_uint64 carry = 0;
+   ogc_uint64 quote;
+   ogc_uint64 delim;
+   int        n = 0;
+   int        i;
+
+   for (i = 0; i + 64 <= len; i += 64)
+   {
+      ogc_masks_portable(s + i, quote, delim);
+      n = ogc_add_block(quote, delim, carry, i, idx, n);
+   }
+
+   if ( i < len )
+   {
+      unsigned char buf[64];
+
+      memset(buf, 0, sizeof(buf));
+      memcpy(buf, s + i, len - i);
+      ogc_masks_portable(buf, quote, delim);
+      n = ogc_add_block(quote, delim, carry, i, idx, n);
+   }
+
+   return n;
+}
+
+#if defined(OGC_SIMD_SSE2)
+/*------------------------------------------------------------------------
+ * SSE2 block masks
+ */
+static inline unsigned int ogc_sse2_delims(__m128i v)
+{
+   __m128i m =             _mm_cmpeq_epi8(v, _mm_set1_epi8('['));
+   m = _mm_or_si128(m,     _mm_cmpeq_epi8(v, _mm_set1_epi8(']')));
+   m = _mm_or_si128(m,     _mm_cmpeq_epi8(v, _mm_set1_epi8('(')));
+   m = _mm_or_si128(m,     _mm_cmpeq_epi8(v, _mm_set1_epi8(')')));
+   m = _mm_or_si128(m,     _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+
+   return static_cast<unsigned int>(_mm_movemask_epi8(m));
+}
+
+static inline unsigned int ogc_sse2_quotes(__m128i v)
+{
+   return static_cast<unsigned int>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))));
+}
+
+static inline void ogc_masks_sse2(
+   const unsigned char * p,
+   ogc_uint64 &          quote,
+   ogc_uint64 &          delim)
+{
+   const __m128i * vp = reinterpret_cast<const __m128i *>(p);
+   __m128i v0 = _mm_loadu_si128(vp + 0);
+   __m128i v1 = _mm_loadu_si128(vp + 1);
+   __m128i v2 = _mm_loadu_si128(vp + 2);
+   __m128i v3 = _mm_loadu_si128(vp + 3);
+
+   quote = (static_cast<ogc_uint64>(ogc_sse2_quotes(v0))      ) |
+           (static_cast<ogc_uint64>(ogc_sse2_quotes(v1)) << 16) |
+           (static_cast<ogc_uint64>(ogc_sse2_quotes(v2)) << 32) |
+           (static_cast<ogc_uint64>(ogc_sse2_quotes(v3)) << 48);
+
+   delim = (static_cast<ogc_uint64>(ogc_sse2_delims(v0))      ) |
+           (static_cast<ogc_uint64>(ogc_sse2_delims(v1)) << 16) |
+           (static_cast<ogc_uint64>(ogc_sse2_delims(v2)) << 32) |
+           (static_cast<ogc_uint64>(ogc_sse2_delims(v3)) << 48);
+}
+
+static int ogc_scan_sse2(
+   const unsigned char * s,
+   int                   len,
+   int *                 idx)
+{
+   ogc_uint64 carry = 0;
+   ogc_uint64 quote;
+   ogc_uint64 delim;
+   int        n = 0;
+   int        i;
+
+   for (i = 0; i + 64 <= len; i += 64)
+   {
+      ogc_masks_sse2(s + i, quote, delim);
+      n = ogc_add_block(quote, delim, carry, i, idx, n);
+   }
+
+   if ( i < len )
+   {
+      unsigned char buf[64];
+
+      memset(buf, 0, sizeof(buf));
+      memcpy(buf, s + i, len - i);
+      ogc_masks_sse2(buf, quote, delim);
+      n = ogc_add_block(quote, delim, carry, i, idx, n);
+   }
+
+   return n;
+}
+#endif /* OGC_SIMD_SSE2 */
+
+#if defined(OGC_SIMD_AVX2)
+/*------------------------------------------------------------------------
+ * AVX2 block masks
+ *
+ * These functions are compiled for AVX2 only, and are only called if
+ * the CPU supports it.
+ */
+#if defined(__GNUC__)
+#  define OGC_AVX2_FUNC  __attribute__((target("avx2")))
+#else
+#  define OGC_AVX2_FUNC
+#endif
+
+OGC_AVX2_FUNC
+static inline unsigned int ogc_avx2_delims(__m256i v)
+{
+   __m256i m =                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('['));
+   m = _mm256_or_si256(m,     _mm256_cmpeq_epi8(v, _mm256_set1_epi8(']')));
+   m = _mm256_or_si256(m,     _mm256_cmpeq_epi8(v, _mm256_set1_epi8('(')));
+   m = _mm256_or_si256(m,     _mm256_cmpeq_epi8(v, _mm256_set1_epi8(')')));
+   m = _mm256_or_si256(m,     _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')));
+
+   return static_cast<unsigned int>(_mm256_movemask_epi8(m));
+}
+
+OGC_AVX2_FUNC
+static inline unsigned int ogc_avx2_quotes(__m256i v)
+{
+   return static_cast<unsigned int>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))));
+}
+
+OGC_AVX2_FUNC
+static inline void ogc_masks_avx2(
+   const unsigned char * p,
+   ogc_uint64 &          quote,
+   ogc_uint64 &          delim)
+{
+   const __m256i * vp = reinterpret_cast<const __m256i *>(p);
+   __m256i v0 = _mm256_loadu_si256(vp + 0);
+   __m256i v1 = _mm256_loadu_si256(vp + 1);
+
+   quote = (static_cast<ogc_uint64>(ogc_avx2_quotes(v0))      ) |
+           (static_cast<ogc_uint64>(ogc_avx2_quotes(v1)) << 32);
+
+   delim = (static_cast<ogc_uint64>(ogc_avx2_delims(v0))      ) |
+           (static_cast<ogc_uint64>(ogc_avx2_delims(v1)) << 32);
+}
+
+OGC_AVX2_FUNC
+static int ogc_scan_avx2(
+   const unsigned char * s,
+   int                   len,
+   int *                 idx)
+{
+   ogc_uint64 carry = 0;
+   ogc_uint64 quote;
+   ogc_uint64 delim;
+   int        n = 0;
+   int        i;
+
+   for (i = 0; i + 64 <= len; i += 64)
+   {
+      ogc_masks_avx2(s + i, quote, delim);
+      n = ogc_add_block(quote, delim, carry, i, idx, n);
+   }
+
+   if ( i < len )
+   {
+      unsigned char buf[64];
+
+      memset(buf, 0, sizeof(buf));
+      memcpy(buf, s + i, len - i);
+      ogc_masks_avx2(buf, quote, delim);
+      n = ogc_add_block(quote, delim, carry, i, idx, n);
+   }
+
+   return n;
+}
+
+/*------------------------------------------------------------------------
+ * check if the CPU (and OS) support AVX2
+ */
+static bool ogc_has_avx2()
+{
+#if defined(__GNUC__)
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2") != 0;
+#else
+   int info[4];
+
+   __cpuid(info, 0);
+   if ( info[0] < 7 )
+      return false;
+
+   /* OSXSAVE and AVX, and the OS saves the YMM registers */
+   __cpuid(info, 1);
+   if ( (info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 )
+      return false;
+   if ( (_xgetbv(0) & 0x6) != 0x6 )
+      return false;
+
+   __cpuidex(info, 7, 0);
+   return (info[1] & (1 << 5)) != 0;
+#endif
+}
+#endif /* OGC_SIMD_AVX2 */
+
+#if defined(OGC_SIMD_NEON)
+/*------------------------------------------------------------------------
+ * NEON block masks
+ */
+static inline ogc_uint64 ogc_neon_bits(
+   uint8x16_t m0,
+   uint8x16_t m1,
+   uint8x16_t m2,
+   uint8x16_t m3)
+{
+   static const unsigned char bits[16] =
+   {
+      0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+      0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+   };
+   const uint8x16_t b = vld1q_u8(bits);
+   uint8x16_t s0 = vpaddq_u8(vandq_u8(m0, b), vandq_u8(m1, b));
+   uint8x16_t s1 = vpaddq_u8(vandq_u8(m2, b), vandq_u8(m3, b));
+
+   s0 = vpaddq_u8(s0, s1);
+   s0 = vpaddq_u8(s0, s0);
+
+   return vgetq_lane_u64(vreinterpretq_u64_u8(s0), 0);
+}
+
+static inline uint8x16_t ogc_neon_delims(uint8x16_t v)
+{
+   uint8x16_t m =        vceqq_u8(v, vdupq_n_u8('['));
+   m = vorrq_u8(m,       vceqq_u8(v, vdupq_n_u8(']')));
+   m = vorrq_u8(m,       vceqq_u8(v, vdupq_n_u8('(')));
+   m = vorrq_u8(m,       vceqq_u8(v, vdupq_n_u8(')')));
+   m = vorrq_u8(m,       vceqq_u8(v, vdupq_n_u8(',')));
+
+   return m;
+}
+
+static inline void ogc_masks_neon(
+   const unsigned char * p,
+   ogc_uint64 &          quote,
+   ogc_uint64 &          delim)
+{
+   const uint8x16_t q  = vdupq_n_u8('"');
+   uint8x16_t       v0 = vld1q_u8(p +  0);
+   uint8x16_t       v1 = vld1q_u8(p + 16);
+   uint8x16_t       v2 = vld1q_u8(p + 32);
+   uint8x16_t       v3 = vld1q_u8(p + 48);
+
+   quote = ogc_neon_bits(vceqq_u8(v0, q), vceqq_u8(v1, q),
+                         vceqq_u8(v2, q), vceqq_u8(v3, q));
+
+   delim = ogc_neon_bits(ogc_neon_delims(v0), ogc_neon_delims(v1),
+                         ogc_neon_delims(v2), ogc_neon_delims(v3));
+}
+
+static int ogc_scan_neon(
+   const unsigned char * s,
+   int                   len,
+   int *                 idx)
+{
+   ogc_uint64 carry = 0;
+   ogc_uint64 quote;
+   ogc_uint64 delim;
+   int        n = 0;
+   int        i;
+
+   for (i = 0; i + 64 <= len; i += 64)
+   {
+      ogc_masks_neon(s + i, quote, delim);
+      n = ogc_add_block(quote, delim, carry, i, idx, n);
+   }
+
+   if ( i < len )
+   {
+      unsigned char buf[64];
+
+      memset(buf, 0, sizeof(buf));
+      memcpy(buf, s + i, len - i);
+      ogc_masks_neon(buf, quote, delim);
+      n = ogc_add_block(quote, delim, carry, i, idx, n);
+   }
+
+   return n;
+}
+#endif /* OGC_SIMD_NEON */
+
+/*------------------------------------------------------------------------
+ * choose the instruction set to use
+ */
+static ogc_simd_impl ogc_simd_select()
+{
+   ogc_simd_impl impl = OGC_SIMD_IMPL_PORTABLE;
+
+#if defined(OGC_SIMD_SSE2)
+   impl = OGC_SIMD_IMPL_SSE2;
+#endif
+#if defined(OGC_SIMD_AVX2)
+   if ( ogc_has_avx2() )
+      impl = OGC_SIMD_IMPL_AVX2;
+#endif
+#if defined(OGC_SIMD_NEON)
+   impl = OGC_SIMD_IMPL_NEON;
+#endif
+
+   return impl;
+}
+
+/* The instruction set is chosen once, as the library is loaded (before
+   any threads can use it), and is only read after that.  Anything
+   scanned by a static initializer that runs first gets the portable
+   code, as _impl is zero until then. */
+static ogc_simd_impl _impl = ogc_simd_select();
+
+/*------------------------------------------------------------------------
+ * find all structural chars
+ */
+int ogc_simd :: structurals(
+   const char * str,
+   int          len,
+   int *        idx)
+{
+   const unsigned char * s = reinterpret_cast<const unsigned char *>(str);
+
+   switch ( _impl )
+   {
+#if defined(OGC_SIMD_SSE2)
+      case OGC_SIMD_IMPL_SSE2:   return ogc_scan_sse2(s, len, idx);
+#endif
+#if defined(OGC_SIMD_AVX2)
+      case OGC_SIMD_IMPL_AVX2:   return ogc_scan_avx2(s, len, idx);
+#endif
+#if defined(OGC_SIMD_NEON)
+      case OGC_SIMD_IMPL_NEON:   return ogc_scan_neon(s, len, idx);
+#endif
+      default:                   break;
+   }
+
+   return ogc_scan_portable(s, len, idx);
+}
+
+/*------------------------------------------------------------------------
+ * get the name of the instruction set being used
+ */
+const char * ogc_simd :: name()
+{
+   switch ( _impl )
+   {
+      case OGC_SIMD_IMPL_SSE2:   return "sse2";
+      case OGC_SIMD_IMPL_AVX2:   return "avx2";
+      case OGC_SIMD_IMPL_NEON:   return "neon";
+      default:                   break;
+   }
+
+   return "portable";
+}
+
+} /* namespace OGC */
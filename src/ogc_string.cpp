@@ -88,36 +88,6 @@ int ogc_string :: atoi(const char * str)
    return num;
 }
 
-/*------------------------------------------------------------------------
- * convert a string to a double
- */
-double ogc_string :: atod(const char * str)
-{
-   double num = 0.0;
-
-   if ( str == OGC_NULL )
-      return 0.0;
-
-   for (; isspace(*str); str++) {}
-   if ( *str == 0 )
-      return 0.0;
-
-   if ( strlen(str) < OGC_NBUF_MAX )
-   {
-      char     dec = decimal_point_char();
-      OGC_NBUF buf;
-      char *   b;
-
-      strcpy(buf, str);
-      b = strchr(buf, '.');
-      if ( b != OGC_NULL )
-         *b = dec;
-      num = ::atof(buf);
-   }
-
-   return num;
-}
-
 /*------------------------------------------------------------------------
  * convert an integer to a string
  */
@@ -131,149 +101,6 @@ char * ogc_string :: itoa(int n, OGC_NBUF buf)
    return buf;
 }
 
-/*------------------------------------------------------------------------
- * convert a double to a string
- *
- * There is a lot of esoteric code here to "cleanup" the string.
- * For example, both:
- *
- *    0.09999999999999999
- *    0.10000000000000001
- *
- * will be displayed as:
- *
- *    0.1
- */
-char * ogc_string :: dtoa(double d, OGC_NBUF buf)
-{
-   char dec = decimal_point_char();
-   char tmp[64];
-   char *pc;
-   int  nsigdigits = 16;
-   int  i, is16, iexp, ilen, idec;
-
-   if ( buf == OGC_NULL )
-      return OGC_NULL;
-
-   if ( nsigdigits <= 0 )
-      nsigdigits = 1;
-   else if ( nsigdigits > 16 )
-      nsigdigits = 16;
-
-   is16 = (nsigdigits == 16) ? 1 : 0;
-   ilen = (nsigdigits + 8 - is16);
-   idec = (nsigdigits - is16);
-   sprintf(tmp, "%*.*e", ilen, idec, d);
-
-   pc = &tmp[ilen - 3];
-   while ( *pc != '+' && *pc != '-' )
-   {
-     pc--;
-   }
-   iexp = atoi(pc);
-
-   if ( is16 )
-   {
-      pc = pc - 4;
-
-      if ( iexp < 12 )
-      {
-         /* Check the last couple of sig digits */
-
-         if ( strncmp(pc, "00", 2) == 0 )
-         {
-            /* Truncate */
-            /* Drop the number of significant digits */
-            nsigdigits--;
-         }
-         else if ( strncmp(pc, "99", 2) == 0 )
-         {
-            /* Round up */
-            /* Drop the number of significant digits */
-            nsigdigits--;
-         }
-      }
-   }
-
-   if ( iexp < 0 )
-   {
-      idec = nsigdigits - 1 + (iexp * -1);
-      ilen = idec + 3;
-
-      if ( ilen > 63 )
-      {
-         idec = nsigdigits;
-         ilen = idec + 8;
-         sprintf(tmp, "%*.*g", ilen, idec, d);
-      }
-      else
-      {
-         sprintf(tmp, "%*.*f", ilen, idec, d);
-         for (i = (int)strlen(tmp) - 1; i >= 0; i--)
-         {
-            if ( tmp[i] != '0' )
-            {
-               break;
-            }
-            tmp[i] = 0;
-         }
-         if ( tmp[i] == dec )
-         {
-            tmp[i+1] = '0';
-            tmp[i+2] = 0;
-         }
-
-         if ( strlen(tmp) > 24 || iexp < -9 )
-         {
-            idec = nsigdigits;
-            ilen = idec + 8;
-            sprintf(tmp, "%*.*g", ilen, idec, d);
-         }
-      }
-      for (pc = tmp; isspace(*pc); pc++) ;
-      strcpy(buf, pc);
-   }
-   else
-   {
-      idec = nsigdigits - 1 - iexp;
-      if ( idec > -1 )
-      {
-         ilen = nsigdigits + 2;
-         sprintf(buf, "%*.*f", ilen, idec, d);
-
-         if ( strchr(buf, dec) == OGC_NULL )
-         {
-            char buf2[8];
-            sprintf(buf2, "%c0", dec);
-            strcat(buf, buf2);
-         }
-
-         for (i = (int)strlen(buf) - 1; i >= 0; i--)
-         {
-            if ( buf[i] != '0' )
-            {
-               break;
-            }
-            buf[i] = 0;
-         }
-         if ( buf[i] == dec )
-         {
-            buf[i+1] = '0';
-            buf[i+2] = 0;
-         }
-      }
-      else
-      {
-         idec = nsigdigits;
-         ilen = idec + 8;
-         sprintf(buf, "%*.*g", ilen, idec, d);
-      }
-   }
-
-   trim_buf(buf);
-   return buf;
-}
-
 /*------------------------------------------------------------------------
  * case insensitive version of strcmp()
  *
@@ -284,6 +111,10 @@ int ogc_string :: strcmp_i (const char *s1, const char *s2)
    const unsigned char * u1 = reinterpret_cast<const unsigned char *>(s1);
    const unsigned char * u2 = reinterpret_cast<const unsigned char *>(s2);
 
+   /* the same string (such as an interned name) */
+   if ( s1 == s2 )
+      return 0;
+
    if ( u1 == OGC_NULL ) u1 = reinterpret_cast<const unsigned char *>("");
    if ( u2 == OGC_NULL ) u2 = reinterpret_cast<const unsigned char *>("");
 
@@ -348,6 +179,9 @@ int ogc_string :: strncmp_ci  (const char *s1, const char *s2, size_t n)
    const unsigned char * u2  = reinterpret_cast<const unsigned char *>(s2);
    int                   num = static_cast<int>(n);
 
+   if ( s1 == s2 )
+      return 0;
+
    if ( u1 == OGC_NULL ) u1 = reinterpret_cast<const unsigned char *>("");
    if ( u2 == OGC_NULL ) u2 = reinterpret_cast<const unsigned char *>("");
 
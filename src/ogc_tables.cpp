@@ -256,6 +256,7 @@ const ogc_tables::error_tbl ogc_tables :: ogc_errors[] =
 
    { OGC_ERR_NONE,                          "no error"                 },
    { OGC_ERR_NO_MEMORY,                     "no memory"                },
+   { OGC_ERR_CANNOT_OPEN_FILE,              "cannot open file"         },
 
    /* WKT syntax errors */
 
@@ -0,0 +1,176 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* threads                                                                   */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
+namespace OGC {
+
+/*------------------------------------------------------------------------
+ * what a thread is to call
+ */
+struct ogc_thread_arg
+{
+   ogc_thread::OGC_THREAD_RTN * rtn;
+   void *                       data;
+   int                          n;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI ogc_thread_start(LPVOID p)
+#else
+static void * ogc_thread_start(void * p)
+#endif
+{
+   ogc_thread_arg * a = static_cast<ogc_thread_arg *>(p);
+
+   (a->rtn)(a->data, a->n);
+   return 0;
+}
+
+/*------------------------------------------------------------------------
+ * run a routine in count threads
+ */
+void ogc_thread :: run(
+   int              count,
+   OGC_THREAD_RTN * rtn,
+   void *           data)
+{
+   ogc_thread_arg args    [OGC_THREADS_MAX];
+   bool           started [OGC_THREADS_MAX];
+#ifdef _WIN32
+   HANDLE         threads [OGC_THREADS_MAX];
+#else
+   pthread_t      threads [OGC_THREADS_MAX];
+#endif
+   int            i;
+
+   if ( count > OGC_THREADS_MAX )
+      count = OGC_THREADS_MAX;
+
+   for (i = 1; i < count; i++)
+   {
+      args[i].rtn  = rtn;
+      args[i].data = data;
+      args[i].n    = i;
+
+#ifdef _WIN32
+      threads[i] = CreateThread(NULL, 0, ogc_thread_start, &args[i], 0,
+                                NULL);
+      started[i] = (threads[i] != NULL);
+#else
+      started[i] = (pthread_create(&threads[i], NULL, ogc_thread_start,
+                                   &args[i]) == 0);
+#endif
+   }
+
+   if ( count > 0 )
+      (rtn)(data, 0);
+
+   for (i = 1; i < count; i++)
+   {
+      if ( started[i] )
+      {
+#ifdef _WIN32
+         WaitForSingleObject(threads[i], INFINITE);
+         CloseHandle(threads[i]);
+#else
+         pthread_join(threads[i], NULL);
+#endif
+      }
+      else
+      {
+         (rtn)(data, i);
+      }
+   }
+}
+
+/*------------------------------------------------------------------------
+ * get the number of processors
+ */
+int ogc_thread :: cpu_count()
+{
+   int n;
+
+#ifdef _WIN32
+   SYSTEM_INFO si;
+
+   GetSystemInfo(&si);
+   n = static_cast<int>(si.dwNumberOfProcessors);
+#else
+   n = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+
+   return (n > 0) ? n : 1;
+}
+
+/*------------------------------------------------------------------------
+ * add to a value atomically
+ */
+size_t ogc_thread :: atomic_add(
+   volatile size_t * p,
+   size_t            n)
+{
+#if defined(_WIN64)
+   return static_cast<size_t>(InterlockedExchangeAdd64(
+      reinterpret_cast<volatile LONGLONG *>(p), static_cast<LONGLONG>(n)));
+#elif defined(_WIN32)
+   return static_cast<size_t>(InterlockedExchangeAdd(
+      reinterpret_cast<volatile LONG *>(p), static_cast<LONG>(n)));
+#else
+   return __sync_fetch_and_add(p, n);
+#endif
+}
+
+/*------------------------------------------------------------------------
+ * get a pointer set atomically (an acquire load)
+ */
+void * ogc_thread :: atomic_get(
+   void * volatile * p)
+{
+#if defined(_WIN32)
+   return *p;  /* volatile reads acquire */
+#else
+   return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/*------------------------------------------------------------------------
+ * set a pointer atomically if it is still the old value
+ */
+void * ogc_thread :: atomic_cas(
+   void * volatile * p,
+   void *            old,
+   void *            n)
+{
+#if defined(_WIN32)
+   return InterlockedCompareExchangePointer(p, n, old);
+#else
+   return __sync_val_compare_and_swap(p, old, n);
+#endif
+}
+
+} /* namespace OGC */
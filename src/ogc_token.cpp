@@ -22,13 +22,253 @@
 
 namespace OGC {
 
+/*------------------------------------------------------------------------
+ * set an error at a position in the string
+ * (which is also where the context keeps it, if it keeps errors)
+ */
+static void ogc_token_err(
+   const ogc_parse_ctx * ctx,
+   ogc_error *           err,
+   ogc_err_code          err_code,
+   const char *          obj_kwd,
+   int                   pos)
+{
+   size_t prev = OGC_ERR_POS_NONE;
+
+   if ( ctx != OGC_NULL )
+      prev = ctx->set_err_pos(static_cast<size_t>(pos));
+
+   ogc_error::set(err, err_code, obj_kwd, pos);
+
+   if ( ctx != OGC_NULL )
+      ctx->set_err_pos(prev);
+}
+
+/*------------------------------------------------------------------------
+ * WKT scanner
+ *
+ * This reads a WKT string one char at a time, returning the chars
+ * exactly as scan() would copy them into the buffer: () chars are
+ * converted to [], whitespace outside of quotes is removed, quoted
+ * whitespace is collapsed to a single space, and leading & trailing
+ * whitespace in quoted strings is removed.
+ *
+ * This allows us to tokenize a string (and to create the token strings)
+ * directly from the caller's string without copying it.
+ *
+ * As in scan(), the string may end with some extra ] chars
+ * (if not strict parsing).
+ *
+ * The string must have been checked by scan() first.
+ */
+struct ogc_token_scanner
+{
+   const unsigned char * s;      /* current position   */
+   const unsigned char * e;      /* end of string      */
+   bool                  q;      /* in quotes          */
+   bool                  dbl;    /* 2nd char of a ""   */
+   int                   x;      /* extra ] chars      */
+
+   ogc_token_scanner(
+      const char * str,
+      const char * end,
+      bool         in_quotes,
+      int          extra)
+   {
+      s   = reinterpret_cast<const unsigned char *>(str);
+      e   = reinterpret_cast<const unsigned char *>(end);
+      q   = in_quotes;
+      dbl = false;
+      x   = extra;
+   }
+
+   /* returns next char (or -1 at end) and its position in the string */
+   int next(const unsigned char ** ppos)
+   {
+      for (; s < e; )
+      {
+         const unsigned char * p = s;
+         int c = *s++;
+
+         *ppos = p;
+
+         if ( !q )
+         {
+            if ( c == '(' ) c = '[';
+            else
+            if ( c == ')' ) c = ']';
+         }
+
+         if ( c == '"' )
+         {
+            if ( dbl )
+            {
+               dbl = false;
+               return c;
+            }
+
+            if ( q && s < e && *s == '"' )
+            {
+               dbl = true;
+               return c;
+            }
+
+            q = !q;
+            for (; s < e && isspace(*s); s++)
+               ;
+            return c;
+         }
+
+         if ( isspace(c) )
+         {
+            if ( !q )
+               continue;
+
+            for (; s < e && isspace(*s); s++)
+               ;
+
+            /* whitespace before a closing quote is removed */
+            if ( s < e && *s == '"' && (s+1 >= e || s[1] != '"') )
+               continue;
+            return ' ';
+         }
+
+         return c;
+      }
+
+      /* any ] chars added by scan() at the end */
+      *ppos = e;
+      if ( x > 0 )
+      {
+         x--;
+         return ']';
+      }
+      return -1;
+   }
+};
+
+/*------------------------------------------------------------------------
+ * char classes
+ *
+ * This is used to find runs of token chars quickly.  ASCII whitespace
+ * is the same in all locales, but any non-ASCII char may be whitespace
+ * in the current locale, so those are checked with isspace().
+ */
+#define OGC_C_PLAIN   0     /* ordinary char             */
+#define OGC_C_SPACE   1     /* ASCII whitespace          */
+#define OGC_C_DELIM   2     /* "[](),"  chars            */
+#define OGC_C_QUOTE   3     /* quote char                */
+#define OGC_C_HIGH    4     /* non-ASCII char            */
+#define OGC_C_END     5     /* null                      */
+
+#define P  OGC_C_PLAIN
+#define S  OGC_C_SPACE
+#define D  OGC_C_DELIM
+#define Q  OGC_C_QUOTE
+#define H  OGC_C_HIGH
+#define E  OGC_C_END
+
+static const unsigned char ogc_ctab[256] =
+{
+   E, P, P, P, P, P, P, P, P, S, S, S, S, S, P, P,  /* 00 */
+   P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, P,  /* 10 */
+   S, P, Q, P, P, P, P, P, D, D, P, P, D, P, P, P,  /* 20 */
+   P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, P,  /* 30 */
+   P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, P,  /* 40 */
+   P, P, P, P, P, P, P, P, P, P, P, D, P, D, P, P,  /* 50 */
+   P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, P,  /* 60 */
+   P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, P,  /* 70 */
+   H, H, H, H, H, H, H, H, H, H, H, H, H, H, H, H,  /* 80 */
+   H, H, H, H, H, H, H, H, H, H, H, H, H, H, H, H,  /* 90 */
+   H, H, H, H, H, H, H, H, H, H, H, H, H, H, H, H,  /* a0 */
+   H, H, H, H, H, H, H, H, H, H, H, H, H, H, H, H,  /* b0 */
+   H, H, H, H, H, H, H, H, H, H, H, H, H, H, H, H,  /* c0 */
+   H, H, H, H, H, H, H, H, H, H, H, H, H, H, H, H,  /* d0 */
+   H, H, H, H, H, H, H, H, H, H, H, H, H, H, H, H,  /* e0 */
+   H, H, H, H, H, H, H, H, H, H, H, H, H, H, H, H   /* f0 */
+};
+
+#undef P
+#undef S
+#undef D
+#undef Q
+#undef H
+#undef E
+
+/* a char in an unquoted token */
+#define OGC_IS_TOKEN_CHAR(c) \
+   ( ogc_ctab[c] == OGC_C_PLAIN || \
+    (ogc_ctab[c] == OGC_C_HIGH && !isspace(c)) )
+
+/* a char in a quoted token (other than whitespace or a quote) */
+#define OGC_IS_QUOTED_CHAR(c) \
+   ( ogc_ctab[c] == OGC_C_PLAIN || ogc_ctab[c] == OGC_C_DELIM || \
+    (ogc_ctab[c] == OGC_C_HIGH && !isspace(c)) )
+
+/*------------------------------------------------------------------------
+ * get the length of a run of token chars
+ */
+static inline size_t ogc_token_run(const unsigned char * s)
+{
+   const unsigned char * p;
+
+   for (p = s; OGC_IS_TOKEN_CHAR(*p); p++)
+      ;
+   return static_cast<size_t>(p - s);
+}
+
+static inline size_t ogc_quoted_run(const unsigned char * s)
+{
+   const unsigned char * p;
+
+   for (p = s; OGC_IS_QUOTED_CHAR(*p); p++)
+      ;
+   return static_cast<size_t>(p - s);
+}
+
+/*------------------------------------------------------------------------
+ * vectorized scanning
+ */
+bool ogc_token :: _simd = true;
+
+bool ogc_token :: get_simd()
+{
+   return _simd;
+}
+
+bool ogc_token :: set_simd(bool on_off)
+{
+   bool rc = _simd;
+   _simd = on_off;
+   return rc;
+}
+
+const char * ogc_token :: simd_name()
+{
+   return ogc_simd::name();
+}
+
 /*------------------------------------------------------------------------
  * TOKEN constructor
  */
-ogc_token :: ogc_token()
+ogc_token :: ogc_token(int mode)
 {
-   _buffer = OGC_NULL;
-   _num    = 0;
+   _buffer  = OGC_NULL;
+   _buflen  = 0;
+   _bufpos  = 0;
+   _mode    = mode;
+   _wkt     = OGC_NULL;
+   _wkt_end = OGC_NULL;
+   _extra   = 0;
+   _arr     = _fixed;
+   _max     = OGC_TOKENS_INIT;
+   _num     = 0;
+   _sidx    = OGC_NULL;
+   _snum    = 0;
+   _smax    = 0;
+   _copy    = OGC_NULL;
+   _copymax = 0;
+   _ctx     = OGC_NULL;
 }
 
 /*------------------------------------------------------------------------
@@ -36,47 +276,359 @@ ogc_token :: ogc_token()
  */
 ogc_token :: ~ogc_token()
 {
+   ogc_free(_buffer);
+   ogc_free(_sidx);
+   ogc_free(_copy);
+
+   if ( _arr != _fixed )
+   {
+      ogc_free(_arr);
+   }
+}
+
+/*------------------------------------------------------------------------
+ * reset for re-use
+ *
+ * This discards all tokens and token strings, but keeps all memory.
+ */
+void ogc_token :: reset()
+{
+   _num     = 0;
+   _bufpos  = 0;
+   _wkt     = OGC_NULL;
+   _wkt_end = OGC_NULL;
+   _extra   = 0;
+   _snum    = 0;
+}
+
+/*------------------------------------------------------------------------
+ * grow the token array
+ */
+bool ogc_token :: grow()
+{
+   int               max = _max * 2;
+   ogc_token_entry * arr;
+
+   if ( _arr == _fixed )
+   {
+      arr = ogc_alloc<ogc_token_entry>(max);
+      if ( arr == OGC_NULL )
+         return false;
+      memcpy(arr, _arr, _max * sizeof(*arr));
+   }
+   else
+   {
+      arr = static_cast<ogc_token_entry *>(
+               ogc_allocator::realloc(_arr, max * sizeof(*arr)) );
+      if ( arr == OGC_NULL )
+         return false;
+   }
+
+   _arr = arr;
+   _max = max;
+
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * end the token list
+ *
+ * This adds an end entry, so a scan for the end of an object always
+ * stops at the last entry.
+ *
+ * We then set the end of each object and its number of leading
+ * non-object tokens.  This is done from the last entry back, so the end
+ * of an object is found by just jumping over each of its sub-objects.
+ *
+ * Each token is also classified here, and not just those that open an
+ * object, as a bare keyword (even a quoted one) left at the end of an
+ * object is still taken as an object (and reported as one with no
+ * tokens) when not parsing strictly.  In span mode, this is done
+ * directly from the WKT string (inside any quotes), unless the token
+ * has a quote in it.
+ */
+void ogc_token :: end_list(
+   int count)
+{
+   ogc_token_entry * arr = _arr;
+   int i;
+   int j;
+
+   arr[count].str  = OGC_NULL;
+   arr[count].lvl  = -1;
+   arr[count].idx  = 0;
+   arr[count].pos  = 0;
+   arr[count].len  = 0;
+   arr[count].off  = -1;
+   arr[count].end  = count;
+   arr[count].same = 0;
+   arr[count].type = OGC_OBJ_TYPE_UNKNOWN;
+   arr[count].old  = false;
+
+   for (i = count-1; i >= 0; i--)
+   {
+      int          level = arr[i].lvl;
+      int          same  = 0;
+      bool         atoms = true;
+      const char * s     = arr[i].str;
+      int          n     = -1;
+
+      for (j = i+1; arr[j].lvl > level; j = arr[j].end)
+      {
+         if ( atoms && arr[j].idx != 0 )
+            same++;
+         else
+            atoms = false;
+      }
+
+      arr[i].end  = j;
+      arr[i].same = same;
+
+      if ( s == OGC_NULL )
+      {
+         s = _wkt + arr[i].pos;
+         n = arr[i].len;
+         if ( n >= 2 && *s == '"' )
+         {
+            s += 1;
+            n -= 2;
+         }
+         if ( memchr(s, '"', n) != OGC_NULL )
+         {
+            _num = count;
+            s    = str(i);
+            n    = -1;
+         }
+      }
+
+      /* a number is never a keyword */
+      if ( (*s >= '0' && *s <= '9') || *s == '.' || *s == '+' )
+      {
+         arr[i].type = OGC_OBJ_TYPE_UNKNOWN;
+         arr[i].old  = false;
+      }
+      else
+      {
+         arr[i].type = ogc_keyword::lookup(s, n, &arr[i].old);
+      }
+   }
+
+   _num = count;
+}
+
+/*------------------------------------------------------------------------
+ * allocate our buffer (or re-use it if it is big enough)
+ */
+bool ogc_token :: alloc_buffer(
+   size_t len)
+{
+   _bufpos = 0;
+
+   if ( _buffer != OGC_NULL && _buflen >= len )
+      return true;
+
    if ( _buffer != OGC_NULL )
    {
-      delete [] _buffer;
+      ogc_free(_buffer);
+      _buflen = 0;
    }
+
+   _buffer = ogc_alloc<char>(len);
+   if ( _buffer == OGC_NULL )
+      return false;
+   _buflen = len;
+
+   return true;
 }
 
 /*------------------------------------------------------------------------
- * 1st pass through the string
+ * add a token entry
+ * (growing the array as needed, and leaving room for the end entry)
+ */
+#define OGC_ADD_TOKEN(s, l, i, p, n, o) \
+   { \
+      if ( count + 1 >= _max && !grow() ) \
+      { \
+         ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd); \
+         return false; \
+      } \
+      _arr[count].str = (s); \
+      _arr[count].lvl = (l); \
+      _arr[count].idx = (i); \
+      _arr[count].pos = (p); \
+      _arr[count].len = (n); \
+      _arr[count].off = (o); \
+      count++; \
+   }
+
+/*------------------------------------------------------------------------
+ * end a token
  *
- * Copy the string into our internal buffer.
- * While doing this, we convert any () chars to [], and
- * remove any whitespace outside of quotes.
- * We also strip leading & trailing whitespace from quoted sub-strings.
- * We also check that all quotes and [] are balanced.
+ * This adds the token for the delimiter found (0 for the end of the
+ * string), and stops adding tokens once the object is closed.
+ */
+#define OGC_END_TOKEN(d, tstr, tpos, tlen, toff, tempty) \
+   { \
+      switch (d) \
+      { \
+         case '[': \
+            OGC_ADD_TOKEN(tstr, level, 0, tpos, tlen, toff); \
+            index = 1; \
+            level++; \
+            break; \
+         \
+         case ']': \
+         case 0: \
+            if ( !(tempty) ) \
+            { \
+               OGC_ADD_TOKEN(tstr, level, index++, tpos, tlen, toff); \
+            } \
+            level--; \
+            break; \
+         \
+         case ',': \
+            if ( !(tempty) || prev_delim != ']' ) \
+            { \
+               OGC_ADD_TOKEN(tstr, level, index++, tpos, tlen, toff); \
+            } \
+            break; \
+      } \
+      prev_delim = (d); \
+      emit = (level != 0 && (d) != 0); \
+   }
+
+/*------------------------------------------------------------------------
+ * check and tokenize a string in a single pass
  *
- * Notes:
- *    We do everything as unsigned characters, so the ctype
- *    functions work properly.
+ * This checks the string, and adds each token as soon as its
+ * delimiter is found.
  *
- *    We know that the string is non-empty with no leading whitespace.
+ * In copy mode, the cleaned-up string (see ogc_token_scanner above)
+ * is written to our buffer with all delimiters and closing quotes
+ * replaced by nulls, so it holds all the token strings (and the offset
+ * of each token in the caller's string is found from the start of its
+ * text).  In span mode, nothing is copied, and the pos & len of a token
+ * are its span in the caller's string (including any quotes).
+ *
+ * Once the object is closed, no more tokens are added, but the rest of
+ * the string is still checked.
+ *
+ * A quote within an unquoted token (which can only happen in a
+ * badly-formed string) is an error, as is anything but a delimiter
+ * after a closing quote.
  */
-bool ogc_token :: pass1(
+#define OGC_PUT(c)  { if ( ubuf != OGC_NULL ) ubuf[n] = (c); n++; last = (c); }
+#define OGC_PUT_END(c) { if ( ubuf != OGC_NULL ) ubuf[n] = 0; n++; last = (c); }
+
+/* copy a run of chars (as long as the string is not too long)
+   (runs are short, so this is faster than memcpy()) */
+#define OGC_PUT_RUN(run) \
+   { \
+      size_t k = (run); \
+      size_t m = (n < OGC_BUFF_MAX - 1) ? (OGC_BUFF_MAX - 1) - n : 0; \
+      \
+      if ( k > m ) \
+         k = m; \
+      if ( k > 0 ) \
+      { \
+         if ( ubuf != OGC_NULL ) \
+         { \
+            size_t j; \
+            for (j = 0; j < k; j++) \
+               ubuf[n + j] = s[j]; \
+         } \
+         n += k; \
+         s += k; \
+         last = s[-1]; \
+      } \
+   }
+
+#define OGC_SCAN_TOKEN(d, e) \
+   { \
+      int  tpos; \
+      int  tlen; \
+      int  toff; \
+      bool tempty; \
+      \
+      if ( quoted ) \
+      { \
+         tpos   = qpos; \
+         tlen   = qlen; \
+         tempty = qempty; \
+         quoted = false; \
+      } \
+      else if ( ubuf != OGC_NULL ) \
+      { \
+         tpos   = tn; \
+         tlen   = static_cast<int>(n) - tn; \
+         tempty = (tlen == 0); \
+      } \
+      else \
+      { \
+         const unsigned char * tb = ubeg + tp; \
+         const unsigned char * te = (e); \
+         \
+         for (; tb < te && isspace(*tb); tb++) \
+            ; \
+         for (; te > tb && isspace(te[-1]); te--) \
+            ; \
+         tpos   = static_cast<int>(tb - ubeg); \
+         tlen   = static_cast<int>(te - tb); \
+         tempty = (static_cast<int>(n) == tn); \
+      } \
+      \
+      if ( ubuf == OGC_NULL ) \
+      { \
+         toff = tpos; \
+      } \
+      else \
+      { \
+         const unsigned char * tb = ubeg + tp; \
+         \
+         for (; isspace(*tb); tb++) \
+            ; \
+         toff = static_cast<int>(tb - ubeg); \
+      } \
+      \
+      OGC_END_TOKEN(d, (ubuf == OGC_NULL) ? OGC_NULL : _buffer + tpos, \
+         tpos, tlen, toff, tempty); \
+   }
+
+bool ogc_token :: scan(
    const char * str,
    const char * start,
    const char * obj_kwd,
    ogc_error *  err)
 {
-   unsigned char *       ubuf = reinterpret_cast<      unsigned char *>(_buffer);
+   unsigned char *       ubuf = (_mode == OGC_TOKEN_MODE_SPAN) ? OGC_NULL :
+                                reinterpret_cast<      unsigned char *>(_buffer);
    const unsigned char * ustr = reinterpret_cast<const unsigned char *>(str);
    const unsigned char * ubeg = reinterpret_cast<const unsigned char *>(start);
-   unsigned char *       end  = (ubuf + OGC_BUFF_MAX - 1);
    const unsigned char * s    = ustr;
-   unsigned char *       b    = ubuf;
+   size_t                n    = 0;
+   unsigned char         last = 0;
+   bool strict        = ogc_token::strict();
    bool in_quotes     = false;
    int  bracket_count = 0;
    int  pos;
 
+   bool emit       = true;    /* still adding tokens                  */
+   bool quoted     = false;   /* current token is quoted              */
+   int  tn         = 0;       /* copy offset of current token         */
+   int  tp         = static_cast<int>(ustr - ubeg);
+                              /* string offset of current token       */
+   int  qpos       = 0;       /* pos, len, & empty flag of the        */
+   int  qlen       = 0;       /* current token if it is quoted        */
+   bool qempty     = false;
+   int  level      = 0;
+   int  count      = 0;
+   int  prev_delim = 0;
+   int  index      = 0;
+
    if ( !isalpha(*s) )
    {
       pos = static_cast<int>(s-ubeg);
-      ogc_error::set(err, OGC_ERR_WKT_INVALID_SYNTAX, obj_kwd, pos);
+      ogc_token_err(_ctx, err, OGC_ERR_WKT_INVALID_SYNTAX, obj_kwd, pos);
       return false;
    }
 
@@ -84,222 +636,496 @@ bool ogc_token :: pass1(
    {
       unsigned char c = *s++;
 
-      if ( b >= end )
+      if ( n >= OGC_BUFF_MAX - 1 )
       {
          pos = static_cast<int>(s-ubeg);
-         ogc_error::set(err, OGC_ERR_WKT_TOO_LONG, obj_kwd, pos);
+         ogc_token_err(_ctx, err, OGC_ERR_WKT_TOO_LONG, obj_kwd, pos);
          return false;
       }
 
-#if 0 /* reverse-solidus (\) is a valid text character */
-      if ( c == '\\' )
+      if ( in_quotes )
       {
-         /* deal with escape chars */
-         if ( *s == 0 )
+         if ( c == '"' )
          {
-            pos = static_cast<int>(s-ubeg);
-            ogc_error::set(err, OGC_ERR_WKT_INVALID_ESCAPE, obj_kwd, pos);
-            return false;
-         }
-         *b++ = *s++;
-         continue;
-      }
-#endif
+            /* "" treated as single " */
+            if ( *s == '"' )
+            {
+               OGC_PUT(c);
+               OGC_PUT(c);
+               s++;
+               continue;
+            }
 
-      /* fix delimiters */
-      if ( !in_quotes )
-      {
-         if ( c == '(' ) c = '[';
-         else
-         if ( c == ')' ) c = ']';
-      }
+            /* remove trailing whitespace
+               (at most one space, as we collapse quoted whitespace) */
+            in_quotes = false;
+            if ( last == ' ' )
+               n--;
 
-      if ( c == '"' )
-      {
-         /* "" treated as single " */
-         if ( in_quotes && *s == '"' )
-         {
-            *b++ = c;
-            *b++ = c;
-            s++;
-            continue;
-         }
+            if ( ubuf == OGC_NULL )
+               qlen = static_cast<int>(s - ubeg) - qpos;
+            else
+               qlen = static_cast<int>(n) - qpos;
+            qempty = (static_cast<int>(n) == tn);
 
-         in_quotes = !in_quotes;
-         if ( in_quotes )
-         {
-            *b++ = c;
-            /* remove leading whitespace */
-            while ( isspace(*s) )
-               s++;
-         }
-         else
-         {
-            /* remove trailing whitespace */
-            while ( isspace(b[-1]) )
-               b--;
-            *b++ = c;
+            OGC_PUT_END(c);
             for (; isspace(*s); s++)
                ;
             if ( *s != ',' && *s != ']' )
             {
                pos = static_cast<int>(s-ubeg);
-               ogc_error::set(err, OGC_ERR_WKT_EXPECTING_TOKEN, obj_kwd, pos);
+               ogc_token_err(_ctx, err, OGC_ERR_WKT_EXPECTING_TOKEN,
+                  obj_kwd, pos);
                return false;
             }
+            continue;
          }
-         continue;
-      }
 
-      /* convert any quoted whitespace to a space */
-      if ( in_quotes )
-      {
+         /* convert any quoted whitespace to a space */
          if ( isspace(c) )
          {
             /* convert multiple WS to single space */
-            *b++ = ' ';
+            OGC_PUT(' ');
             for (; isspace(*s); s++)
                ;
          }
          else
          {
-            *b++ = c;
+            OGC_PUT(c);
+            OGC_PUT_RUN(ogc_quoted_run(s));
          }
          continue;
       }
 
-      if ( isspace(c) )
+      if ( c == '"' )
+      {
+         /* a quoted token must start right after its delimiter */
+         if ( emit && static_cast<int>(n) != tn )
+         {
+            pos = static_cast<int>(s-ubeg);
+            ogc_token_err(_ctx, err, OGC_ERR_WKT_EXPECTING_TOKEN,
+               obj_kwd, pos);
+            return false;
+         }
+
+         in_quotes = true;
+         quoted    = true;
+         if ( ubuf == OGC_NULL )
+            qpos = static_cast<int>(s - ubeg) - 1;
+         else
+            qpos = static_cast<int>(n) + 1;
+
+         OGC_PUT(c);
+         tn = static_cast<int>(n);
+
+         /* remove leading whitespace */
+         while ( isspace(*s) )
+            s++;
          continue;
+      }
 
-      if (c == '[')
+      if ( c == '[' || c == '(' )
       {
+         c = '[';
          bracket_count++;
+
+         if ( last == ']' )
+         {
+            pos = static_cast<int>(s-ubeg);
+            ogc_token_err(_ctx, err, OGC_ERR_WKT_EXPECTING_TOKEN,
+               obj_kwd, pos);
+            return false;
+         }
       }
-      else if (c == ']')
+      else if ( c == ']' || c == ')' )
       {
-         if ( ! ogc_object::get_strict_parsing() )
+         c = ']';
+         if ( !strict && bracket_count == 0 )
          {
-            if ( bracket_count == 0 )
-               break;
+            s--;
+            break;
          }
 
          if ( --bracket_count < 0 )
          {
             pos = static_cast<int>(s-ubeg);
-            ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_CLOSE_TOKENS, obj_kwd,
-               pos);
+            ogc_token_err(_ctx, err, OGC_ERR_WKT_TOO_MANY_CLOSE_TOKENS,
+               obj_kwd, pos);
             return false;
          }
       }
-
-      if (b[-1] == ']')
+      else if ( c != ',' )
       {
-         if (c != ']' && c != ',')
+         if ( isspace(c) )
+            continue;
+
+         if ( last == ']' )
          {
             pos = static_cast<int>(s-ubeg);
-            ogc_error::set(err, OGC_ERR_WKT_EXPECTING_TOKEN, obj_kwd, pos);
+            ogc_token_err(_ctx, err, OGC_ERR_WKT_EXPECTING_TOKEN,
+               obj_kwd, pos);
             return false;
          }
+
+         OGC_PUT(c);
+         OGC_PUT_RUN(ogc_token_run(s));
+         continue;
       }
 
-      *b++ = c;
+      /* a delimiter ends the current token */
+      if ( emit )
+         OGC_SCAN_TOKEN(c, s - 1);
+
+      OGC_PUT_END(c);
+      tn = static_cast<int>(n);
+      tp = static_cast<int>(s - ubeg);
    }
-   *b = 0;
+   _wkt_end = reinterpret_cast<const char *>(s);
 
    if ( in_quotes )
    {
       pos = static_cast<int>(s-ubeg);
-      ogc_error::set(err, OGC_ERR_WKT_UNBALANCED_QUOTES, obj_kwd, pos);
+      ogc_token_err(_ctx, err, OGC_ERR_WKT_UNBALANCED_QUOTES, obj_kwd, pos);
       return false;
    }
 
    if ( bracket_count > 0 )
    {
-      if ( ogc_object::get_strict_parsing() )
+      if ( strict )
       {
          pos = static_cast<int>(s-ubeg);
-         ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_OPEN_TOKENS, obj_kwd, pos);
+         ogc_token_err(_ctx, err, OGC_ERR_WKT_TOO_MANY_OPEN_TOKENS,
+            obj_kwd, pos);
          return false;
       }
-      else
-      {
-         while (bracket_count--)
-            *b++ = ']';
-         *b = 0;
-      }
+      _extra = bracket_count;
    }
 
+   if ( ubuf != OGC_NULL )
+      ubuf[n] = 0;
+
+   /* the end of the string (or of the object) ends the last token */
+   if ( emit )
+      OGC_SCAN_TOKEN(0, s);
+
+   end_list(count);
    return true;
 }
 
+#undef OGC_SCAN_TOKEN
+#undef OGC_PUT_RUN
+#undef OGC_PUT_END
+#undef OGC_PUT
+
 /*------------------------------------------------------------------------
- * parse a sub-substring
+ * check and tokenize a string in a single pass (span mode, using
+ * structural chars)
  *
- *   input:
- *      pb      address of pointer to start of string
+ * This does the same as scan(), but only looks at the quotes and at the
+ * "[]()," chars outside of quotes (and at any whitespace around them),
+ * which were found by ogc_simd::structurals().
  *
- *   output:
- *      pb      address of pointer to actual start of string
- *              Actual string will be null-terminated.
- *      pe      address of next string to process (or to null)
- *
- *      returns delimiter char found (,[] or 0).
+ * This is only done for strings shorter than OGC_BUFF_MAX, which can
+ * never be too long.
  */
-int ogc_token :: parse_substring(
-   char ** pb,
-   char ** pe)
+#define OGC_SCAN_TOKEN(d, e) \
+   { \
+      int  tb; \
+      int  te; \
+      bool tempty; \
+      \
+      if ( qb >= 0 ) \
+      { \
+         tb = qb; \
+         te = qe; \
+         for (j = tb+1; j < te-1 && isspace(ustr[j]); j++) \
+            ; \
+         tempty = (j == te-1); \
+         qb = -1; \
+      } \
+      else \
+      { \
+         for (tb = tp; tb < (e) && isspace(ustr[tb]); tb++) \
+            ; \
+         for (te = (e); te > tb && isspace(ustr[te-1]); te--) \
+            ; \
+         tempty = (te == tb); \
+      } \
+      \
+      OGC_END_TOKEN(d, OGC_NULL, off + tb, te - tb, off + tb, tempty); \
+   }
+
+bool ogc_token :: scan_simd(
+   const char * str,
+   const char * start,
+   int          len,
+   const char * obj_kwd,
+   ogc_error *  err)
 {
-   char * b = *pb;
-   char * e;
-   int    c;
+   const unsigned char * ustr = reinterpret_cast<const unsigned char *>(str);
+   int  off           = static_cast<int>(str - start);
+   bool strict        = ogc_token::strict();
+   bool in_quotes     = false;
+   int  bracket_count = 0;
+   int  end           = len;
+   int  k;
+   int  i;
+   int  j;
+   int  c;
+
+   bool emit       = true;    /* still adding tokens                  */
+   int  tp         = 0;       /* start of current token               */
+   int  qb         = -1;      /* opening quote of current token       */
+   int  qe         = 0;       /* end of current token if it is quoted */
+   int  level      = 0;
+   int  count      = 0;
+   int  prev_delim = 0;
+   int  index      = 0;
+
+   if ( !isalpha(*ustr) )
+   {
+      ogc_token_err(_ctx, err, OGC_ERR_WKT_INVALID_SYNTAX, obj_kwd, off);
+      return false;
+   }
 
-   if ( *b == '"' )
+   for (k = 0; k < _snum; k++)
    {
-      /* Token is in form "...".
-       * The string is everything within the quotes, and the char
-       * following the closing quote is the delimiter.
-       *
-       * We also have to deal with "" chars.
-       */
-      for (e = ++b; *e; e++)
+      i = _sidx[k];
+      c = ustr[i];
+
+      if ( c == '"' )
       {
-         if ( *e == '"' )
+         /* "" treated as single " (the 2nd " is the next position) */
+         if ( in_quotes && i+1 < len && ustr[i+1] == '"' )
+         {
+            k++;
+            continue;
+         }
+
+         in_quotes = !in_quotes;
+         if ( in_quotes )
          {
-            if ( e[1] == '"' )
+            /* a quoted token must start right after its delimiter */
+            if ( emit )
             {
-               e++;
-               continue;
+               for (j = tp; j < i && isspace(ustr[j]); j++)
+                  ;
+               if ( j < i )
+               {
+                  ogc_token_err(_ctx, err, OGC_ERR_WKT_EXPECTING_TOKEN,
+                     obj_kwd, off + i + 1);
+                  return false;
+               }
+               qb = i;
             }
+         }
+         else
+         {
+            qe = i + 1;
+            for (j = i+1; j < len && isspace(ustr[j]); j++)
+               ;
+            c = (j < len) ? ustr[j] : 0;
+            if ( c != ',' && c != ']' )
+            {
+               ogc_token_err(_ctx, err, OGC_ERR_WKT_EXPECTING_TOKEN, obj_kwd,
+                  off + j);
+               return false;
+            }
+         }
+         continue;
+      }
+
+      if ( c == '[' || c == '(' )
+      {
+         c = '[';
+         bracket_count++;
+      }
+      else if ( c == ']' || c == ')' )
+      {
+         c = ']';
+         if ( !strict && bracket_count == 0 )
+         {
+            end = i;
             break;
          }
+
+         if ( --bracket_count < 0 )
+         {
+            ogc_token_err(_ctx, err, OGC_ERR_WKT_TOO_MANY_CLOSE_TOKENS,
+               obj_kwd, off + i + 1);
+            return false;
+         }
+
+         /* the next char must be a "]" or "," (or a quote, which is
+            checked when the quoted string ends) */
+         for (j = i+1; j < len && isspace(ustr[j]); j++)
+            ;
+         c = (j < len) ? ustr[j] : 0;
+         if ( c != 0   && c != '"' &&
+              c != ']' && c != ')' && c != ',' )
+         {
+            ogc_token_err(_ctx, err, OGC_ERR_WKT_EXPECTING_TOKEN, obj_kwd,
+               off + j + 1);
+            return false;
+         }
+         c = ']';
       }
-      *e++ = 0;
 
-      c = *e;
-      if ( *e != 0 )
-         e++;
+      /* a delimiter ends the current token */
+      if ( emit )
+         OGC_SCAN_TOKEN(c, i);
+      tp = i + 1;
    }
-   else
+   _wkt_end = str + end;
+
+   if ( in_quotes )
    {
-      /* No quotes.
-       * The string is everything up to the first ",[]" char,
-       * which is the delimiter.
-       */
-      for (e = b; *e; e++)
+      ogc_token_err(_ctx, err, OGC_ERR_WKT_UNBALANCED_QUOTES,
+         obj_kwd, off + len);
+      return false;
+   }
+
+   if ( bracket_count > 0 )
+   {
+      if ( strict )
       {
-         if ( *e == '[' || *e == ']' || *e == ',' )
-            break;
+         ogc_token_err(_ctx, err, OGC_ERR_WKT_TOO_MANY_OPEN_TOKENS, obj_kwd,
+            off + len);
+         return false;
       }
+      _extra = bracket_count;
+   }
+
+   /* the end of the string (or of the object) ends the last token */
+   if ( emit )
+      OGC_SCAN_TOKEN(0, end);
+
+   end_list(count);
+   return true;
+}
 
-      c = *e;
-      if ( *e != 0 )
-         *e++ = 0;
+#undef OGC_SCAN_TOKEN
+#undef OGC_END_TOKEN
+
+#undef OGC_ADD_TOKEN
+
+/*------------------------------------------------------------------------
+ * create a token string in span mode
+ *
+ * We know that the buffer is big enough, as no token string can be
+ * longer than the copy-mode copy of the string.
+ */
+char * ogc_token :: make_str(
+   int  n)
+{
+   const ogc_token_entry * e = _arr + n;
+   const char * beg  = _wkt + e->pos;
+   const unsigned char * uend =
+      reinterpret_cast<const unsigned char *>(beg + e->len);
+   const unsigned char * p;
+   ogc_token_scanner sc(beg, _wkt_end, false, _extra);
+   char * str;
+   int    c;
+
+   /* the buffer is allocated (or re-used if it is big enough)
+      when the first token string is created */
+   if ( _bufpos == 0 )
+   {
+      if ( !alloc_buffer((_wkt_end - _wkt) + _extra + 2) )
+         return OGC_NULL;
    }
+   str = _buffer + _bufpos;
+
+   if ( e->len > 0 && *beg == '"' )
+   {
+      /* skip the opening quote, and stop at the closing quote */
+      sc.next(&p);
+      uend--;
+   }
+
+   for (;;)
+   {
+      c = sc.next(&p);
+      if ( c < 0 )
+         break;
 
-   *pb = b;
-   *pe = e;
+      if ( p >= uend )
+         break;
 
-   return c;
+      if ( _bufpos + 1 >= _buflen )
+         break;
+      _buffer[_bufpos++] = static_cast<char>(c);
+   }
+   _buffer[_bufpos++] = 0;
+
+   return str;
+}
+
+/*------------------------------------------------------------------------
+ * get a token string
+ */
+const char * ogc_token :: str(int n) const
+{
+   if ( n < 0 || n >= _num )
+      return OGC_NULL;
+
+   if ( _arr[n].str == OGC_NULL )
+   {
+      ogc_token * t = const_cast<ogc_token *>(this);
+
+      t->_arr[n].str = t->make_str(n);
+      if ( _arr[n].str == OGC_NULL )
+         return "";
+   }
+
+   return _arr[n].str;
+}
+
+/*------------------------------------------------------------------------
+ * get the value of a numeric token
+ *
+ * In span mode, the number is read directly from the caller's string,
+ * unless the token isn't just a number (if it is quoted, for example),
+ * in which case its string is created and read.
+ */
+double ogc_token :: num(int n) const
+{
+   if ( n < 0 || n >= _num )
+      return 0.0;
+
+   if ( _arr[n].str == OGC_NULL )
+   {
+      size_t len = static_cast<size_t>(_arr[n].len);
+      size_t used;
+      double d   = ogc_string::atod(_wkt + _arr[n].pos, len, &used);
+
+      if ( used == len )
+         return d;
+   }
+
+   return ogc_string::atod( str(n) );
+}
+
+/*------------------------------------------------------------------------
+ * get the strict parsing option of our context
+ */
+bool ogc_token :: strict() const
+{
+   if ( _ctx != OGC_NULL )
+      return _ctx->strict();
+
+   return ogc_object::get_strict_parsing();
+}
+
+/*------------------------------------------------------------------------
+ * get a token's object type
+ */
+ogc_obj_type ogc_token :: type(int n) const
+{
+   if ( n < 0 || n >= _num )
+      return OGC_OBJ_TYPE_UNKNOWN;
+
+   return _arr[n].type;
 }
 
 /*------------------------------------------------------------------------
@@ -311,9 +1137,8 @@ bool ogc_token :: tokenize(
    const char * obj_kwd,
    ogc_error *  err)
 {
-   const char * start = str;
-
    ogc_error::clear(err);
+   reset();
 
    /* sanity checks */
    if ( str == OGC_NULL )
@@ -322,131 +1147,175 @@ bool ogc_token :: tokenize(
       return false;
    }
 
-   while ( isspace(*str) )
-      str++;
+   return tokenize_str(str, strlen(str), true, obj_kwd, err);
+}
+
+/*------------------------------------------------------------------------
+ * tokenize a string given by its length
+ * returns: true if successful
+ *
+ * The string doesn't have to be null-terminated (it is taken to end at
+ * a null char if it has one).
+ */
+bool ogc_token :: tokenize(
+   const char * str,
+   size_t       len,
+   const char * obj_kwd,
+   ogc_error *  err)
+{
+   const char * nul;
+
+   ogc_error::clear(err);
+   reset();
 
-   if ( *str == 0 )
+   /* sanity checks */
+   if ( str == OGC_NULL )
    {
       ogc_error::set(err, OGC_ERR_WKT_EMPTY_STRING, obj_kwd);
       return false;
    }
 
-   /* Allocate a buffer to store a copy of the string.
-      We double the length to deal with possible extra ]
-      chars we may have to add at the end.
-   */
-   _buffer = new (std::nothrow) char [strlen(str) * 2];
-   if ( _buffer == OGC_NULL )
+   nul = static_cast<const char *>( memchr(str, 0, len) );
+   if ( nul != OGC_NULL )
+      return tokenize_str(str, nul - str, true, obj_kwd, err);
+
+   return tokenize_str(str, len, false, obj_kwd, err);
+}
+
+/*------------------------------------------------------------------------
+ * tokenize a string of a given length
+ *
+ * Any error goes to the context's error routine (if there is one).
+ */
+bool ogc_token :: tokenize_str(
+   const char * start,
+   size_t       len,
+   bool         terminated,
+   const char * obj_kwd,
+   ogc_error *  err)
+{
+   ogc_alloc_scope ascope(_ctx);
+   ogc_error       e;
+   ogc_error *     perr = ogc_parse_ctx::begin_err(_ctx, err, &e);
+   bool            rc;
+
+   rc = scan_str(start, len, terminated, obj_kwd, perr);
+   ogc_parse_ctx::end_err(err, perr);
+
+   return rc;
+}
+
+/*------------------------------------------------------------------------
+ * check and scan a string of a given length
+ *
+ * In span mode, a short string is scanned in place (using its length)
+ * whether it is null-terminated or not.  Otherwise, a string that is not
+ * null-terminated is first copied (so scan() can find its end).
+ */
+bool ogc_token :: scan_str(
+   const char * start,
+   size_t       len,
+   bool         terminated,
+   const char * obj_kwd,
+   ogc_error *  err)
+{
+   const char * str = start;
+   const char * end = start + len;
+
+   while ( str < end && isspace(*str) )
+      str++;
+
+   if ( str == end )
    {
-      ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd);
+      ogc_error::set(err, OGC_ERR_WKT_EMPTY_STRING, obj_kwd);
       return false;
    }
-   *_buffer = 0;
+   len = static_cast<size_t>(end - str);
 
-   /* do the first pass through the string */
-   if ( !pass1(str, start, obj_kwd, err) )
+   if ( _ctx != OGC_NULL && _ctx->max_len() > 0 && len > _ctx->max_len() )
    {
+      int pos = static_cast<int>(str - start) +
+                static_cast<int>(_ctx->max_len()) + 1;
+      ogc_token_err(_ctx, err, OGC_ERR_WKT_TOO_LONG, obj_kwd, pos);
       return false;
    }
 
-   /* Now do the 2nd pass.
-    *
-    * At this time, we know the following:
-    *   1.  String is non-empty.
-    *   2.  String starts with an alphanumeric char.
-    *   3.  All non-essential whitespace is gone, including leading
-    *       and trailing whitespace in quoted strings.
-    *   4.  Quotes and "[]" are matched.
-    *   5.  Any internal "]"  is followed by a "," or a "]" char.
-    *   6.  Any quoted string is followed by a "," or a "]" char.
-    */
+   if ( _mode == OGC_TOKEN_MODE_SPAN && _simd && len < OGC_BUFF_MAX )
    {
-      int     level = 0;
-      int     count = 0;
-      char *  b     = _buffer;
-      char *  e;
-      int     delim;
-      int     prev_delim = 0;
-      int     index = 0;
-
-      for (;;)
-      {
-         delim = parse_substring(&b, &e);
+      /* Just check the string and find the tokens in the caller's
+         string.  Our buffer (for the token strings) is not allocated
+         until it is needed, and is re-used if it is big enough.
+      */
+      int slen = static_cast<int>(len);
 
-         switch (delim)
+      _wkt = start;
+
+      if ( _smax < slen )
+      {
+         int * sidx = ogc_alloc<int>(slen);
+         if ( sidx == OGC_NULL )
          {
-            case '[':
-               /*---------------------------------------------------------
-                * add this name as a new sub-object
-                */
-               {
-                  if ( count >= OGC_TOKENS_MAX )
-                  {
-                     ogc_error::set(err, OGC_ERR_WKT_MAX_TOKENS_EXCEEDED,
-                        obj_kwd);
-                     return false;
-                  }
-                  _arr[count].str = b;
-                  _arr[count].lvl = level;
-                  _arr[count].idx = 0;
-                  count++;
-               }
-               index = 1;
-               level++;
-               break;
-
-            case ']':
-            case 0:
-               /*---------------------------------------------------------
-                * end this object
-                */
-               if ( *b != 0 )
-               {
-                  if ( count >= OGC_TOKENS_MAX )
-                  {
-                     ogc_error::set(err, OGC_ERR_WKT_MAX_TOKENS_EXCEEDED,
-                        obj_kwd);
-                     return false;
-                  }
-                  _arr[count].str = b;
-                  _arr[count].lvl = level;
-                  _arr[count].idx = index++;
-                  count++;
-               }
-               level--;
-               break;
-
-            case ',':
-               /*---------------------------------------------------------
-                * entry delimiter
-                * We add this string if it is non-empty or if it doesn't
-                * follow a object-close.
-                */
-               if (*b != 0 || prev_delim != ']')
-               {
-                  if ( count >= OGC_TOKENS_MAX )
-                  {
-                     ogc_error::set(err, OGC_ERR_WKT_MAX_TOKENS_EXCEEDED,
-                        obj_kwd);
-                     return false;
-                  }
-                  _arr[count].str = b;
-                  _arr[count].lvl = level;
-                  _arr[count].idx = index++;
-                  count++;
-               }
-               break;
+            ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd);
+            return false;
          }
+         ogc_free(_sidx);
+         _sidx = sidx;
+         _smax = slen;
+      }
 
-         b = e;
-         prev_delim = delim;
+      _snum = ogc_simd::structurals(str, slen, _sidx);
+      return scan_simd(str, start, slen, obj_kwd, err);
+   }
 
-         if ( level == 0 || delim == 0 )
-            break;
+   if ( !terminated )
+   {
+      /* copy it (with any leading whitespace, so error positions are
+         the same), re-using our copy if it is big enough */
+      size_t clen = static_cast<size_t>(end - start);
+
+      if ( _copymax < clen + 1 )
+      {
+         char * copy = ogc_alloc<char>(clen + 1);
+         if ( copy == OGC_NULL )
+         {
+            ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd);
+            return false;
+         }
+         ogc_free(_copy);
+         _copy    = copy;
+         _copymax = clen + 1;
       }
 
-      _num = count;
+      memcpy(_copy, start, clen);
+      _copy[clen] = 0;
+      str   = _copy + (str - start);
+      start = _copy;
+   }
+
+   if ( _mode == OGC_TOKEN_MODE_SPAN )
+   {
+      _wkt = start;
+      return scan(str, start, obj_kwd, err);
+   }
+
+   /* Allocate a buffer to store a copy of the string.
+      We double the length to deal with possible extra ]
+      chars we may have to add at the end.
+   */
+   if ( !alloc_buffer(len * 2) )
+   {
+      ogc_error::set(err, OGC_ERR_NO_MEMORY, obj_kwd);
+      return false;
+   }
+   *_buffer = 0;
+
+   /* check the string, copying it into our buffer */
+   if ( !scan(str, start, obj_kwd, err) )
+   {
+      return false;
    }
+   _wkt     = _buffer;
+   _wkt_end = _buffer;
 
    return true;
 }
@@ -0,0 +1,306 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* incremental WKT tokenizing                                                */
+/*                                                                           */
+/* The stream text is kept in a buffer, from the start of the first object   */
+/* not yet taken.  Each char is only scanned once (for quotes and brackets), */
+/* no matter how many chunks an object arrives in, and an object is then     */
+/* tokenized in place in the buffer.                                         */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+#define OGC_STREAM_INIT  4096   /* initial buffer length */
+
+/*------------------------------------------------------------------------
+ * TOKEN_STREAM constructor
+ */
+ogc_token_stream :: ogc_token_stream(int mode) : _token(mode)
+{
+   _buffer   = OGC_NULL;
+   _buflen   = 0;
+
+   reset();
+}
+
+/*------------------------------------------------------------------------
+ * TOKEN_STREAM destructor
+ */
+ogc_token_stream :: ~ogc_token_stream()
+{
+   ogc_free(_buffer);
+}
+
+/*------------------------------------------------------------------------
+ * reset for re-use
+ *
+ * This discards all stream text, but keeps all memory.
+ */
+void ogc_token_stream :: reset()
+{
+   _token.reset();
+
+   _len       = 0;
+   _beg       = 0;
+   _pos       = 0;
+   _end       = 0;
+   _saved     = 0;
+   _taken     = false;
+   _ok        = false;
+   _finished  = false;
+
+   _started   = false;
+   _in_quotes = false;
+   _skip      = false;
+   _depth     = 0;
+   _count     = 0;
+   _skip_pos  = 0;
+}
+
+/*------------------------------------------------------------------------
+ * make sure the buffer can hold len chars
+ */
+bool ogc_token_stream :: reserve(
+   size_t len)
+{
+   size_t max;
+   char * buf;
+
+   if ( _buffer != OGC_NULL && _buflen >= len )
+      return true;
+
+   max = (_buflen == 0) ? OGC_STREAM_INIT : _buflen;
+   while ( max < len )
+      max *= 2;
+
+   buf = static_cast<char *>( ogc_allocator::realloc(_buffer, max) );
+   if ( buf == OGC_NULL )
+      return false;
+
+   _buffer = buf;
+   _buflen = max;
+
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * release the object last taken
+ *
+ * Its terminating null is replaced by the char that was there, and its
+ * text is then discarded (the next feed() will drop it from the buffer).
+ */
+void ogc_token_stream :: release()
+{
+   if ( _taken )
+   {
+      _buffer[_end] = _saved;
+      _beg   = _end;
+      _taken = false;
+   }
+
+   _ok = false;
+   _token.reset();
+}
+
+/*------------------------------------------------------------------------
+ * take the current object, which ends at end, and tokenize it
+ *
+ * The object is null-terminated in place (there is always room for
+ * the null after the text), so it doesn't have to be copied.
+ */
+bool ogc_token_stream :: take(
+   size_t       end,
+   ogc_error *  err)
+{
+   bool skip     = _skip;
+   int  skip_pos = static_cast<int>(_skip_pos);
+
+   _started   = false;
+   _in_quotes = false;
+   _skip      = false;
+   _depth     = 0;
+   _count     = 0;
+   _skip_pos  = 0;
+
+   if ( skip )
+   {
+      /* its text has already been discarded */
+      _beg = end;
+      ogc_error::set(err, OGC_ERR_WKT_TOO_LONG, OGC_OBJ_KWD_OBJECT,
+         skip_pos);
+      return true;
+   }
+
+   _end          = end;
+   _saved        = _buffer[end];
+   _buffer[end]  = 0;
+   _taken        = true;
+
+   _ok = _token.tokenize(_buffer + _beg, OGC_OBJ_KWD_OBJECT, err);
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * add a chunk of the stream
+ *
+ * Any text before the current object is dropped first, so the buffer
+ * only grows to hold the largest object (plus a chunk).
+ */
+bool ogc_token_stream :: feed(
+   const char * buf,
+   size_t       len,
+   ogc_error *  err)
+{
+   ogc_error::clear(err);
+   release();
+   _finished = false;
+
+   if ( buf == OGC_NULL || len == 0 )
+      return true;
+
+   if ( _beg > 0 )
+   {
+      _len -= _beg;
+      _pos -= _beg;
+      if ( _len > 0 )
+         memmove(_buffer, _buffer + _beg, _len);
+      _beg = 0;
+      _end = 0;
+   }
+
+   /* leave room for a terminating null */
+   if ( !reserve(_len + len + 1) )
+   {
+      ogc_error::set(err, OGC_ERR_NO_MEMORY, OGC_OBJ_KWD_OBJECT);
+      return false;
+   }
+
+   memcpy(_buffer + _len, buf, len);
+   _len += len;
+
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * end the stream
+ */
+void ogc_token_stream :: finish()
+{
+   release();
+   _finished = true;
+}
+
+/*------------------------------------------------------------------------
+ * take the next complete object from the stream
+ * returns: true if an object was taken (err is set if it is invalid)
+ *
+ * The scan continues from where the last one stopped, so only the quote
+ * state, the bracket depth, and the length of the current object have
+ * to be kept.  A "" within quotes just ends and starts the quotes again,
+ * so it needs no special handling.
+ *
+ * An object whose non-whitespace chars can't fit in OGC_BUFF_MAX would
+ * be rejected as too long by tokenize(), so once it gets that long we
+ * stop keeping its text, and just scan for its end.
+ */
+bool ogc_token_stream :: next(
+   ogc_error *  err)
+{
+   ogc_error::clear(err);
+   release();
+
+   for (; _pos < _len; _pos++)
+   {
+      int c = static_cast<unsigned char>(_buffer[_pos]);
+
+      if ( isspace(c) )
+      {
+         /* skip whitespace between objects */
+         if ( !_started )
+            _beg = _pos + 1;
+         continue;
+      }
+      _started = true;
+
+      if ( ++_count >= OGC_BUFF_MAX && !_skip )
+      {
+         _skip     = true;
+         _skip_pos = _pos - _beg + 1;
+      }
+
+      if ( _in_quotes )
+      {
+         if ( c == '"' )
+            _in_quotes = false;
+         continue;
+      }
+
+      switch (c)
+      {
+         case '"':
+            _in_quotes = true;
+            break;
+
+         case '[':
+         case '(':
+            _depth++;
+            break;
+
+         case ']':
+         case ')':
+            /* this closes the object (a close with no open also ends
+               it, and tokenize() will reject it) */
+            if ( --_depth <= 0 )
+            {
+               _pos++;
+               return take(_pos, err);
+            }
+            break;
+      }
+   }
+
+   /* don't keep the text of an object that is too long */
+   if ( _skip )
+      _beg = _pos;
+
+   /* the end of the stream ends any object that was never closed */
+   if ( _finished && _started )
+      return take(_len, err);
+
+   return false;
+}
+
+/*------------------------------------------------------------------------
+ * get the tokens of the object taken
+ */
+const ogc_token * ogc_token_stream :: token() const
+{
+   return _ok ? &_token : OGC_NULL;
+}
+
+/*------------------------------------------------------------------------
+ * get the WKT string of the object taken
+ */
+const char * ogc_token_stream :: wkt() const
+{
+   return _taken ? _buffer + _beg : OGC_NULL;
+}
+
+} /* namespace OGC */
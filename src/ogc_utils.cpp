@@ -734,7 +734,7 @@ bool ogc_utils :: expand_wkt(
 
    if ( inp_buffer == out_buffer )
    {
-      tmp_buffer = new (std::nothrow) char [strlen(inp_buffer)+1];
+      tmp_buffer = ogc_alloc<char>(strlen(inp_buffer)+1);
       if ( tmp_buffer == OGC_NULL )
       {
          return false;
@@ -821,7 +821,7 @@ bool ogc_utils :: expand_wkt(
    }
 
    if ( tmp_buffer != OGC_NULL )
-      delete [] tmp_buffer;
+      ogc_free(tmp_buffer);
 
    return true;
 }
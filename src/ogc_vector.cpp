@@ -22,6 +22,46 @@
 
 namespace OGC {
 
+/*------------------------------------------------------------------------
+ * allocation
+ *
+ * While validating (or parsing into an arena), vectors (and their
+ * arrays) are taken from scratch memory, and are never freed (see
+ * ogc_object).
+ */
+void * ogc_vector :: operator new(
+   size_t                 size,
+   const std::nothrow_t & nt) OGC_NOTHROW
+{
+   (void)(nt);
+   return ogc_scratch::alloc(size);
+}
+
+void ogc_vector :: operator delete(
+   void * p)
+{
+   ogc_allocator::free(p);
+}
+
+void ogc_vector :: operator delete(
+   void *                 p,
+   const std::nothrow_t & nt) OGC_NOTHROW
+{
+   (void)(nt);
+   ogc_vector::operator delete(p);
+}
+
+ogc_object ** ogc_vector :: alloc_array(int n)
+{
+   return static_cast<ogc_object **>(
+      ogc_scratch::alloc(n * sizeof(ogc_object *)) );
+}
+
+void ogc_vector :: free_array(ogc_object ** array)
+{
+   ogc_allocator::free(array);
+}
+
 /*------------------------------------------------------------------------
  * destructor
  */
@@ -33,7 +73,7 @@ ogc_vector :: ~ogc_vector()
       {
          _array[i] = ogc_object :: destroy(_array[i]);
       }
-      delete [] _array;
+      free_array(_array);
    }
 }
 
@@ -61,7 +101,7 @@ ogc_vector * ogc_vector :: create(
 
       if ( capacity > 0 )
       {
-         v->_array = new (std::nothrow) ogc_object * [capacity];
+         v->_array = alloc_array(capacity);
          if ( v->_array == OGC_NULL )
          {
             v->_capacity = 0;
@@ -136,7 +176,7 @@ int ogc_vector :: add(ogc_object * element)
          return -1;
 
       int new_capacity = _capacity + _increment;
-      ogc_object ** new_array = new (std::nothrow) ogc_object * [new_capacity];
+      ogc_object ** new_array = alloc_array(new_capacity);
 
       if ( new_array == OGC_NULL )
       {
@@ -145,7 +185,7 @@ int ogc_vector :: add(ogc_object * element)
 
       for (int i = 0; i < _length; i++)
         new_array[i] = _array[i];
-      delete [] _array;
+      free_array(_array);
 
       _array    = new_array;
       _capacity = new_capacity;
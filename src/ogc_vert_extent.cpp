@@ -97,10 +97,8 @@ ogc_vert_extent * ogc_vert_extent :: from_tokens(
    const ogc_token_entry * arr;
    const char * kwd;
    bool bad = false;
-   int  level;
    int  same;
    int  end;
-   int  num;
 
    ogc_vert_extent * obj     = OGC_NULL;
    ogc_lenunit *     lenunit = OGC_NULL;
@@ -122,35 +120,24 @@ ogc_vert_extent * ogc_vert_extent :: from_tokens(
       ogc_error::set(err, OGC_ERR_WKT_INDEX_OUT_OF_RANGE, obj_kwd(), start);
       return OGC_NULL;
    }
-   kwd = arr[start].str;
+   kwd = t->str(start);
+   ogc_err_pos epos(t, start);
 
-   if ( !is_kwd(kwd) )
+   if ( arr[start].type != OGC_OBJ_TYPE_VERT_EXTENT )
    {
       ogc_error::set(err, OGC_ERR_WKT_INVALID_KEYWORD, obj_kwd(), kwd);
       return OGC_NULL;
    }
 
    /*---------------------------------------------------------
-    * Get the level for this object,
-    * the number of tokens at that level,
-    * and the total number of tokens.
+    * Get the end of this object and
+    * the number of tokens at its level.
     */
-   level = arr[start].lvl;
-   for (end = start+1; end < t->_num; end++)
-   {
-      if ( arr[end].lvl <= level )
-         break;
-   }
+   end  = arr[start].end;
+   same = arr[start].same;
 
    if ( pend != OGC_NULL )
       *pend = end;
-   num = (end - start);
-
-   for (same = 0; same < num; same++)
-   {
-      if ( arr[start+same+1].lvl != level+1 || arr[start+same+1].idx == 0 )
-         break;
-   }
 
    /*---------------------------------------------------------
     * There must be 2 tokens: VERTEXTENT[ min_ht, max_ht ...
@@ -161,7 +148,7 @@ ogc_vert_extent * ogc_vert_extent :: from_tokens(
       return OGC_NULL;
    }
 
-   if ( same > 2 && get_strict_parsing() )
+   if ( same > 2 && t->strict() )
    {
       ogc_error::set(err, OGC_ERR_WKT_TOO_MANY_TOKENS,     obj_kwd(), same);
       return OGC_NULL;
@@ -173,8 +160,8 @@ ogc_vert_extent * ogc_vert_extent :: from_tokens(
     * Process all non-object tokens.
     * They come first and are syntactically fixed.
     */
-   min_ht = ogc_string::atod( arr[start++].str );
-   max_ht = ogc_string::atod( arr[start++].str );
+   min_ht = t->num(start++);
+   max_ht = t->num(start++);
 
    /*---------------------------------------------------------
     * Now process all sub-objects
@@ -182,26 +169,27 @@ ogc_vert_extent * ogc_vert_extent :: from_tokens(
    int  next = 0;
    for (int i = start; i < end; i = next)
    {
-      if ( ogc_lenunit::is_kwd(arr[i].str) )
+      /* skip over this sub-object if it is a duplicate or is unknown */
+      next = arr[i].end;
+
+      switch (arr[i].type)
       {
-         if ( lenunit != OGC_NULL )
-         {
-            ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
-            bad = true;
-         }
-         else
-         {
-            lenunit = ogc_lenunit::from_tokens(t, i, &next, err);
-            if ( lenunit == OGC_NULL )
+         case OGC_OBJ_TYPE_LENUNIT:
+         case OGC_OBJ_TYPE_UNIT:
+            if ( lenunit != OGC_NULL )
+            {
+               ogc_error::set(err, OGC_ERR_WKT_DUPLICATE_UNIT, obj_kwd());
                bad = true;
-         }
-         continue;
-      }
+            }
+            else
+            {
+               lenunit = ogc_lenunit::from_tokens(t, i, &next, err);
+               if ( lenunit == OGC_NULL )
+                  bad = true;
+            }
+            break;
 
-      /* unknown object, skip over it */
-      for (next = i+1; next < end; next++)
-      {
-         if ( (arr[next].lvl <= arr[i].lvl) )
+         default:
             break;
       }
    }
@@ -211,6 +199,8 @@ ogc_vert_extent * ogc_vert_extent :: from_tokens(
     */
    if ( !bad )
    {
+      lenunit = ogc_share_obj(lenunit);
+
       obj = create(min_ht, max_ht, lenunit, err);
    }
 
@@ -230,7 +220,7 @@ ogc_vert_extent * ogc_vert_extent :: from_wkt(
    ogc_error *  err)
 {
    ogc_vert_extent * obj = OGC_NULL;
-   ogc_token t;
+   ogc_token t(OGC_TOKEN_MODE_SPAN);
 
    if ( t.tokenize(wkt, obj_kwd(), err) )
    {
@@ -264,50 +254,45 @@ bool ogc_vert_extent :: to_wkt(
    int       options,
    size_t    buflen) const
 {
-   OGC_TBUF      buf_hdr;
-   OGC_TBUF      buf_lenunit;
-   OGC_NBUF      buf_min_ht;
-   OGC_NBUF      buf_max_ht;
+   ogc_wkt_writer w(buffer, buflen);
+   bool           rc = to_wkt(w, options);
+
+   return (rc && w.ok());
+}
+
+/*------------------------------------------------------------------------
+ * object to a WKT writer
+ */
+bool ogc_vert_extent :: to_wkt(
+   const ogc_vert_extent * obj,
+   ogc_wkt_writer &        w,
+   int                     options)
+{
+   if ( obj == OGC_NULL )
+      return true;
+
+   return obj->to_wkt(w, options);
+}
+
+bool ogc_vert_extent :: to_wkt(
+   ogc_wkt_writer & w,
+   int              options) const
+{
    int           opts  =  (options | OGC_WKT_OPT_INTERNAL);
-   size_t        len   = 0;
    bool          rc    = true;
-   const char *  opn   = "[";
-   const char *  cls   = "]";
    const char *  kwd   = obj_kwd();
 
-   if ( (options & OGC_WKT_OPT_PARENS) != 0 )
-   {
-      opn = "(";
-      cls = ")";
-   }
-
-   if ( buffer == OGC_NULL )
-      return false;
-   *buffer = 0;
-
    if ( !is_visible() )
       return true;
 
    if ( (options & OGC_WKT_OPT_OLD_SYNTAX) != 0 )
       return true;
 
-   ogc_string :: dtoa(_min_ht, buf_min_ht);
-   ogc_string :: dtoa(_max_ht, buf_max_ht);
-
-   rc &= ogc_lenunit :: to_wkt(_lenunit, buf_lenunit, opts, OGC_TBUF_MAX);
-
-   sprintf(buf_hdr, "%s%s%s,%s",
-      kwd, opn, buf_min_ht, buf_max_ht);
-
-   OGC_CPY_TO_BUF( buf_hdr     );
-   OGC_ADD_TO_BUF( buf_lenunit );
-   OGC_CPY_TO_BUF( cls         );
-
-   if ( (options & OGC_WKT_OPT_INTERNAL) == 0 &&
-        (options & OGC_WKT_OPT_EXPAND)   != 0 )
-   {
-      rc &= ogc_utils :: expand_wkt(buffer, buffer, "", options, buflen);
-   }
+   w.open(kwd, options);
+   w.put_num(_min_ht);
+   w.put_num(_max_ht);
+   rc &= ogc_lenunit :: to_wkt(_lenunit, w, opts);
+   w.close(options);
 
    return rc;
 }
@@ -324,7 +309,7 @@ ogc_vert_extent * ogc_vert_extent :: clone(const ogc_vert_extent * obj)
 
 ogc_vert_extent * ogc_vert_extent :: clone() const
 {
-   ogc_lenunit * lenunit = ogc_lenunit :: clone( _lenunit );
+   ogc_lenunit * lenunit = ogc_share_clone( _lenunit );
 
    ogc_vert_extent * p = create(_min_ht,
                                 _max_ht,
@@ -0,0 +1,722 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* WKT file reader                                                           */
+/*                                                                           */
+/* The whole file is mapped into memory, and each WKT string is returned as  */
+/* a view into it, so nothing is copied and no line buffer limits its        */
+/* length.  Lines are found with memchr(), and multi-line strings by a scan  */
+/* that only stops at quotes and brackets.                                   */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+#include <stdio.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace OGC {
+
+#define OGC_READER_CHUNK      (64 * 1024)   /* read size if not mapped    */
+#define OGC_READER_PART_MIN   (64 * 1024)   /* min bytes for a thread     */
+#define OGC_READER_PART_SIZE  (1024 * 1024) /* bytes for a thread a round */
+
+/*------------------------------------------------------------------------
+ * a string parsed by parse_all()
+ */
+struct ogc_reader_str
+{
+   size_t       beg;    /* offset of the string         */
+   size_t       len;    /* length of the string         */
+   size_t       end;    /* position after the string    */
+   ogc_object * obj;    /* object (NULL if not parsed)  */
+   ogc_error *  err;    /* last error (NULL if none)    */
+   bool         made;   /* true if an object was made   */
+};
+
+/*------------------------------------------------------------------------
+ * the part of the file parsed by one thread of parse_all()
+ */
+struct ogc_reader_part
+{
+   const ogc_wkt_reader * rdr;
+   bool                   strict;
+   bool                   keep;    /* false to destroy the objects    */
+   size_t                 beg;     /* where the first string is guessed */
+   size_t                 stop;    /* where the next part is guessed    */
+   size_t                 end;     /* position after the last string    */
+   ogc_reader_str *       strs;
+   size_t                 num;
+   size_t                 max;
+};
+
+/*------------------------------------------------------------------------
+ * table of chars the multi-line scan has to stop at
+ */
+static unsigned char ogc_reader_stops[256];
+
+static const unsigned char * ogc_reader_get_stops()
+{
+   if ( ogc_reader_stops['"'] == 0 )
+   {
+      ogc_reader_stops['['] = 1;
+      ogc_reader_stops['('] = 1;
+      ogc_reader_stops[']'] = 1;
+      ogc_reader_stops[')'] = 1;
+      ogc_reader_stops['"'] = 1;
+   }
+   return ogc_reader_stops;
+}
+
+/*------------------------------------------------------------------------
+ * WKT_READER constructor
+ */
+ogc_wkt_reader :: ogc_wkt_reader(int mode)
+{
+   _data  = OGC_NULL;
+   _size  = 0;
+   _pos   = 0;
+   _mode  = mode;
+   _mem   = OGC_NULL;
+   _map   = OGC_NULL;
+#ifdef _WIN32
+   _hfile = OGC_NULL;
+   _hmap  = OGC_NULL;
+#endif
+}
+
+/*------------------------------------------------------------------------
+ * WKT_READER destructor
+ */
+ogc_wkt_reader :: ~ogc_wkt_reader()
+{
+   close();
+}
+
+/*------------------------------------------------------------------------
+ * close the file
+ */
+void ogc_wkt_reader :: close()
+{
+#ifdef _WIN32
+   if ( _map != OGC_NULL )
+      UnmapViewOfFile(_map);
+   if ( _hmap != OGC_NULL )
+      CloseHandle(static_cast<HANDLE>(_hmap));
+   if ( _hfile != OGC_NULL )
+      CloseHandle(static_cast<HANDLE>(_hfile));
+   _hfile = OGC_NULL;
+   _hmap  = OGC_NULL;
+#else
+   if ( _map != OGC_NULL )
+      munmap(_map, _size);
+#endif
+
+   ogc_free(_mem);
+
+   _data = OGC_NULL;
+   _size = 0;
+   _pos  = 0;
+   _mem  = OGC_NULL;
+   _map  = OGC_NULL;
+}
+
+/*------------------------------------------------------------------------
+ * read a file (or stdin) into memory
+ *
+ * This is only done if it can't be mapped.
+ */
+bool ogc_wkt_reader :: read_file(
+   const char * filename,
+   ogc_error *  err)
+{
+   bool   is_stdin = (strcmp(filename, "-") == 0);
+   FILE * fp       = is_stdin ? stdin : fopen(filename, "rb");
+   size_t max      = 0;
+   size_t len      = 0;
+   bool   ok       = true;
+
+   if ( fp == OGC_NULL )
+   {
+      ogc_error::set(err, OGC_ERR_CANNOT_OPEN_FILE, OGC_NULL, filename);
+      return false;
+   }
+
+   for (;;)
+   {
+      size_t n;
+
+      if ( max - len < OGC_READER_CHUNK )
+      {
+         size_t new_max = (max == 0) ? OGC_READER_CHUNK * 4 : max * 2;
+         char * mem     = static_cast<char *>(
+                             ogc_allocator::realloc(_mem, new_max) );
+
+         if ( mem == OGC_NULL )
+         {
+            ogc_error::set(err, OGC_ERR_NO_MEMORY, OGC_NULL);
+            ok = false;
+            break;
+         }
+         _mem = mem;
+         max  = new_max;
+      }
+
+      n = fread(_mem + len, 1, max - len, fp);
+      if ( n == 0 )
+         break;
+      len += n;
+   }
+
+   if ( !is_stdin )
+      fclose(fp);
+
+   if ( !ok )
+   {
+      close();
+      return false;
+   }
+
+   _data = _mem;
+   _size = len;
+
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * open a file
+ *
+ * An empty file has nothing to map, so it just has no data.
+ */
+bool ogc_wkt_reader :: open(
+   const char * filename,
+   ogc_error *  err)
+{
+   ogc_error::clear(err);
+   close();
+
+   if ( filename == OGC_NULL || *filename == 0 )
+   {
+      ogc_error::set(err, OGC_ERR_CANNOT_OPEN_FILE, OGC_NULL, "");
+      return false;
+   }
+
+   if ( strcmp(filename, "-") == 0 )
+      return read_file(filename, err);
+
+#ifdef _WIN32
+   {
+      HANDLE        hfile;
+      HANDLE        hmap;
+      LARGE_INTEGER size;
+      void *        map;
+
+      hfile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                          OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+      if ( hfile == INVALID_HANDLE_VALUE )
+      {
+         ogc_error::set(err, OGC_ERR_CANNOT_OPEN_FILE, OGC_NULL, filename);
+         return false;
+      }
+
+      if ( GetFileType(hfile) != FILE_TYPE_DISK ||
+           !GetFileSizeEx(hfile, &size) ||
+           static_cast<unsigned long long>(size.QuadPart) !=
+              static_cast<size_t>(size.QuadPart) )
+      {
+         CloseHandle(hfile);
+         return read_file(filename, err);
+      }
+
+      if ( size.QuadPart == 0 )
+      {
+         CloseHandle(hfile);
+         return true;
+      }
+
+      hmap = CreateFileMappingA(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+      map  = (hmap == NULL) ? NULL :
+             MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+      if ( map == NULL )
+      {
+         if ( hmap != NULL )
+            CloseHandle(hmap);
+         CloseHandle(hfile);
+         return read_file(filename, err);
+      }
+
+      _hfile = hfile;
+      _hmap  = hmap;
+      _map   = map;
+      _data  = static_cast<const char *>(map);
+      _size  = static_cast<size_t>(size.QuadPart);
+   }
+#else
+   {
+      struct stat st;
+      void *      map;
+      int         fd;
+
+      fd = ::open(filename, O_RDONLY);
+      if ( fd < 0 )
+      {
+         ogc_error::set(err, OGC_ERR_CANNOT_OPEN_FILE, OGC_NULL, filename);
+         return false;
+      }
+
+      if ( fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+           static_cast<unsigned long long>(st.st_size) !=
+              static_cast<size_t>(st.st_size) )
+      {
+         ::close(fd);
+         return read_file(filename, err);
+      }
+
+      if ( st.st_size == 0 )
+      {
+         ::close(fd);
+         return true;
+      }
+
+      map = mmap(OGC_NULL, static_cast<size_t>(st.st_size), PROT_READ,
+                 MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if ( map == MAP_FAILED )
+         return read_file(filename, err);
+
+#  ifdef MADV_SEQUENTIAL
+      madvise(map, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+#  endif
+
+      _map  = map;
+      _data = static_cast<const char *>(map);
+      _size = static_cast<size_t>(st.st_size);
+   }
+#endif
+
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * get the next WKT string
+ * returns: false at the end of the file
+ */
+bool ogc_wkt_reader :: next(
+   const char ** pstr,
+   size_t *      plen)
+{
+   return scan(&_pos, pstr, plen);
+}
+
+/*------------------------------------------------------------------------
+ * get the WKT string at a position, and move the position past it
+ * returns: false at the end of the file
+ *
+ * Where the next string starts depends only on the position, so
+ * scanning from the same position always gives the same strings.
+ */
+bool ogc_wkt_reader :: scan(
+   size_t *      ppos,
+   const char ** pstr,
+   size_t *      plen) const
+{
+   const char * end = _data + _size;
+   size_t       pos = *ppos;
+
+   while ( pos < _size )
+   {
+      const char * beg = _data + pos;
+      const char * e;
+
+      if ( _mode == OGC_READER_MODE_MULTI )
+      {
+         const unsigned char * stops = ogc_reader_get_stops();
+         const char * p;
+         const char * nl;
+         int          depth = 0;
+
+         /* skip whitespace (and blank lines) before the string */
+         while ( beg < end && isspace(static_cast<unsigned char>(*beg)) )
+            beg++;
+         if ( beg == end )
+         {
+            pos = _size;
+            break;
+         }
+
+         /* find the bracket that closes it (or the end of the file) */
+         e = end;
+         for (p = beg; p < end; p++)
+         {
+            while ( p < end && !stops[static_cast<unsigned char>(*p)] )
+               p++;
+            if ( p == end )
+               break;
+
+            if ( *p == '"' )
+            {
+               p = static_cast<const char *>(memchr(p + 1, '"', end - p - 1));
+               if ( p == OGC_NULL )
+                  break;
+            }
+            else if ( *p == '[' || *p == '(' )
+            {
+               depth++;
+            }
+            else if ( --depth <= 0 )
+            {
+               e = p + 1;
+               break;
+            }
+         }
+
+         /* skip the rest of its line */
+         nl = static_cast<const char *>(memchr(e, '\n', end - e));
+         pos = (nl == OGC_NULL) ? _size : (nl - _data) + 1;
+      }
+      else
+      {
+         const char * nl = static_cast<const char *>(
+            memchr(beg, '\n', end - beg));
+
+         e   = (nl == OGC_NULL) ? end : nl;
+         pos = (nl == OGC_NULL) ? _size : (nl - _data) + 1;
+      }
+
+      while ( beg < e && isspace(static_cast<unsigned char>(*beg)) )
+         beg++;
+      while ( e > beg && isspace(static_cast<unsigned char>(e[-1])) )
+         e--;
+
+      if ( beg < e )
+      {
+         *ppos = pos;
+         *pstr = beg;
+         *plen = static_cast<size_t>(e - beg);
+         return true;
+      }
+   }
+
+   *ppos = pos;
+   *pstr = OGC_NULL;
+   *plen = 0;
+   return false;
+}
+
+/*------------------------------------------------------------------------
+ * guess where the first string at or after a position starts
+ *
+ * This is the start of the next line, but in multi-line mode we look
+ * (up to the limit) for a line that is not indented, as the lines
+ * inside a string that is split over lines usually are.
+ */
+static size_t ogc_reader_guess(
+   const char * data,
+   size_t       size,
+   size_t       pos,
+   size_t       lim,
+   int          mode)
+{
+   size_t first;
+
+   if ( pos > 0 && data[pos-1] != '\n' )
+   {
+      const char * nl = static_cast<const char *>(
+         memchr(data + pos, '\n', size - pos));
+
+      if ( nl == OGC_NULL )
+         return size;
+      pos = (nl - data) + 1;
+   }
+
+   if ( mode != OGC_READER_MODE_MULTI )
+      return pos;
+
+   for (first = pos; pos < lim; )
+   {
+      const char * nl;
+
+      if ( !isspace(static_cast<unsigned char>(data[pos])) )
+         return pos;
+
+      nl = static_cast<const char *>(memchr(data + pos, '\n', size - pos));
+      if ( nl == OGC_NULL )
+         break;
+      pos = (nl - data) + 1;
+   }
+
+   return first;
+}
+
+/*------------------------------------------------------------------------
+ * parse a string found by parse_all()
+ */
+static void ogc_reader_parse_str(
+   ogc_batch_parser * parser,
+   bool               keep,
+   const char *       data,
+   const char *       str,
+   size_t             len,
+   size_t             end,
+   ogc_reader_str *   s)
+{
+   ogc_error e;
+
+   s->beg  = static_cast<size_t>(str - data);
+   s->len  = len;
+   s->end  = end;
+   s->obj  = parser->parse(str, len, &e);
+   s->err  = OGC_NULL;
+   s->made = (s->obj != OGC_NULL);
+
+   if ( !keep )
+      s->obj = ogc_object::destroy(s->obj);
+
+   if ( e.err_code() != OGC_ERR_NONE )
+   {
+      s->err = ogc_new<ogc_error>();
+      if ( s->err != OGC_NULL )
+         s->err->copy(e);
+   }
+}
+
+/*------------------------------------------------------------------------
+ * hand a string found by parse_all() to the caller
+ * returns: 1 if it has an object, 0 if not
+ */
+static size_t ogc_reader_send_str(
+   ogc_wkt_reader::OGC_READER_RTN * rtn,
+   void *                           data,
+   const char *                     base,
+   ogc_reader_str *                 s)
+{
+   size_t n = s->made ? 1 : 0;
+
+   if ( rtn != OGC_NULL )
+      (rtn)(data, base + s->beg, s->len, s->obj, s->err);
+
+   ogc_delete(s->err);
+
+   return n;
+}
+
+/*------------------------------------------------------------------------
+ * discard a string found by parse_all() in the wrong place
+ */
+static void ogc_reader_discard_str(
+   ogc_reader_str * s)
+{
+   ogc_object::destroy(s->obj);
+   ogc_delete(s->err);
+}
+
+/*------------------------------------------------------------------------
+ * parse the strings in one part of the file (run in its own thread)
+ */
+void ogc_wkt_reader :: parse_part(
+   void * data,
+   int    n)
+{
+   ogc_reader_part * p   = static_cast<ogc_reader_part *>(data) + n;
+   ogc_batch_parser  parser(p->strict);
+   size_t            pos = p->beg;
+
+   while ( pos < p->stop )
+   {
+      const char * str;
+      size_t       len;
+
+      if ( p->num == p->max )
+      {
+         size_t           max  = (p->max == 0) ? 256 : (p->max * 2);
+         ogc_reader_str * strs = static_cast<ogc_reader_str *>(
+            ogc_allocator::realloc(p->strs, max * sizeof(*strs)) );
+
+         /* if out of memory, the rest is done when fixing up */
+         if ( strs == OGC_NULL )
+            break;
+         p->strs = strs;
+         p->max  = max;
+      }
+
+      if ( !p->rdr->scan(&pos, &str, &len) )
+         break;
+
+      ogc_reader_parse_str(&parser, p->keep, p->rdr->_data, str, len, pos,
+                           p->strs + p->num++);
+   }
+
+   p->end = pos;
+}
+
+/*------------------------------------------------------------------------
+ * parse all the remaining WKT strings in threads
+ * returns: the number of objects created
+ *
+ * The file is done in rounds of about OGC_READER_PART_SIZE bytes per
+ * thread, so only the objects of one round are kept at a time.
+ *
+ * Where a string starts depends only on the position the scan is at, so
+ * once the real scan (from the previous part) reaches a position that a
+ * part's scan also reached, the strings found from there on are right.
+ * Strings a part found before that are discarded, and any strings
+ * between the real position and the part's positions are parsed here.
+ */
+size_t ogc_wkt_reader :: parse_all(
+   OGC_READER_RTN * rtn,
+   void *           data,
+   int              nthreads)
+{
+   bool              strict = ogc_object::get_strict_parsing();
+   bool              keep   = (rtn != OGC_NULL);
+   ogc_batch_parser  parser(strict);
+   ogc_reader_part * parts  = OGC_NULL;
+   ogc_reader_str    s;
+   const char *      str;
+   size_t            len;
+   size_t            pos    = _pos;
+   size_t            count  = 0;
+
+   if ( nthreads <= 0 )
+      nthreads = ogc_thread::cpu_count();
+   if ( nthreads > OGC_THREADS_MAX )
+      nthreads = OGC_THREADS_MAX;
+   if ( static_cast<size_t>(nthreads) > (_size - pos) / OGC_READER_PART_MIN )
+      nthreads = static_cast<int>((_size - pos) / OGC_READER_PART_MIN);
+
+   /* if there's not much (or no memory), it's all done in this thread */
+   if ( nthreads > 1 )
+   {
+      parts = ogc_alloc<ogc_reader_part>(nthreads);
+      if ( parts != OGC_NULL )
+      {
+         for (int k = 0; k < nthreads; k++)
+         {
+            parts[k].rdr    = this;
+            parts[k].strict = strict;
+            parts[k].keep   = keep;
+            parts[k].strs   = OGC_NULL;
+            parts[k].max    = 0;
+         }
+
+         /* make sure everything set on first use is set already */
+         ogc_reader_get_stops();
+         ogc_simd::name();
+      }
+   }
+
+   while ( parts != OGC_NULL && pos < _size )
+   {
+      size_t rest   = _size - pos;
+      int    nparts = nthreads;
+
+      if ( rest > static_cast<size_t>(nthreads) * OGC_READER_PART_SIZE )
+         rest = static_cast<size_t>(nthreads) * OGC_READER_PART_SIZE;
+      if ( static_cast<size_t>(nparts) > rest / OGC_READER_PART_MIN )
+         nparts = static_cast<int>(rest / OGC_READER_PART_MIN);
+      if ( nparts < 2 )
+         break;
+
+      /* the first part starts where we are, but the others are guesses */
+      for (int k = 0; k < nparts; k++)
+      {
+         ogc_reader_part * p = parts + k;
+
+         p->beg  = (k == 0) ? pos :
+                   ogc_reader_guess(_data, _size,
+                                    pos + (rest / nparts) * k,
+                                    pos + (rest / nparts) * (k+1), _mode);
+         if ( k > 0 && p->beg < p[-1].beg )
+            p->beg = p[-1].beg;
+         p->stop = pos + rest;
+         p->end  = p->beg;
+         p->num  = 0;
+
+         if ( k > 0 )
+            p[-1].stop = p->beg;
+      }
+
+      ogc_thread::run(nparts, parse_part, parts);
+
+      /* put the parts together in order, fixing up any wrong guesses */
+      for (int k = 0; k < nparts; k++)
+      {
+         ogc_reader_part * p = parts + k;
+         size_t            b = p->beg;
+         size_t            i = 0;
+
+         for (;;)
+         {
+            /* discard strings the part found before our position */
+            while ( b < pos && i < p->num )
+            {
+               b = p->strs[i].end;
+               ogc_reader_discard_str(p->strs + i++);
+            }
+            if ( b < pos && i == p->num )
+               b = p->end;
+
+            if ( b < pos )
+               break;                  /* the part is all behind us */
+
+            if ( b == pos )
+            {
+               /* in step with the part, so the rest of it is right */
+               for (; i < p->num; i++)
+                  count += ogc_reader_send_str(rtn, data, _data, p->strs + i);
+               pos = p->end;
+               break;
+            }
+
+            /* behind the part, so parse the next string here */
+            if ( !scan(&pos, &str, &len) )
+               continue;
+            ogc_reader_parse_str(&parser, keep, _data, str, len, pos, &s);
+            count += ogc_reader_send_str(rtn, data, _data, &s);
+         }
+      }
+   }
+
+   /* parse whatever is left (everything if no threads were used) */
+   while ( scan(&pos, &str, &len) )
+   {
+      ogc_reader_parse_str(&parser, keep, _data, str, len, pos, &s);
+      count += ogc_reader_send_str(rtn, data, _data, &s);
+   }
+   _pos = pos;
+
+   if ( parts != OGC_NULL )
+   {
+      for (int k = 0; k < nthreads; k++)
+      {
+         ogc_free(parts[k].strs);
+      }
+      ogc_free(parts);
+   }
+
+   return count;
+}
+
+} /* namespace OGC */
@@ -0,0 +1,483 @@
+/* ------------------------------------------------------------------------- */
+/* Copyright 2013 Esri                                                       */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/* WKT writer                                                                */
+/*                                                                           */
+/* All objects of a tree write straight into the one output buffer, so the   */
+/* output is written once, in order, and no object needs a buffer of its     */
+/* own for its sub-objects.                                                  */
+/*                                                                           */
+/* When writing to a file or a routine, the buffer is sent on and reused     */
+/* whenever it is full, so no more than the buffer is ever held, however     */
+/* big the object is.                                                        */
+/*                                                                           */
+/* Expanding to multiple lines is done as the output is written, giving      */
+/* just what ogc_utils::expand_wkt() gives for the same output: each item    */
+/* after a ',' goes on a new line (indented by the number of brackets open)  */
+/* if it has an open bracket before the next ',', or else after a space.     */
+/* As expand_wkt() doesn't skip quoted strings, neither is done here.        */
+/* ------------------------------------------------------------------------- */
+
+#include "ogc_common.h"
+
+namespace OGC {
+
+#define OGC_WRITER_SIZE  1024   /* first size of a buffer of our own */
+
+static const char ogc_writer_spaces[] = "                ";
+static const char ogc_writer_tabs[]   = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+
+/*------------------------------------------------------------------------
+ * internal set the defaults
+ */
+void ogc_wkt_writer :: init()
+{
+   _buf  = OGC_NULL;
+   _len  = 0;
+   _size = 0;
+   _base = 0;
+   _min  = OGC_WRITER_SIZE;
+   _rtn  = OGC_NULL;
+   _data = OGC_NULL;
+   _own    = true;
+   _ok     = true;
+   _sep    = false;
+   _expand = false;
+   _indent = ' ';
+   _opn    = '[';
+   _cls    = ']';
+   _tab    = 0;
+   _level  = 0;
+}
+
+/*------------------------------------------------------------------------
+ * WKT_WRITER constructor (to a buffer of our own)
+ */
+ogc_wkt_writer :: ogc_wkt_writer()
+{
+   init();
+}
+
+/*------------------------------------------------------------------------
+ * WKT_WRITER constructor (to a caller's buffer)
+ */
+ogc_wkt_writer :: ogc_wkt_writer(
+   char   buffer[],
+   size_t buflen)
+{
+   init();
+
+   _buf  = buffer;
+   _size = buflen;
+   _own  = false;
+   _ok   = (buffer != OGC_NULL && buflen > 0);
+
+   if ( _ok )
+      *_buf = 0;
+}
+
+/*------------------------------------------------------------------------
+ * WKT_WRITER constructor (to a file)
+ */
+ogc_wkt_writer :: ogc_wkt_writer(
+   FILE * fp,
+   size_t bufsize)
+{
+   init();
+
+   _rtn  = file_rtn;
+   _data = fp;
+   _min  = (bufsize > 0) ? bufsize : OGC_WRITER_SIZE;
+   _ok   = (fp != OGC_NULL);
+}
+
+/*------------------------------------------------------------------------
+ * WKT_WRITER constructor (to a call-back routine)
+ */
+ogc_wkt_writer :: ogc_wkt_writer(
+   OGC_WRITER_RTN * rtn,
+   void *           data,
+   size_t           bufsize)
+{
+   init();
+
+   _rtn  = rtn;
+   _data = data;
+   _min  = (bufsize > 0) ? bufsize : OGC_WRITER_SIZE;
+   _ok   = (rtn != OGC_NULL);
+}
+
+/*------------------------------------------------------------------------
+ * WKT_WRITER destructor
+ */
+ogc_wkt_writer :: ~ogc_wkt_writer()
+{
+   flush();
+
+   if ( _own )
+   {
+      ogc_free(_buf);
+   }
+}
+
+/*------------------------------------------------------------------------
+ * internal routine to write to a file
+ */
+bool ogc_wkt_writer :: file_rtn(
+   void *       data,
+   const char * str,
+   size_t       len)
+{
+   FILE * fp = static_cast<FILE *>(data);
+
+   return (fwrite(str, 1, len, fp) == len);
+}
+
+/*------------------------------------------------------------------------
+ * discard the output not yet sent on
+ */
+void ogc_wkt_writer :: reset()
+{
+   _len    = 0;
+   _ok     = (_own || (_buf != OGC_NULL && _size > 0));
+   _sep    = false;
+   _expand = false;
+   _tab    = 0;
+   _level  = 0;
+
+   if ( _buf != OGC_NULL )
+      *_buf = 0;
+}
+
+/*------------------------------------------------------------------------
+ * internal send the output in the buffer on
+ */
+bool ogc_wkt_writer :: send()
+{
+   if ( _len == 0 )
+      return _ok;
+
+   if ( _ok )
+      _ok = _rtn(_data, _buf, _len);
+
+   _base += _len;
+   _len   = 0;
+   *_buf  = 0;
+
+   return _ok;
+}
+
+/*------------------------------------------------------------------------
+ * send the output in the buffer on (if writing to a file or routine)
+ */
+bool ogc_wkt_writer :: flush()
+{
+   if ( _rtn == OGC_NULL )
+      return _ok;
+
+   return send();
+}
+
+/*------------------------------------------------------------------------
+ * internal make room for n more chars (and the null)
+ *
+ * When writing to a file or routine, the buffer is sent on if it is
+ * full, and only grows if it is still too small.
+ */
+bool ogc_wkt_writer :: grow(size_t n)
+{
+   size_t size;
+   char * buf;
+
+   if ( !_ok )
+      return false;
+
+   if ( _len + n < _size )
+      return true;
+
+   if ( !_own )
+   {
+      _ok = false;
+      return false;
+   }
+
+   if ( _rtn != OGC_NULL )
+   {
+      if ( !send() )
+         return false;
+      if ( _len + n < _size )
+         return true;
+   }
+
+   size = (_size == 0) ? _min : (_size * 2);
+   if ( size <= _len + n )
+      size = _len + n + 1;
+
+   buf = static_cast<char *>( ogc_allocator::realloc(_buf, size) );
+   if ( buf == OGC_NULL )
+   {
+      _ok = false;
+      return false;
+   }
+
+   if ( _buf == OGC_NULL )
+      *buf = 0;
+
+   _buf  = buf;
+   _size = size;
+   return true;
+}
+
+/*------------------------------------------------------------------------
+ * write text as is
+ */
+void ogc_wkt_writer :: write(
+   const char * str,
+   size_t       len)
+{
+   if ( len == 0 || !grow(len) )
+      return;
+
+   memcpy(_buf + _len, str, len);
+   _len += len;
+   _buf[_len] = 0;
+}
+
+/*------------------------------------------------------------------------
+ * internal check if an item has an open bracket before the next ','
+ */
+bool ogc_wkt_writer :: has_opn(const char * str) const
+{
+   if ( str != OGC_NULL )
+   {
+      for (; *str != 0 && *str != ','; str++)
+      {
+         if ( *str == _opn )
+            return true;
+      }
+   }
+
+   return false;
+}
+
+/*------------------------------------------------------------------------
+ * internal start the next line after a ',' (if expanding)
+ *
+ * An item with an open bracket goes on a new line (unless nothing is
+ * open), and any other item just goes after a space.
+ */
+void ogc_wkt_writer :: line(bool cr)
+{
+   if ( !cr )
+   {
+      write(" ", 1);
+   }
+   else
+   if ( _tab > 0 )
+   {
+      const char * ind = (_indent == ' ') ? ogc_writer_spaces :
+                                            ogc_writer_tabs;
+      size_t       max = sizeof(ogc_writer_spaces) - 1;
+      size_t       n   = static_cast<size_t>(_tab);
+
+      write("\n", 1);
+      for (; n > max; n -= max)
+         write(ind, max);
+      write(ind, n);
+   }
+}
+
+/*------------------------------------------------------------------------
+ * internal start an item (with a ',' if it follows another)
+ */
+void ogc_wkt_writer :: item(bool cr)
+{
+   if ( _sep )
+   {
+      write(",", 1);
+      if ( _expand )
+         line(cr);
+   }
+   _sep = true;
+}
+
+/*------------------------------------------------------------------------
+ * internal write the text of an item (with any quotes doubled if quoted)
+ *
+ * If expanding, any ',' or brackets in it are dealt with as if they
+ * were outside of the item.
+ */
+void ogc_wkt_writer :: text(
+   const char * str,
+   bool         quoted)
+{
+   const char * s = str;
+
+   if ( s == OGC_NULL )
+      return;
+
+   if ( !_expand )
+   {
+      if ( quoted )
+      {
+         const char * q;
+
+         for (; (q = strchr(s, '"')) != OGC_NULL; s = q + 1)
+         {
+            write(s, static_cast<size_t>(q - s) + 1);
+            write("\"", 1);
+         }
+      }
+
+      write(s, strlen(s));
+      return;
+   }
+
+   for (;;)
+   {
+      const char * p = s;
+
+      while ( *p != 0   && *p != ','  && *p != _opn && *p != _cls &&
+              (*p != '"' || !quoted) )
+      {
+         p++;
+      }
+
+      write(s, static_cast<size_t>(p - s));
+      if ( *p == 0 )
+         break;
+      write(p, 1);
+
+      if ( *p == '"' )
+         write("\"", 1);
+      else
+      if ( *p == _opn )
+         _tab++;
+      else
+      if ( *p == _cls )
+         _tab--;
+      else
+         line(has_opn(p + 1));
+
+      s = p + 1;
+   }
+}
+
+/*------------------------------------------------------------------------
+ * end an object
+ */
+void ogc_wkt_writer :: end(const char * str)
+{
+   if ( str != OGC_NULL )
+      write(str, strlen(str));
+   _sep = false;
+}
+
+/*------------------------------------------------------------------------
+ * write a keyword and its open bracket
+ *
+ * A top-level object with OGC_WKT_OPT_EXPAND is expanded until it is
+ * closed.
+ */
+void ogc_wkt_writer :: open(
+   const char * kwd,
+   int          options)
+{
+   bool parens = ((options & OGC_WKT_OPT_PARENS) != 0);
+
+   if ( _level == 0 &&
+        (options & OGC_WKT_OPT_INTERNAL) == 0 &&
+        (options & OGC_WKT_OPT_EXPAND)   != 0 )
+   {
+      _expand = true;
+      _indent = ((options & OGC_WKT_OPT_EXPAND_SP) != 0) ? ' ' : '\t';
+      _opn    = parens ? '(' : '[';
+      _cls    = parens ? ')' : ']';
+      _tab    = 0;
+   }
+
+   item(true);
+   write(kwd, strlen(kwd));
+   write(parens ? "(" : "[", 1);
+   _sep = false;
+
+   _level++;
+   if ( _expand )
+      _tab++;
+}
+
+/*------------------------------------------------------------------------
+ * write a close bracket
+ */
+void ogc_wkt_writer :: close(int options)
+{
+   write(((options & OGC_WKT_OPT_PARENS) != 0) ? ")" : "]", 1);
+   _sep = true;
+
+   if ( _level > 0 )
+      _level--;
+
+   if ( _expand )
+   {
+      _tab--;
+      if ( _level == 0 )
+         _expand = false;
+   }
+}
+
+/*------------------------------------------------------------------------
+ * write a string as is
+ */
+void ogc_wkt_writer :: put(const char * str)
+{
+   item(_expand && has_opn(str));
+   text(str, false);
+}
+
+/*------------------------------------------------------------------------
+ * write a quoted string (with any quotes in it doubled)
+ */
+void ogc_wkt_writer :: put_str(const char * str)
+{
+   item(_expand && has_opn(str));
+   write("\"", 1);
+   text(str, true);
+   write("\"", 1);
+}
+
+/*------------------------------------------------------------------------
+ * write a number
+ */
+void ogc_wkt_writer :: put_num(double d)
+{
+   OGC_NBUF buf;
+
+   item(false);
+   ogc_string::dtoa(d, buf);
+   write(buf, strlen(buf));
+}
+
+void ogc_wkt_writer :: put_int(int n)
+{
+   OGC_NBUF buf;
+
+   item(false);
+   ogc_string::itoa(n, buf);
+   write(buf, strlen(buf));
+}
+
+} /* namespace OGC */